@@ -40,6 +40,8 @@ public class ObjectExporter : ModuleRules
 				"SlateCore",
                 "Json",
                 "JsonUtilities",
+                "RHI",
+                "TargetPlatform",
 				// ... add private dependencies that you statically link with here ...	
 			}
             );
@@ -1,20 +1,21 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ObjectExporter.h"
+#include "ObjectExporterLiveExport.h"
 
 #define LOCTEXT_NAMESPACE "FObjectExporterModule"
 
 void FObjectExporterModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
-	
+	LiveExport = MakeUnique<FObjectExporterLiveExport>();
 }
 
 void FObjectExporterModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
-	
+	LiveExport.Reset();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,530 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterAnimCompression.h"
+#include "HAL/IConsoleManager.h"
+#include "Animation/Skeleton.h"
+
+static TAutoConsoleVariable<int32> CVarObjectExporterCompressAnimations(
+    TEXT("ObjectExporter.CompressAnimations"),
+    0,
+    TEXT("0: write every raw animation key as full floats (default).\n")
+    TEXT("1: drop constant tracks, reduce keys within the ObjectExporter.Anim*Tolerance values and quantize them."));
+
+static TAutoConsoleVariable<int32> CVarObjectExporterAnimFrameMajorLayout(
+    TEXT("ObjectExporter.AnimFrameMajorLayout"),
+    0,
+    TEXT("0: write animation keys track by track (default).\n")
+    TEXT("1: write the keys of all animated channels of a frame contiguously, in SIMD lanes. Takes precedence over ObjectExporter.CompressAnimations."));
+
+static TAutoConsoleVariable<float> CVarObjectExporterAnimPositionTolerance(
+    TEXT("ObjectExporter.AnimPositionTolerance"),
+    0.01f,
+    TEXT("Largest translation error allowed by animation compression, in world units."));
+
+static TAutoConsoleVariable<float> CVarObjectExporterAnimRotationTolerance(
+    TEXT("ObjectExporter.AnimRotationTolerance"),
+    0.0005f,
+    TEXT("Largest rotation error allowed by animation compression, in radians."));
+
+static TAutoConsoleVariable<float> CVarObjectExporterAnimScaleTolerance(
+    TEXT("ObjectExporter.AnimScaleTolerance"),
+    0.0001f,
+    TEXT("Largest scale error allowed by animation compression."));
+
+FObjectExporterAnimCompressionSettings FObjectExporterAnimCompressionSettings::Get()
+{
+    FObjectExporterAnimCompressionSettings Settings;
+    Settings.bCompress = CVarObjectExporterCompressAnimations.GetValueOnGameThread() != 0;
+    Settings.bFrameMajor = CVarObjectExporterAnimFrameMajorLayout.GetValueOnGameThread() != 0;
+    Settings.PositionTolerance = FMath::Max(CVarObjectExporterAnimPositionTolerance.GetValueOnGameThread(), 0.0f);
+    Settings.RotationTolerance = FMath::Max(CVarObjectExporterAnimRotationTolerance.GetValueOnGameThread(), 0.0f);
+    Settings.ScaleTolerance = FMath::Max(CVarObjectExporterAnimScaleTolerance.GetValueOnGameThread(), 0.0f);
+
+    return Settings;
+}
+
+void ObjectExporterAnimCompression::BuildBoneTracks(const USkeleton* Skeleton, const TArray<int32>& TrackBoneIndices, TArray<FObjectExporterAnimBoneTrack>& OutBoneTracks)
+{
+    if (Skeleton == nullptr)
+    {
+        return;
+    }
+
+    const TArray<FTransform>& BindPose = Skeleton->GetReferenceSkeleton().GetRefBonePose();
+
+    OutBoneTracks.AddZeroed(BindPose.Num());
+    for (int32 BoneIndex = 0; BoneIndex < BindPose.Num(); BoneIndex++)
+    {
+        FObjectExporterAnimBoneTrack& BoneTrack = OutBoneTracks[BoneIndex];
+        BoneTrack.TrackIndex = INDEX_NONE;
+        ObjectExporterFile::CopyQuat(BoneTrack.Rotation, BindPose[BoneIndex].GetRotation());
+        ObjectExporterFile::CopyVector(BoneTrack.Translation, BindPose[BoneIndex].GetTranslation());
+        ObjectExporterFile::CopyVector(BoneTrack.Scale, BindPose[BoneIndex].GetScale3D());
+        BoneTrack.RetargetMode = (uint32)Skeleton->GetBoneTranslationRetargetingMode(BoneIndex);
+    }
+
+    for (int32 TrackIndex = 0; TrackIndex < TrackBoneIndices.Num(); TrackIndex++)
+    {
+        if (OutBoneTracks.IsValidIndex(TrackBoneIndices[TrackIndex]))
+        {
+            OutBoneTracks[TrackBoneIndices[TrackIndex]].TrackIndex = TrackIndex;
+        }
+    }
+}
+
+#define SMALLEST_THREE_MAX (0.70710678f)
+#define SMALLEST_THREE_STEPS (32767.0f)
+#define RANGE_STEPS (65535.0f)
+
+void ObjectExporterAnimCompression::EncodeRotation(const FQuat& Rotation, uint16* OutKey)
+{
+    const float Components[4] = { Rotation.X, Rotation.Y, Rotation.Z, Rotation.W };
+
+    uint32 Largest = 0;
+    for (uint32 iComponent = 1; iComponent < 4; iComponent++)
+    {
+        Largest = FMath::Abs(Components[iComponent]) > FMath::Abs(Components[Largest]) ? iComponent : Largest;
+    }
+
+    // q and -q are the same rotation, the dropped component is always positive
+    const float Sign = Components[Largest] < 0.0f ? -1.0f : 1.0f;
+
+    uint32 iKey = 0;
+    for (uint32 iComponent = 0; iComponent < 4; iComponent++)
+    {
+        if (iComponent != Largest)
+        {
+            const float Normalized = FMath::Clamp(Components[iComponent] * Sign / SMALLEST_THREE_MAX * 0.5f + 0.5f, 0.0f, 1.0f);
+            OutKey[iKey++] = (uint16)FMath::RoundToInt(Normalized * SMALLEST_THREE_STEPS);
+        }
+    }
+
+    OutKey[0] |= (uint16)((Largest >> 1) << 15);
+    OutKey[1] |= (uint16)((Largest & 1) << 15);
+}
+
+FQuat ObjectExporterAnimCompression::DecodeRotation(const uint16* Key)
+{
+    const uint32 Largest = ((Key[0] >> 15) << 1) | (Key[1] >> 15);
+
+    float Components[4];
+    float SumSquared = 0.0f;
+    uint32 iKey = 0;
+    for (uint32 iComponent = 0; iComponent < 4; iComponent++)
+    {
+        if (iComponent != Largest)
+        {
+            const float Normalized = (Key[iKey++] & 0x7fff) / SMALLEST_THREE_STEPS;
+            Components[iComponent] = (Normalized * 2.0f - 1.0f) * SMALLEST_THREE_MAX;
+            SumSquared += Components[iComponent] * Components[iComponent];
+        }
+    }
+
+    Components[Largest] = FMath::Sqrt(FMath::Max(1.0f - SumSquared, 0.0f));
+
+    return FQuat(Components[0], Components[1], Components[2], Components[3]);
+}
+
+void ObjectExporterAnimCompression::EncodeRange(const FVector& Value, const float* Params, uint16* OutKey)
+{
+    for (int32 iComponent = 0; iComponent < 3; iComponent++)
+    {
+        const float Extent = Params[3 + iComponent];
+        const float Normalized = Extent > 0.0f ? FMath::Clamp((Value[iComponent] - Params[iComponent]) / Extent, 0.0f, 1.0f) : 0.0f;
+        OutKey[iComponent] = (uint16)FMath::RoundToInt(Normalized * RANGE_STEPS);
+    }
+}
+
+FVector ObjectExporterAnimCompression::DecodeRange(const uint16* Key, const float* Params)
+{
+    return FVector(
+        Params[0] + Key[0] / RANGE_STEPS * Params[3],
+        Params[1] + Key[1] / RANGE_STEPS * Params[4],
+        Params[2] + Key[2] / RANGE_STEPS * Params[5]);
+}
+
+/** Angle between two rotations, in radians. From the chord length, acos is too coarse near 1 at these tolerances. */
+static float GetRotationError(const FQuat& A, const FQuat& B)
+{
+    const FQuat NormalizedA = A.GetNormalized();
+    const FQuat NormalizedB = B.GetNormalized();
+    const FQuat Difference = NormalizedA - NormalizedB * ((NormalizedA | NormalizedB) < 0.0f ? -1.0f : 1.0f);
+
+    return 4.0f * FMath::Asin(FMath::Min(FMath::Sqrt(Difference | Difference) * 0.5f, 1.0f));
+}
+
+/** Normalized linear interpolation along the shortest path, as the runtime samples rotations. */
+static FQuat InterpolateRotation(const FQuat& A, const FQuat& B, float Alpha)
+{
+    const float Sign = (A | B) < 0.0f ? -1.0f : 1.0f;
+    FQuat Result = A * (1.0f - Alpha) + B * (Alpha * Sign);
+    Result.Normalize();
+
+    return Result;
+}
+
+/** Value type specific parts of the channel compression. */
+struct FRangeChannelTraits
+{
+    typedef FVector ValueType;
+
+    static float GetError(const FVector& A, const FVector& B, bool bPerComponent)
+    {
+        return bPerComponent ? (A - B).GetAbsMax() : FVector::Dist(A, B);
+    }
+
+    static FVector Interpolate(const FVector& A, const FVector& B, float Alpha)
+    {
+        return FMath::Lerp(A, B, Alpha);
+    }
+};
+
+struct FRotationChannelTraits
+{
+    typedef FQuat ValueType;
+
+    static float GetError(const FQuat& A, const FQuat& B, bool)
+    {
+        return GetRotationError(A, B);
+    }
+
+    static FQuat Interpolate(const FQuat& A, const FQuat& B, float Alpha)
+    {
+        return InterpolateRotation(A, B, Alpha);
+    }
+};
+
+/**
+*   Greedy key reduction: from each kept key, extends the segment as long as interpolating the decoded end keys reproduces
+*   every raw key in between within Tolerance. Returns the kept frames and the largest error over all frames.
+*/
+template<typename TraitsType>
+static float ReduceKeys(const TArray<typename TraitsType::ValueType>& RawKeys, const TArray<typename TraitsType::ValueType>& DecodedKeys,
+    float Tolerance, bool bPerComponent, TArray<int32>& OutFrames)
+{
+    const int32 NumKeys = RawKeys.Num();
+
+    auto GetSegmentError = [&](int32 Start, int32 End)
+    {
+        float Error = 0.0f;
+        for (int32 Frame = Start + 1; Frame < End; Frame++)
+        {
+            const float Alpha = (float)(Frame - Start) / (End - Start);
+            const typename TraitsType::ValueType Value = TraitsType::Interpolate(DecodedKeys[Start], DecodedKeys[End], Alpha);
+            Error = FMath::Max(Error, TraitsType::GetError(Value, RawKeys[Frame], bPerComponent));
+        }
+
+        return Error;
+    };
+
+    float MaxError = 0.0f;
+    for (int32 Frame = 0; Frame < NumKeys; Frame++)
+    {
+        MaxError = FMath::Max(MaxError, TraitsType::GetError(DecodedKeys[Frame], RawKeys[Frame], bPerComponent));
+    }
+
+    OutFrames.Reset();
+    OutFrames.Add(0);
+
+    int32 Start = 0;
+    while (Start < NumKeys - 1)
+    {
+        int32 End = Start + 1;
+        while (End + 1 < NumKeys && GetSegmentError(Start, End + 1) <= Tolerance)
+        {
+            End++;
+        }
+
+        MaxError = FMath::Max(MaxError, GetSegmentError(Start, End));
+        OutFrames.Add(End);
+        Start = End;
+    }
+
+    return MaxError;
+}
+
+/** Compresses one translation or scale channel. Returns the largest decoded error. */
+static float CompressRangeChannel(const TArray<FVector>& RawKeys, const FVector& IdentityValue, float Tolerance, bool bPerComponent,
+    FObjectExporterAnimChannel& OutChannel, TArray<uint16>& OutKeys, TArray<uint16>& OutFrames)
+{
+    FMemory::Memzero(OutChannel);
+    OutChannel.Format = EObjectExporterAnimChannelFormat::Identity;
+
+    if (RawKeys.Num() == 0)
+    {
+        return 0.0f;
+    }
+
+    FBox Range(ForceInit);
+    for (const FVector& Key : RawKeys)
+    {
+        Range += Key;
+    }
+
+    float ConstantError = 0.0f;
+    float IdentityError = 0.0f;
+    for (const FVector& Key : RawKeys)
+    {
+        ConstantError = FMath::Max(ConstantError, FRangeChannelTraits::GetError(Key, RawKeys[0], bPerComponent));
+        IdentityError = FMath::Max(IdentityError, FRangeChannelTraits::GetError(Key, IdentityValue, bPerComponent));
+    }
+
+    if (IdentityError <= Tolerance)
+    {
+        return IdentityError;
+    }
+
+    if (ConstantError <= Tolerance)
+    {
+        OutChannel.Format = EObjectExporterAnimChannelFormat::Constant;
+        ObjectExporterFile::CopyVector(OutChannel.Params, RawKeys[0]);
+
+        return ConstantError;
+    }
+
+    ObjectExporterFile::CopyVector(OutChannel.Params, Range.Min);
+    ObjectExporterFile::CopyVector(OutChannel.Params + 3, Range.Max - Range.Min);
+
+    TArray<uint16> QuantizedKeys;
+    TArray<FVector> DecodedKeys;
+    QuantizedKeys.AddUninitialized(RawKeys.Num() * 3);
+    DecodedKeys.AddUninitialized(RawKeys.Num());
+    for (int32 Frame = 0; Frame < RawKeys.Num(); Frame++)
+    {
+        ObjectExporterAnimCompression::EncodeRange(RawKeys[Frame], OutChannel.Params, &QuantizedKeys[Frame * 3]);
+        DecodedKeys[Frame] = ObjectExporterAnimCompression::DecodeRange(&QuantizedKeys[Frame * 3], OutChannel.Params);
+    }
+
+    TArray<int32> KeptFrames;
+    const float Error = ReduceKeys<FRangeChannelTraits>(RawKeys, DecodedKeys, Tolerance, bPerComponent, KeptFrames);
+
+    OutChannel.Format = EObjectExporterAnimChannelFormat::Animated;
+    OutChannel.NumKeys = KeptFrames.Num();
+    OutChannel.FirstKey = OutKeys.Num() / 3;
+    OutChannel.FirstFrame = OutFrames.Num();
+    for (int32 Frame : KeptFrames)
+    {
+        OutKeys.Append(&QuantizedKeys[Frame * 3], 3);
+        OutFrames.Add((uint16)Frame);
+    }
+
+    return Error;
+}
+
+/** Compresses one rotation channel. Returns the largest decoded error. */
+static float CompressRotationChannel(const TArray<FQuat>& RawKeys, float Tolerance, FObjectExporterAnimChannel& OutChannel, TArray<uint16>& OutKeys,
+    TArray<uint16>& OutFrames)
+{
+    FMemory::Memzero(OutChannel);
+    OutChannel.Format = EObjectExporterAnimChannelFormat::Identity;
+
+    if (RawKeys.Num() == 0)
+    {
+        return 0.0f;
+    }
+
+    float ConstantError = 0.0f;
+    float IdentityError = 0.0f;
+    for (const FQuat& Key : RawKeys)
+    {
+        ConstantError = FMath::Max(ConstantError, GetRotationError(Key, RawKeys[0]));
+        IdentityError = FMath::Max(IdentityError, GetRotationError(Key, FQuat::Identity));
+    }
+
+    if (IdentityError <= Tolerance)
+    {
+        return IdentityError;
+    }
+
+    if (ConstantError <= Tolerance)
+    {
+        OutChannel.Format = EObjectExporterAnimChannelFormat::Constant;
+        ObjectExporterFile::CopyQuat(OutChannel.Params, RawKeys[0].GetNormalized());
+
+        return ConstantError;
+    }
+
+    TArray<uint16> QuantizedKeys;
+    TArray<FQuat> DecodedKeys;
+    QuantizedKeys.AddUninitialized(RawKeys.Num() * 3);
+    DecodedKeys.AddUninitialized(RawKeys.Num());
+    for (int32 Frame = 0; Frame < RawKeys.Num(); Frame++)
+    {
+        ObjectExporterAnimCompression::EncodeRotation(RawKeys[Frame].GetNormalized(), &QuantizedKeys[Frame * 3]);
+        DecodedKeys[Frame] = ObjectExporterAnimCompression::DecodeRotation(&QuantizedKeys[Frame * 3]);
+    }
+
+    TArray<int32> KeptFrames;
+    const float Error = ReduceKeys<FRotationChannelTraits>(RawKeys, DecodedKeys, Tolerance, false, KeptFrames);
+
+    OutChannel.Format = EObjectExporterAnimChannelFormat::Animated;
+    OutChannel.NumKeys = KeptFrames.Num();
+    OutChannel.FirstKey = OutKeys.Num() / 3;
+    OutChannel.FirstFrame = OutFrames.Num();
+    for (int32 Frame : KeptFrames)
+    {
+        OutKeys.Append(&QuantizedKeys[Frame * 3], 3);
+        OutFrames.Add((uint16)Frame);
+    }
+
+    return Error;
+}
+
+bool ObjectExporterAnimCompression::CompressTracks(const TArray<FRawAnimSequenceTrack>& Tracks, const TArray<int32>& TrackBoneIndices, int32 NumFrames,
+    const FObjectExporterAnimCompressionSettings& Settings, FObjectExporterCompressedAnimData& OutData)
+{
+    if (NumFrames > MAX_uint16 + 1)
+    {
+        return false;
+    }
+
+    OutData.Tracks.AddZeroed(Tracks.Num());
+
+    for (int32 TrackIndex = 0; TrackIndex < Tracks.Num(); TrackIndex++)
+    {
+        const FRawAnimSequenceTrack& RawTrack = Tracks[TrackIndex];
+
+        FObjectExporterCompressedAnimTrack& Track = OutData.Tracks[TrackIndex];
+        Track.BoneIndex = TrackBoneIndices[TrackIndex];
+
+        const float PositionError = CompressRangeChannel(RawTrack.PosKeys, FVector::ZeroVector, Settings.PositionTolerance, false,
+            Track.Position, OutData.PositionKeys, OutData.KeyFrames);
+        const float RotationError = CompressRotationChannel(RawTrack.RotKeys, Settings.RotationTolerance, Track.Rotation, OutData.RotationKeys, OutData.KeyFrames);
+        const float ScaleError = CompressRangeChannel(RawTrack.ScaleKeys, FVector::OneVector, Settings.ScaleTolerance, true,
+            Track.Scale, OutData.ScaleKeys, OutData.KeyFrames);
+
+        OutData.MaxPositionError = FMath::Max(OutData.MaxPositionError, PositionError);
+        OutData.MaxRotationError = FMath::Max(OutData.MaxRotationError, RotationError);
+        OutData.MaxScaleError = FMath::Max(OutData.MaxScaleError, ScaleError);
+    }
+
+    return true;
+}
+
+/** Key of a raw channel at Frame, raw channels hold either one key or one per frame. */
+template<typename ValueType>
+static const ValueType& GetRawKey(const TArray<ValueType>& Keys, int32 Frame)
+{
+    return Keys[FMath::Min(Frame, Keys.Num() - 1)];
+}
+
+template<typename TraitsType>
+static bool IsConstantChannel(const TArray<typename TraitsType::ValueType>& Keys, float Tolerance, bool bPerComponent)
+{
+    for (const typename TraitsType::ValueType& Key : Keys)
+    {
+        if (TraitsType::GetError(Key, Keys[0], bPerComponent) > Tolerance)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ObjectExporterAnimCompression::BuildFrameMajorTracks(const TArray<FRawAnimSequenceTrack>& Tracks, const TArray<int32>& TrackBoneIndices, int32 NumFrames,
+    const FObjectExporterAnimCompressionSettings& Settings, FObjectExporterFrameMajorAnimData& OutData)
+{
+    uint32 NumRotations = 0;
+    uint32 NumTranslations = 0;
+    uint32 NumScales = 0;
+
+    OutData.Tracks.AddZeroed(Tracks.Num());
+    for (int32 TrackIndex = 0; TrackIndex < Tracks.Num(); TrackIndex++)
+    {
+        const FRawAnimSequenceTrack& RawTrack = Tracks[TrackIndex];
+
+        FObjectExporterAnimFrameTrack& Track = OutData.Tracks[TrackIndex];
+        Track.BoneIndex = TrackBoneIndices[TrackIndex];
+        Track.RotationLane = Track.TranslationLane = Track.ScaleLane = INDEX_NONE;
+
+        ObjectExporterFile::CopyQuat(Track.Rotation, RawTrack.RotKeys.Num() > 0 ? RawTrack.RotKeys[0].GetNormalized() : FQuat::Identity);
+        ObjectExporterFile::CopyVector(Track.Translation, RawTrack.PosKeys.Num() > 0 ? RawTrack.PosKeys[0] : FVector::ZeroVector);
+        ObjectExporterFile::CopyVector(Track.Scale, RawTrack.ScaleKeys.Num() > 0 ? RawTrack.ScaleKeys[0] : FVector::OneVector);
+
+        if (RawTrack.RotKeys.Num() > 0 && !IsConstantChannel<FRotationChannelTraits>(RawTrack.RotKeys, Settings.RotationTolerance, false))
+        {
+            Track.RotationLane = NumRotations++;
+        }
+        if (RawTrack.PosKeys.Num() > 0 && !IsConstantChannel<FRangeChannelTraits>(RawTrack.PosKeys, Settings.PositionTolerance, false))
+        {
+            Track.TranslationLane = NumTranslations++;
+        }
+        if (RawTrack.ScaleKeys.Num() > 0 && !IsConstantChannel<FRangeChannelTraits>(RawTrack.ScaleKeys, Settings.ScaleTolerance, true))
+        {
+            Track.ScaleLane = NumScales++;
+        }
+    }
+
+    FObjectExporterAnimFrameLayout& Layout = OutData.Layout;
+    Layout.NumRotationLanes = Align(NumRotations, FrameLaneWidth);
+    Layout.NumTranslationLanes = Align(NumTranslations, FrameLaneWidth);
+    Layout.NumScaleLanes = Align(NumScales, FrameLaneWidth);
+    Layout.FrameStride = Layout.NumRotationLanes * 4 + Layout.NumTranslationLanes * 3 + Layout.NumScaleLanes * 3;
+
+    const uint32 TranslationOffset = Layout.NumRotationLanes * 4;
+    const uint32 ScaleOffset = TranslationOffset + Layout.NumTranslationLanes * 3;
+
+    // Unused lanes blend identity values, they stay finite through nlerp
+    OutData.Keys.SetNumZeroed(Layout.FrameStride * NumFrames);
+    for (int32 Frame = 0; Frame < NumFrames; Frame++)
+    {
+        float* Block = OutData.Keys.GetData() + Frame * Layout.FrameStride;
+        for (uint32 Lane = NumRotations; Lane < Layout.NumRotationLanes; Lane++)
+        {
+            Block[Layout.NumRotationLanes * 3 + Lane] = 1.0f;
+        }
+        for (uint32 Lane = NumScales; Lane < Layout.NumScaleLanes; Lane++)
+        {
+            for (uint32 iComponent = 0; iComponent < 3; iComponent++)
+            {
+                Block[ScaleOffset + Layout.NumScaleLanes * iComponent + Lane] = 1.0f;
+            }
+        }
+    }
+
+    for (int32 TrackIndex = 0; TrackIndex < Tracks.Num(); TrackIndex++)
+    {
+        const FRawAnimSequenceTrack& RawTrack = Tracks[TrackIndex];
+        const FObjectExporterAnimFrameTrack& Track = OutData.Tracks[TrackIndex];
+
+        FQuat PreviousRotation = FQuat::Identity;
+        for (int32 Frame = 0; Frame < NumFrames; Frame++)
+        {
+            float* Block = OutData.Keys.GetData() + Frame * Layout.FrameStride;
+
+            if (Track.RotationLane != INDEX_NONE)
+            {
+                FQuat Rotation = GetRawKey(RawTrack.RotKeys, Frame).GetNormalized();
+                if (Frame > 0 && (Rotation | PreviousRotation) < 0.0f)
+                {
+                    Rotation = Rotation * -1.0f;
+                }
+                PreviousRotation = Rotation;
+
+                Block[Layout.NumRotationLanes * 0 + Track.RotationLane] = Rotation.X;
+                Block[Layout.NumRotationLanes * 1 + Track.RotationLane] = Rotation.Y;
+                Block[Layout.NumRotationLanes * 2 + Track.RotationLane] = Rotation.Z;
+                Block[Layout.NumRotationLanes * 3 + Track.RotationLane] = Rotation.W;
+            }
+
+            if (Track.TranslationLane != INDEX_NONE)
+            {
+                const FVector& Translation = GetRawKey(RawTrack.PosKeys, Frame);
+                for (uint32 iComponent = 0; iComponent < 3; iComponent++)
+                {
+                    Block[TranslationOffset + Layout.NumTranslationLanes * iComponent + Track.TranslationLane] = Translation[iComponent];
+                }
+            }
+
+            if (Track.ScaleLane != INDEX_NONE)
+            {
+                const FVector& Scale = GetRawKey(RawTrack.ScaleKeys, Frame);
+                for (uint32 iComponent = 0; iComponent < 3; iComponent++)
+                {
+                    Block[ScaleOffset + Layout.NumScaleLanes * iComponent + Track.ScaleLane] = Scale[iComponent];
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimSequence.h"
+#include "ObjectExporterFileFormat.h"
+
+class USkeleton;
+
+/** Animation encoding options, read from the ObjectExporter.* console variables when an anim sequence is gathered. */
+struct FObjectExporterAnimCompressionSettings
+{
+    bool bCompress = false;
+
+    /** Write the frame major layout instead of track major keys, takes precedence over bCompress. */
+    bool bFrameMajor = false;
+
+    /** Largest translation error, in world units. */
+    float PositionTolerance = 0.0f;
+
+    /** Largest rotation error, in radians. */
+    float RotationTolerance = 0.0f;
+
+    /** Largest scale error, per component. */
+    float ScaleTolerance = 0.0f;
+
+    /** Game thread only. */
+    static FObjectExporterAnimCompressionSettings Get();
+};
+
+/** Compressed tracks of an anim sequence, written as the CTRK, KFRM, QPOS, QROT and QSCL chunks. */
+struct FObjectExporterCompressedAnimData
+{
+    TArray<FObjectExporterCompressedAnimTrack> Tracks;
+    TArray<uint16> KeyFrames;
+    TArray<uint16> PositionKeys;
+    TArray<uint16> RotationKeys;
+    TArray<uint16> ScaleKeys;
+
+    /** Largest error of the decoded tracks against the raw keys, over every frame. */
+    float MaxPositionError = 0.0f;
+    float MaxRotationError = 0.0f;
+    float MaxScaleError = 0.0f;
+
+    SIZE_T GetAllocatedSize() const
+    {
+        return Tracks.GetAllocatedSize() + KeyFrames.GetAllocatedSize() + PositionKeys.GetAllocatedSize() + RotationKeys.GetAllocatedSize()
+            + ScaleKeys.GetAllocatedSize();
+    }
+};
+
+/** Frame major tracks of an anim sequence, written as the FLAY, FTRK and FKEY chunks. */
+struct FObjectExporterFrameMajorAnimData
+{
+    FObjectExporterAnimFrameLayout Layout = {};
+    TArray<FObjectExporterAnimFrameTrack> Tracks;
+
+    /** Layout.FrameStride floats per frame, aligned for SIMD loads. */
+    TArray<float, TAlignedHeapAllocator<16>> Keys;
+
+    SIZE_T GetAllocatedSize() const
+    {
+        return Tracks.GetAllocatedSize() + Keys.GetAllocatedSize();
+    }
+};
+
+namespace ObjectExporterAnimCompression
+{
+    /** SIMD width of the frame major layout. */
+    constexpr uint32 FrameLaneWidth = 4;
+
+    /**
+    *   Builds the BTRK table of a sequence: one entry per bone of Skeleton with its bind pose and the track animating it.
+    *   Tracks whose bone is not in the skeleton are left out of the table. Game thread only.
+    */
+    void BuildBoneTracks(const USkeleton* Skeleton, const TArray<int32>& TrackBoneIndices, TArray<FObjectExporterAnimBoneTrack>& OutBoneTracks);
+
+    /**
+    *   Compresses raw tracks: identity and constant channels are dropped to their value, animated channels keep only the
+    *   keys that linear interpolation cannot reproduce within the tolerance, and the kept keys are quantized.
+    *   The tolerance is checked against the quantized keys, so it bounds the decoded error. Returns false when the sequence
+    *   cannot be compressed (more frames than 16 bit frame indices address).
+    */
+    bool CompressTracks(const TArray<FRawAnimSequenceTrack>& Tracks, const TArray<int32>& TrackBoneIndices, int32 NumFrames,
+        const FObjectExporterAnimCompressionSettings& Settings, FObjectExporterCompressedAnimData& OutData);
+
+    /**
+    *   Builds the frame major layout: every frame keeps a full float key for each animated channel, constant and identity
+    *   channels (within the tolerances) are stored once per track. No key reduction, sampling a frame reads one block.
+    */
+    void BuildFrameMajorTracks(const TArray<FRawAnimSequenceTrack>& Tracks, const TArray<int32>& TrackBoneIndices, int32 NumFrames,
+        const FObjectExporterAnimCompressionSettings& Settings, FObjectExporterFrameMajorAnimData& OutData);
+
+    void EncodeRotation(const FQuat& Rotation, uint16* OutKey);
+    FQuat DecodeRotation(const uint16* Key);
+
+    void EncodeRange(const FVector& Value, const float* Params, uint16* OutKey);
+    FVector DecodeRange(const uint16* Key, const float* Params);
+}
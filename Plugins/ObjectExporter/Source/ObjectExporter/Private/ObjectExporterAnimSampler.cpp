@@ -0,0 +1,250 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterAnimSampler.h"
+#include "Animation/Skeleton.h"
+#include "Math/VectorRegister.h"
+
+DECLARE_LOG_CATEGORY_CLASS(ObjectExporterAnimSamplerLog, Log, All);
+
+void ObjectExporterAnimSampler::GetFrameBlend(int32 NumFrames, float SequenceLength, float Time, int32& OutFrame0, int32& OutFrame1, float& OutAlpha)
+{
+    const int32 LastFrame = FMath::Max(NumFrames - 1, 0);
+    const float FramePosition = SequenceLength > 0.0f ? FMath::Clamp(Time / SequenceLength, 0.0f, 1.0f) * LastFrame : 0.0f;
+
+    OutFrame0 = FMath::Min(FMath::FloorToInt(FramePosition), LastFrame);
+    OutFrame1 = FMath::Min(OutFrame0 + 1, LastFrame);
+    OutAlpha = FramePosition - OutFrame0;
+}
+
+template<typename ValueType>
+static const ValueType& GetKey(const TArray<ValueType>& Keys, int32 Frame)
+{
+    return Keys[FMath::Min(Frame, Keys.Num() - 1)];
+}
+
+void ObjectExporterAnimSampler::SampleRawTracks(const TArray<FRawAnimSequenceTrack>& Tracks, int32 NumFrames, float SequenceLength, float Time, TArray<FTransform>& OutPose)
+{
+    int32 Frame0, Frame1;
+    float Alpha;
+    GetFrameBlend(NumFrames, SequenceLength, Time, Frame0, Frame1, Alpha);
+
+    OutPose.SetNumUninitialized(Tracks.Num(), false);
+    for (int32 TrackIndex = 0; TrackIndex < Tracks.Num(); TrackIndex++)
+    {
+        const FRawAnimSequenceTrack& Track = Tracks[TrackIndex];
+
+        FQuat Rotation = FQuat::Identity;
+        if (Track.RotKeys.Num() > 0)
+        {
+            const FQuat& Rotation0 = GetKey(Track.RotKeys, Frame0);
+            const FQuat& Rotation1 = GetKey(Track.RotKeys, Frame1);
+            const float Sign = (Rotation0 | Rotation1) < 0.0f ? -1.0f : 1.0f;
+
+            Rotation = Rotation0 * (1.0f - Alpha) + Rotation1 * (Alpha * Sign);
+            Rotation.Normalize();
+        }
+
+        const FVector Translation = Track.PosKeys.Num() > 0 ? FMath::Lerp(GetKey(Track.PosKeys, Frame0), GetKey(Track.PosKeys, Frame1), Alpha) : FVector::ZeroVector;
+        const FVector Scale = Track.ScaleKeys.Num() > 0 ? FMath::Lerp(GetKey(Track.ScaleKeys, Frame0), GetKey(Track.ScaleKeys, Frame1), Alpha) : FVector::OneVector;
+
+        OutPose[TrackIndex] = FTransform(Rotation, Translation, Scale);
+    }
+}
+
+void ObjectExporterAnimSampler::SampleFrameMajorTracks(const FObjectExporterFrameMajorAnimData& Data, int32 NumFrames, float SequenceLength, float Time,
+    TArray<float, TAlignedHeapAllocator<16>>& Scratch, TArray<FTransform>& OutPose)
+{
+    const FObjectExporterAnimFrameLayout& Layout = Data.Layout;
+    const uint32 NumRotationLanes = Layout.NumRotationLanes;
+    const uint32 TranslationOffset = NumRotationLanes * 4;
+    const uint32 ScaleOffset = TranslationOffset + Layout.NumTranslationLanes * 3;
+
+    Scratch.SetNumUninitialized(Layout.FrameStride, false);
+    float* Blended = Scratch.GetData();
+
+    if (Layout.FrameStride > 0)
+    {
+        int32 Frame0, Frame1;
+        float Alpha;
+        GetFrameBlend(NumFrames, SequenceLength, Time, Frame0, Frame1, Alpha);
+
+        const float* Block0 = Data.Keys.GetData() + Frame0 * Layout.FrameStride;
+        const float* Block1 = Data.Keys.GetData() + Frame1 * Layout.FrameStride;
+        const VectorRegister Weight = VectorSetFloat1(Alpha);
+
+        // Rotations were sign aligned at export, nlerp is a lerp and a normalize, four quaternions at a time
+        for (uint32 Lane = 0; Lane < NumRotationLanes; Lane += ObjectExporterAnimCompression::FrameLaneWidth)
+        {
+            VectorRegister Components[4];
+            VectorRegister LengthSquared = VectorZero();
+            for (uint32 iComponent = 0; iComponent < 4; iComponent++)
+            {
+                const uint32 Offset = NumRotationLanes * iComponent + Lane;
+                const VectorRegister A = VectorLoadAligned(Block0 + Offset);
+                const VectorRegister B = VectorLoadAligned(Block1 + Offset);
+
+                Components[iComponent] = VectorMultiplyAdd(VectorSubtract(B, A), Weight, A);
+                LengthSquared = VectorMultiplyAdd(Components[iComponent], Components[iComponent], LengthSquared);
+            }
+
+            const VectorRegister InvLength = VectorReciprocalSqrtAccurate(LengthSquared);
+            for (uint32 iComponent = 0; iComponent < 4; iComponent++)
+            {
+                VectorStoreAligned(VectorMultiply(Components[iComponent], InvLength), Blended + NumRotationLanes * iComponent + Lane);
+            }
+        }
+
+        // Translations and scales are contiguous after the rotations
+        for (uint32 Offset = TranslationOffset; Offset < Layout.FrameStride; Offset += ObjectExporterAnimCompression::FrameLaneWidth)
+        {
+            const VectorRegister A = VectorLoadAligned(Block0 + Offset);
+            const VectorRegister B = VectorLoadAligned(Block1 + Offset);
+            VectorStoreAligned(VectorMultiplyAdd(VectorSubtract(B, A), Weight, A), Blended + Offset);
+        }
+    }
+
+    OutPose.SetNumUninitialized(Data.Tracks.Num(), false);
+    for (int32 TrackIndex = 0; TrackIndex < Data.Tracks.Num(); TrackIndex++)
+    {
+        const FObjectExporterAnimFrameTrack& Track = Data.Tracks[TrackIndex];
+
+        const FQuat Rotation = Track.RotationLane != INDEX_NONE
+            ? FQuat(Blended[Track.RotationLane], Blended[NumRotationLanes + Track.RotationLane], Blended[NumRotationLanes * 2 + Track.RotationLane], Blended[NumRotationLanes * 3 + Track.RotationLane])
+            : FQuat(Track.Rotation[0], Track.Rotation[1], Track.Rotation[2], Track.Rotation[3]);
+
+        const FVector Translation = Track.TranslationLane != INDEX_NONE
+            ? FVector(Blended[TranslationOffset + Track.TranslationLane], Blended[TranslationOffset + Layout.NumTranslationLanes + Track.TranslationLane], Blended[TranslationOffset + Layout.NumTranslationLanes * 2 + Track.TranslationLane])
+            : FVector(Track.Translation[0], Track.Translation[1], Track.Translation[2]);
+
+        const FVector Scale = Track.ScaleLane != INDEX_NONE
+            ? FVector(Blended[ScaleOffset + Track.ScaleLane], Blended[ScaleOffset + Layout.NumScaleLanes + Track.ScaleLane], Blended[ScaleOffset + Layout.NumScaleLanes * 2 + Track.ScaleLane])
+            : FVector(Track.Scale[0], Track.Scale[1], Track.Scale[2]);
+
+        OutPose[TrackIndex] = FTransform(Rotation, Translation, Scale);
+    }
+}
+
+void ObjectExporterAnimSampler::GetBindPose(const TArray<FObjectExporterAnimBoneTrack>& BoneTracks, TArray<FTransform>& OutBindPose)
+{
+    OutBindPose.SetNumUninitialized(BoneTracks.Num());
+    for (int32 BoneIndex = 0; BoneIndex < BoneTracks.Num(); BoneIndex++)
+    {
+        const FObjectExporterAnimBoneTrack& BoneTrack = BoneTracks[BoneIndex];
+        OutBindPose[BoneIndex] = FTransform(
+            FQuat(BoneTrack.Rotation[0], BoneTrack.Rotation[1], BoneTrack.Rotation[2], BoneTrack.Rotation[3]),
+            FVector(BoneTrack.Translation[0], BoneTrack.Translation[1], BoneTrack.Translation[2]),
+            FVector(BoneTrack.Scale[0], BoneTrack.Scale[1], BoneTrack.Scale[2]));
+    }
+}
+
+void ObjectExporterAnimSampler::ExpandBonePose(const TArray<FTransform>& BindPose, const TArray<int32>& TrackBoneIndices, const TArray<FTransform>& TrackPose, TArray<FTransform>& OutBonePose)
+{
+    OutBonePose.SetNumUninitialized(BindPose.Num(), false);
+    FMemory::Memcpy(OutBonePose.GetData(), BindPose.GetData(), BindPose.Num() * sizeof(FTransform));
+
+    for (int32 TrackIndex = 0; TrackIndex < TrackPose.Num(); TrackIndex++)
+    {
+        OutBonePose[TrackBoneIndices[TrackIndex]] = TrackPose[TrackIndex];
+    }
+}
+
+bool ObjectExporterAnimSampler::RunBenchmark(const UAnimSequence* AnimSequence, int32 NumPoses)
+{
+    if (AnimSequence == nullptr || NumPoses <= 0)
+    {
+        return false;
+    }
+
+    const TArray<FRawAnimSequenceTrack>& Tracks = AnimSequence->GetRawAnimationData();
+    const int32 NumFrames = AnimSequence->GetNumberOfFrames();
+    const float SequenceLength = AnimSequence->SequenceLength;
+
+    TArray<int32> TrackBoneIndices;
+    for (const FTrackToSkeletonMap& TrackToSkeleton : AnimSequence->GetRawTrackToSkeletonMapTable())
+    {
+        TrackBoneIndices.Add(TrackToSkeleton.BoneTreeIndex);
+    }
+
+    TArray<FObjectExporterAnimBoneTrack> BoneTracks;
+    ObjectExporterAnimCompression::BuildBoneTracks(AnimSequence->GetSkeleton(), TrackBoneIndices, BoneTracks);
+
+    if (Tracks.Num() == 0 || Tracks.Num() != TrackBoneIndices.Num())
+    {
+        return false;
+    }
+
+    for (int32 BoneIndex : TrackBoneIndices)
+    {
+        if (!BoneTracks.IsValidIndex(BoneIndex))
+        {
+            UE_LOG(ObjectExporterAnimSamplerLog, Warning, TEXT("BenchmarkAnimSampling %s: track bone %d is not in the skeleton."), *AnimSequence->GetName(), BoneIndex);
+            return false;
+        }
+    }
+
+    TArray<FTransform> BindPose;
+    GetBindPose(BoneTracks, BindPose);
+
+    FObjectExporterFrameMajorAnimData FrameMajorData;
+    ObjectExporterAnimCompression::BuildFrameMajorTracks(Tracks, TrackBoneIndices, NumFrames, FObjectExporterAnimCompressionSettings::Get(), FrameMajorData);
+
+    TArray<FTransform> RawPose;
+    TArray<FTransform> FrameMajorPose;
+    TArray<FTransform> BonePose;
+    TArray<float, TAlignedHeapAllocator<16>> Scratch;
+
+    // Accumulating a translation keeps the optimizer from dropping the poses
+    FVector Checksum = FVector::ZeroVector;
+
+    const double RawStart = FPlatformTime::Seconds();
+    for (int32 PoseIndex = 0; PoseIndex < NumPoses; PoseIndex++)
+    {
+        SampleRawTracks(Tracks, NumFrames, SequenceLength, SequenceLength * PoseIndex / NumPoses, RawPose);
+        ExpandBonePose(BindPose, TrackBoneIndices, RawPose, BonePose);
+        Checksum += BonePose.Last().GetTranslation();
+    }
+    const double RawSeconds = FPlatformTime::Seconds() - RawStart;
+
+    const double FrameMajorStart = FPlatformTime::Seconds();
+    for (int32 PoseIndex = 0; PoseIndex < NumPoses; PoseIndex++)
+    {
+        SampleFrameMajorTracks(FrameMajorData, NumFrames, SequenceLength, SequenceLength * PoseIndex / NumPoses, Scratch, FrameMajorPose);
+        ExpandBonePose(BindPose, TrackBoneIndices, FrameMajorPose, BonePose);
+        Checksum += BonePose.Last().GetTranslation();
+    }
+    const double FrameMajorSeconds = FPlatformTime::Seconds() - FrameMajorStart;
+
+    // Constant channels are within the tolerances, everything else should match to float precision
+    float MaxTranslationDifference = 0.0f;
+    float MaxRotationDifference = 0.0f;
+    for (int32 PoseIndex = 0; PoseIndex < NumFrames * 4; PoseIndex++)
+    {
+        const float Time = SequenceLength * PoseIndex / (NumFrames * 4);
+        SampleRawTracks(Tracks, NumFrames, SequenceLength, Time, RawPose);
+        SampleFrameMajorTracks(FrameMajorData, NumFrames, SequenceLength, Time, Scratch, FrameMajorPose);
+
+        for (int32 TrackIndex = 0; TrackIndex < Tracks.Num(); TrackIndex++)
+        {
+            MaxTranslationDifference = FMath::Max(MaxTranslationDifference, FVector::Dist(RawPose[TrackIndex].GetTranslation(), FrameMajorPose[TrackIndex].GetTranslation()));
+            MaxRotationDifference = FMath::Max(MaxRotationDifference, RawPose[TrackIndex].GetRotation().AngularDistance(FrameMajorPose[TrackIndex].GetRotation()));
+        }
+    }
+
+    int32 RawBytesPerFrame = 0;
+    for (const FRawAnimSequenceTrack& Track : Tracks)
+    {
+        RawBytesPerFrame += (Track.PosKeys.Num() > 1 ? sizeof(FVector) : 0) + (Track.RotKeys.Num() > 1 ? sizeof(FQuat) : 0) + (Track.ScaleKeys.Num() > 1 ? sizeof(FVector) : 0);
+    }
+
+    const USkeleton* Skeleton = AnimSequence->GetSkeleton();
+    UE_LOG(ObjectExporterAnimSamplerLog, Log, TEXT("BenchmarkAnimSampling %s (%s): %d bones, %d tracks, %d poses, checksum %s."),
+        *AnimSequence->GetName(), Skeleton != nullptr ? *Skeleton->GetName() : TEXT("no skeleton"), BindPose.Num(), Tracks.Num(), NumPoses, *Checksum.ToString());
+    UE_LOG(ObjectExporterAnimSamplerLog, Log, TEXT("BenchmarkAnimSampling raw track major: %.1f ns per pose, %d bytes of keys per frame in %d arrays."),
+        RawSeconds * 1e9 / NumPoses, RawBytesPerFrame, Tracks.Num() * 3);
+    UE_LOG(ObjectExporterAnimSamplerLog, Log, TEXT("BenchmarkAnimSampling frame major: %.1f ns per pose, %u bytes of keys per frame in one block, %.2fx."),
+        FrameMajorSeconds * 1e9 / NumPoses, FrameMajorData.Layout.FrameStride * (uint32)sizeof(float), FrameMajorSeconds > 0.0 ? RawSeconds / FrameMajorSeconds : 0.0);
+    UE_LOG(ObjectExporterAnimSamplerLog, Log, TEXT("BenchmarkAnimSampling largest difference: translation %f, rotation %f radians."),
+        MaxTranslationDifference, MaxRotationDifference);
+
+    return true;
+}
@@ -0,0 +1,43 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ObjectExporterAnimCompression.h"
+
+/*
+*   Reference pose sampling of exported animations, what the runtime does per character and frame.
+*   Both samplers blend the two frames around the time, translation and scale linearly, rotation with nlerp,
+*   and write one transform per track.
+*/
+namespace ObjectExporterAnimSampler
+{
+    /** Frames around Time, clamped to the sequence, and the weight of the second one. */
+    void GetFrameBlend(int32 NumFrames, float SequenceLength, float Time, int32& OutFrame0, int32& OutFrame1, float& OutAlpha);
+
+    /** Scalar sampling of raw track major keys. */
+    void SampleRawTracks(const TArray<FRawAnimSequenceTrack>& Tracks, int32 NumFrames, float SequenceLength, float Time, TArray<FTransform>& OutPose);
+
+    /**
+    *   Sampling of the frame major layout: the two frame blocks are blended four lanes per SIMD operation into Scratch,
+    *   which keeps its allocation between calls, then gathered per track.
+    */
+    void SampleFrameMajorTracks(const FObjectExporterFrameMajorAnimData& Data, int32 NumFrames, float SequenceLength, float Time,
+        TArray<float, TAlignedHeapAllocator<16>>& Scratch, TArray<FTransform>& OutPose);
+
+    /** Bind pose of every skeleton bone from a BTRK table, the start of every skeleton pose. */
+    void GetBindPose(const TArray<FObjectExporterAnimBoneTrack>& BoneTracks, TArray<FTransform>& OutBindPose);
+
+    /**
+    *   Skeleton pose from sampled tracks: the bind pose is copied as a whole and each track written over its bone,
+    *   so the loop has a fixed size and no per bone test. TrackBoneIndices must all be valid bones of BindPose.
+    */
+    void ExpandBonePose(const TArray<FTransform>& BindPose, const TArray<int32>& TrackBoneIndices, const TArray<FTransform>& TrackPose, TArray<FTransform>& OutBonePose);
+
+    /**
+    *   Samples NumPoses skeleton poses spread over the sequence with both samplers and logs the time per pose, the bytes read per
+    *   frame and the largest difference between the two. Game thread only, the frame major layout uses the current
+    *   ObjectExporter.Anim*Tolerance values.
+    */
+    bool RunBenchmark(const UAnimSequence* AnimSequence, int32 NumPoses);
+}
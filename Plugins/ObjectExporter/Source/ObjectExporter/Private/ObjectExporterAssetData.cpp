@@ -0,0 +1,1579 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterAssetData.h"
+#include "ObjectExporterFileWriter.h"
+#include "ObjectExporterJsonWriter.h"
+#include "ObjectExporterMeshOptimizer.h"
+#include "HAL/IConsoleManager.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/SkeletalMesh.h"
+#include "Animation/Skeleton.h"
+#include "Materials/MaterialInstance.h"
+#include "Engine/Texture2D.h"
+#include "Interfaces/ITargetPlatform.h"
+#include "Interfaces/ITargetPlatformManagerModule.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "Rendering/SkeletalMeshLODRenderData.h"
+#include "StaticMeshResources.h"
+
+DECLARE_LOG_CATEGORY_CLASS(ObjectExporterAssetDataLog, Log, All);
+
+/** Seconds Gather waits for the platform data of a texture before it fails the texture. */
+#define TEXTURE_CACHE_TIMEOUT 300
+
+static TAutoConsoleVariable<int32> CVarObjectExporterOptimizeMeshes(
+    TEXT("ObjectExporter.OptimizeMeshes"),
+    0,
+    TEXT("0: keep triangles and vertices in the order of the render buffers (default).\n")
+    TEXT("1: reorder triangles for the post-transform cache and overdraw, and vertices in first use order."));
+
+static TAutoConsoleVariable<int32> CVarObjectExporterGenerateMeshlets(
+    TEXT("ObjectExporter.GenerateMeshlets"),
+    0,
+    TEXT("1: split every static mesh section into meshlets with bounds and normal cones for cluster culling."));
+
+static TAutoConsoleVariable<FString> CVarObjectExporterTextureTargetPlatform(
+    TEXT("ObjectExporter.TextureTargetPlatform"),
+    TEXT("Android_ASTC"),
+    TEXT("Target platform whose cooked texture data is exported: Android_ASTC (default), Android_ETC2, WindowsNoEditor...\n")
+    TEXT("Empty: the platform the editor runs on."));
+
+static TAutoConsoleVariable<int32> CVarObjectExporterTextureResidentMipSize(
+    TEXT("ObjectExporter.TextureResidentMipSize"),
+    64,
+    TEXT("Largest mip, in texels along its longer side, of the resident mip tail of exported textures (default 64).\n")
+    TEXT("Larger mips are stored separately for streaming. 0 keeps every mip resident."));
+
+static FString GetResourceName(const UObject* Object)
+{
+    FString ResourceFullName = Object->GetPathName();
+    FString ResourcePath, ResourceName;
+    ResourceFullName.Split(FString("."), &ResourcePath, &ResourceName);
+
+    return ResourceName;
+}
+
+static void WriteJsonStrings(FObjectExporterJsonWriter& JsonWriter, const TCHAR* Name, const TArray<FString>& Strings)
+{
+    JsonWriter.BeginArray(Name);
+    for (const FString& String : Strings)
+    {
+        JsonWriter.Write(String);
+    }
+    JsonWriter.EndArray();
+}
+
+/** Rotation, Translation and Scale members of a transform. */
+static void WriteJsonTransform(FObjectExporterJsonWriter& JsonWriter, const FTransform& Transform)
+{
+    float Rotation[4];
+    float Translation[3];
+    float Scale[3];
+    ObjectExporterFile::CopyQuat(Rotation, Transform.GetRotation());
+    ObjectExporterFile::CopyVector(Translation, Transform.GetTranslation());
+    ObjectExporterFile::CopyVector(Scale, Transform.GetScale3D());
+
+    JsonWriter.WriteArray(TEXT("Rotation"), Rotation, 4);
+    JsonWriter.WriteArray(TEXT("Translation"), Translation, 3);
+    JsonWriter.WriteArray(TEXT("Scale"), Scale, 3);
+}
+
+/** LODs of a mesh with their sections, flat vertex attribute arrays and LOD relative indices. */
+static void WriteJsonMeshLODs(FObjectExporterJsonWriter& JsonWriter, const TArray<FObjectExporterMeshLOD>& LODs, const TArray<FObjectExporterMeshSection>& Sections,
+    const TArray<FObjectExporterMeshVertex>& Vertices, const TArray<FObjectExporterSkinWeight>* SkinWeights, const TArray<uint32>& Indices)
+{
+    constexpr int32 VertexStride = sizeof(FObjectExporterMeshVertex) / sizeof(float);
+
+    JsonWriter.BeginArray(TEXT("LODs"));
+    for (const FObjectExporterMeshLOD& LOD : LODs)
+    {
+        JsonWriter.BeginObject();
+        JsonWriter.Write(TEXT("ScreenSize"), LOD.ScreenSize);
+        JsonWriter.Write(TEXT("VertexCount"), LOD.NumVertices);
+        JsonWriter.Write(TEXT("IndexCount"), LOD.NumIndices);
+
+        JsonWriter.BeginArray(TEXT("Sections"));
+        for (uint32 SectionIndex = LOD.FirstSection; SectionIndex < LOD.FirstSection + LOD.NumSections; SectionIndex++)
+        {
+            const FObjectExporterMeshSection& Section = Sections[SectionIndex];
+
+            JsonWriter.BeginObject();
+            JsonWriter.Write(TEXT("MaterialIndex"), Section.MaterialIndex);
+            JsonWriter.Write(TEXT("FirstIndex"), Section.FirstIndex - LOD.FirstIndex);
+            JsonWriter.Write(TEXT("IndexCount"), Section.NumIndices);
+            JsonWriter.EndObject();
+        }
+        JsonWriter.EndArray();
+
+        // An empty LOD may start at the end of the arrays, it has no attribute arrays
+        if (LOD.NumVertices > 0)
+        {
+            const FObjectExporterMeshVertex* FirstVertex = Vertices.GetData() + LOD.FirstVertex;
+            JsonWriter.WriteArray(TEXT("Positions"), FirstVertex->Position, LOD.NumVertices, 3, VertexStride);
+            JsonWriter.WriteArray(TEXT("Normals"), FirstVertex->Normal, LOD.NumVertices, 3, VertexStride);
+            JsonWriter.WriteArray(TEXT("UVs"), FirstVertex->UV, LOD.NumVertices, 2, VertexStride);
+
+            // Bone indices are mesh bones, see Bones
+            if (SkinWeights != nullptr)
+            {
+                const FObjectExporterSkinWeight* FirstSkinWeight = SkinWeights->GetData() + LOD.FirstVertex;
+                JsonWriter.WriteArray(TEXT("BoneIndices"), FirstSkinWeight->BoneIndices, LOD.NumVertices, 4, sizeof(FObjectExporterSkinWeight) / sizeof(uint16));
+                JsonWriter.WriteArray(TEXT("BoneWeights"), FirstSkinWeight->BoneWeights, LOD.NumVertices, 4, sizeof(FObjectExporterSkinWeight) / sizeof(float));
+            }
+        }
+
+        if (LOD.NumIndices > 0)
+        {
+            JsonWriter.WriteArray(TEXT("Indices"), Indices.GetData() + LOD.FirstIndex, LOD.NumIndices);
+        }
+        JsonWriter.EndObject();
+    }
+    JsonWriter.EndArray();
+}
+
+static void AddMaterialNamesChunk(FObjectExporterFileWriter& FileWriter, const TArray<FString>& MaterialNames)
+{
+    TArray<uint32> MaterialNameOffsets;
+    for (const FString& MaterialName : MaterialNames)
+    {
+        MaterialNameOffsets.Add(MaterialName.IsEmpty() ? OBJECT_EXPORTER_INVALID_STRING : FileWriter.AddString(MaterialName));
+    }
+
+    FileWriter.AddChunk(ObjectExporterChunk::MaterialNames, MaterialNameOffsets);
+}
+
+/** Writes INDX with 16 bit indices when every index fits, 32 bit otherwise. Returns the index size in bytes. */
+static uint32 AddIndicesChunk(FObjectExporterFileWriter& FileWriter, const TArray<uint32>& Indices)
+{
+    uint32 MaxIndex = 0;
+    for (uint32 Index : Indices)
+    {
+        MaxIndex = FMath::Max(MaxIndex, Index);
+    }
+
+    if (MaxIndex > MAX_uint16)
+    {
+        FileWriter.AddChunk(ObjectExporterChunk::Indices, Indices);
+
+        return sizeof(uint32);
+    }
+
+    TArray<uint8>& IndexChunk = FileWriter.AddChunk(ObjectExporterChunk::Indices, sizeof(uint16));
+    IndexChunk.AddUninitialized(Indices.Num() * sizeof(uint16));
+
+    uint16* Index = reinterpret_cast<uint16*>(IndexChunk.GetData());
+    for (int32 iIndex = 0; iIndex < Indices.Num(); iIndex++)
+    {
+        Index[iIndex] = (uint16)Indices[iIndex];
+    }
+
+    return sizeof(uint16);
+}
+
+/**
+*   Appends generated LODs to a mesh snapshot that only has LOD 0. Every generated LOD is simplified from LOD 0 section by
+*   section, keeps the section materials and bone maps, and gets its own compacted vertex range. Each LOD is selected at half
+*   the screen size of the previous one and records its error against LOD 0. SkinWeights may be null.
+*/
+static void GenerateMeshLODs(const FString& AssetName, const FObjectExporterLODGenerationSettings& Settings, TArray<FObjectExporterMeshLOD>& LODs,
+    TArray<FObjectExporterMeshSection>& Sections, TArray<FObjectExporterMeshVertex>& Vertices, TArray<uint32>& Indices, TArray<FObjectExporterSkinWeight>* SkinWeights)
+{
+    if (Settings.NumLODs <= 0 || LODs.Num() != 1)
+    {
+        return;
+    }
+
+    const FObjectExporterMeshLOD SourceLOD = LODs[0];
+    float TriangleRatio = 1.0f;
+
+    for (int32 LODIndex = 1; LODIndex <= Settings.NumLODs; LODIndex++)
+    {
+        TriangleRatio *= Settings.TriangleRatio;
+
+        TArray<uint32> LODIndices;
+        TArray<FObjectExporterMeshSection> LODSections;
+        float GeometricError = 0.0f;
+
+        for (uint32 SectionIndex = SourceLOD.FirstSection; SectionIndex < SourceLOD.FirstSection + SourceLOD.NumSections; SectionIndex++)
+        {
+            const FObjectExporterMeshSection& SourceSection = Sections[SectionIndex];
+            TArray<uint32> SectionIndices(Indices.GetData() + SourceSection.FirstIndex, SourceSection.NumIndices);
+
+            const int32 TargetNumIndices = FMath::FloorToInt(SourceSection.NumIndices / 3 * TriangleRatio) * 3;
+            const float SectionError = ObjectExporterMeshSimplifier::Simplify(SectionIndices, Vertices.GetData() + SourceLOD.FirstVertex,
+                SkinWeights != nullptr ? SkinWeights->GetData() + SourceLOD.FirstVertex : nullptr, SourceLOD.NumVertices, TargetNumIndices, Settings.MaxError);
+            GeometricError = FMath::Max(GeometricError, SectionError);
+
+            FObjectExporterMeshSection& Section = LODSections.Add_GetRef(SourceSection);
+            Section.FirstIndex = LODIndices.Num();
+            Section.NumIndices = SectionIndices.Num();
+
+            LODIndices.Append(SectionIndices);
+        }
+
+        // A LOD that barely removes anything is not worth its memory, and the next ones would not do better
+        const FObjectExporterMeshLOD& PreviousLOD = LODs.Last();
+        if (LODIndices.Num() == 0 || LODIndices.Num() > PreviousLOD.NumIndices * 9 / 10)
+        {
+            UE_LOG(ObjectExporterAssetDataLog, Log, TEXT("GenerateLODs %s: stopped at LOD %d, %d triangles left."), *AssetName, LODIndex, LODIndices.Num() / 3);
+            break;
+        }
+
+        // Only the vertices still referenced are kept, in first use order
+        TArray<uint32> Remap;
+        Remap.Init(MAX_uint32, SourceLOD.NumVertices);
+        TArray<FObjectExporterMeshVertex> LODVertices;
+        TArray<FObjectExporterSkinWeight> LODSkinWeights;
+
+        for (uint32& Index : LODIndices)
+        {
+            if (Remap[Index] == MAX_uint32)
+            {
+                Remap[Index] = LODVertices.Num();
+                LODVertices.Add(Vertices[SourceLOD.FirstVertex + Index]);
+                if (SkinWeights != nullptr)
+                {
+                    LODSkinWeights.Add((*SkinWeights)[SourceLOD.FirstVertex + Index]);
+                }
+            }
+
+            Index = Remap[Index];
+        }
+
+        FObjectExporterMeshLOD& LOD = LODs.AddZeroed_GetRef();
+        LOD.FirstVertex = Vertices.Num();
+        LOD.NumVertices = LODVertices.Num();
+        LOD.FirstIndex = Indices.Num();
+        LOD.NumIndices = LODIndices.Num();
+        LOD.ScreenSize = LODs[LODIndex - 1].ScreenSize * 0.5f;
+        LOD.FirstSection = Sections.Num();
+        LOD.NumSections = LODSections.Num();
+        LOD.GeometricError = GeometricError;
+
+        for (FObjectExporterMeshSection& Section : LODSections)
+        {
+            Section.FirstIndex += LOD.FirstIndex;
+            Section.MinVertexIndex = 0;
+            Section.MaxVertexIndex = 0;
+
+            if (Section.NumIndices > 0)
+            {
+                Section.MinVertexIndex = MAX_uint32;
+                for (uint32 iIndex = Section.FirstIndex - LOD.FirstIndex; iIndex < Section.FirstIndex - LOD.FirstIndex + Section.NumIndices; iIndex++)
+                {
+                    Section.MinVertexIndex = FMath::Min(Section.MinVertexIndex, LODIndices[iIndex]);
+                    Section.MaxVertexIndex = FMath::Max(Section.MaxVertexIndex, LODIndices[iIndex]);
+                }
+            }
+        }
+
+        Vertices.Append(LODVertices);
+        if (SkinWeights != nullptr)
+        {
+            SkinWeights->Append(LODSkinWeights);
+        }
+        Indices.Append(LODIndices);
+        Sections.Append(LODSections);
+
+        UE_LOG(ObjectExporterAssetDataLog, Log, TEXT("GenerateLODs %s LOD %d: %d -> %d triangles, %d vertices, error %f."),
+            *AssetName, LODIndex, SourceLOD.NumIndices / 3, LOD.NumIndices / 3, LOD.NumVertices, LOD.GeometricError);
+    }
+}
+
+/**
+*   Optimizes every LOD of a mesh snapshot in place and logs the vertex cache efficiency before and after.
+*   Triangles only move inside their section, so section index ranges stay valid. SkinWeights may be null.
+*/
+static void OptimizeMeshLODs(const FString& AssetName, const TArray<FObjectExporterMeshLOD>& LODs, TArray<FObjectExporterMeshSection>& Sections,
+    TArray<FObjectExporterMeshVertex>& Vertices, TArray<uint32>& Indices, TArray<FObjectExporterSkinWeight>* SkinWeights)
+{
+    for (int32 LODIndex = 0; LODIndex < LODs.Num(); LODIndex++)
+    {
+        const FObjectExporterMeshLOD& LOD = LODs[LODIndex];
+        uint32* LODIndices = Indices.GetData() + LOD.FirstIndex;
+        FObjectExporterMeshVertex* LODVertices = Vertices.GetData() + LOD.FirstVertex;
+
+        const FObjectExporterVertexCacheStats Before = ObjectExporterMeshOptimizer::AnalyzeVertexCache(LODIndices, LOD.NumIndices, LOD.NumVertices);
+
+        for (uint32 SectionIndex = LOD.FirstSection; SectionIndex < LOD.FirstSection + LOD.NumSections; SectionIndex++)
+        {
+            uint32* SectionIndices = Indices.GetData() + Sections[SectionIndex].FirstIndex;
+            ObjectExporterMeshOptimizer::OptimizeVertexCache(SectionIndices, Sections[SectionIndex].NumIndices, LOD.NumVertices);
+            ObjectExporterMeshOptimizer::OptimizeOverdraw(SectionIndices, Sections[SectionIndex].NumIndices, LODVertices, LOD.NumVertices);
+        }
+
+        TArray<uint32> Remap;
+        ObjectExporterMeshOptimizer::ComputeVertexFetchRemap(LODIndices, LOD.NumIndices, LOD.NumVertices, Remap);
+        ObjectExporterMeshOptimizer::RemapVertices(LODVertices, LOD.NumVertices, Remap);
+        if (SkinWeights != nullptr)
+        {
+            ObjectExporterMeshOptimizer::RemapVertices(SkinWeights->GetData() + LOD.FirstVertex, LOD.NumVertices, Remap);
+        }
+
+        for (uint32 iIndex = 0; iIndex < LOD.NumIndices; iIndex++)
+        {
+            LODIndices[iIndex] = Remap[LODIndices[iIndex]];
+        }
+
+        // Vertices moved, so the vertex range of each section has to be found again
+        for (uint32 SectionIndex = LOD.FirstSection; SectionIndex < LOD.FirstSection + LOD.NumSections; SectionIndex++)
+        {
+            FObjectExporterMeshSection& Section = Sections[SectionIndex];
+            if (Section.NumIndices > 0)
+            {
+                Section.MinVertexIndex = MAX_uint32;
+                Section.MaxVertexIndex = 0;
+                for (uint32 iIndex = Section.FirstIndex; iIndex < Section.FirstIndex + Section.NumIndices; iIndex++)
+                {
+                    Section.MinVertexIndex = FMath::Min(Section.MinVertexIndex, Indices[iIndex]);
+                    Section.MaxVertexIndex = FMath::Max(Section.MaxVertexIndex, Indices[iIndex]);
+                }
+            }
+        }
+
+        const FObjectExporterVertexCacheStats After = ObjectExporterMeshOptimizer::AnalyzeVertexCache(LODIndices, LOD.NumIndices, LOD.NumVertices);
+
+        UE_LOG(ObjectExporterAssetDataLog, Log, TEXT("Optimize %s LOD %d: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f."),
+            *AssetName, LODIndex, Before.ACMR, After.ACMR, Before.ATVR, After.ATVR);
+    }
+}
+
+/**
+*   Parents first order of a bone hierarchy (stable, the engine reference skeleton is already sorted this way) and the
+*   component space bind matrices and their inverses, computed along that order. Returns false for a parent cycle.
+*/
+static bool ComputeBindMatrices(const TArray<int32>& ParentIndices, const TArray<FTransform>& LocalPose, TArray<uint32>& OutOrder,
+    TArray<FObjectExporterMatrix>& OutBindMatrices, TArray<FObjectExporterMatrix>& OutInverseBindMatrices)
+{
+    const int32 NumBones = LocalPose.Num();
+
+    TBitArray<> Sorted(false, NumBones);
+    OutOrder.Reset(NumBones);
+    while (OutOrder.Num() < NumBones)
+    {
+        const int32 NumSorted = OutOrder.Num();
+        for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+        {
+            const int32 ParentIndex = ParentIndices[BoneIndex];
+            if (!Sorted[BoneIndex] && (!Sorted.IsValidIndex(ParentIndex) || Sorted[ParentIndex]))
+            {
+                Sorted[BoneIndex] = true;
+                OutOrder.Add(BoneIndex);
+            }
+        }
+
+        // A parent cycle cannot come from a valid reference skeleton
+        if (!ensure(OutOrder.Num() > NumSorted))
+        {
+            return false;
+        }
+    }
+
+    TArray<FTransform> ComponentPose;
+    ComponentPose.SetNum(NumBones);
+    OutBindMatrices.SetNumZeroed(NumBones);
+    OutInverseBindMatrices.SetNumZeroed(NumBones);
+
+    for (uint32 BoneIndex : OutOrder)
+    {
+        const int32 ParentIndex = ParentIndices[BoneIndex];
+        ComponentPose[BoneIndex] = ComponentPose.IsValidIndex(ParentIndex) ? LocalPose[BoneIndex] * ComponentPose[ParentIndex] : LocalPose[BoneIndex];
+
+        const FMatrix BindMatrix = ComponentPose[BoneIndex].ToMatrixWithScale();
+        ObjectExporterFile::CopyMatrix(OutBindMatrices[BoneIndex], BindMatrix);
+        ObjectExporterFile::CopyMatrix(OutInverseBindMatrices[BoneIndex], BindMatrix.Inverse());
+    }
+
+    return true;
+}
+
+/**
+*   Replaces the engine section bone maps by palettes of the bones the section's vertices actually weight, in ascending
+*   mesh bone order, and rewrites SkinWeights to index into the palette of their section. Runs after every other mesh
+*   processing step, they compare skin weights by mesh bone.
+*/
+static void BuildSectionPalettes(const FString& AssetName, const TArray<FObjectExporterMeshLOD>& LODs, TArray<FObjectExporterMeshSection>& Sections,
+    TArray<FBoneIndexType>& BoneMap, TArray<FObjectExporterSkinWeight>& SkinWeights, const TArray<uint32>& Indices)
+{
+    TArray<FBoneIndexType> Palettes;
+    TArray<int32> VertexSections;
+    VertexSections.Init(INDEX_NONE, SkinWeights.Num());
+    int32 NumSharedVertices = 0;
+
+    for (const FObjectExporterMeshLOD& LOD : LODs)
+    {
+        for (uint32 SectionIndex = LOD.FirstSection; SectionIndex < LOD.FirstSection + LOD.NumSections; SectionIndex++)
+        {
+            FObjectExporterMeshSection& Section = Sections[SectionIndex];
+
+            TArray<uint32> SectionVertices;
+            for (uint32 iIndex = Section.FirstIndex; iIndex < Section.FirstIndex + Section.NumIndices; iIndex++)
+            {
+                const uint32 VertexIndex = LOD.FirstVertex + Indices[iIndex];
+                if (VertexSections[VertexIndex] == INDEX_NONE)
+                {
+                    VertexSections[VertexIndex] = SectionIndex;
+                    SectionVertices.Add(VertexIndex);
+                }
+                else if (VertexSections[VertexIndex] != (int32)SectionIndex)
+                {
+                    NumSharedVertices++;
+                }
+            }
+
+            TArray<FBoneIndexType> Palette;
+            for (uint32 VertexIndex : SectionVertices)
+            {
+                for (int32 iInfluence = 0; iInfluence < 4; iInfluence++)
+                {
+                    if (SkinWeights[VertexIndex].BoneWeights[iInfluence] > 0.0f)
+                    {
+                        Palette.AddUnique(SkinWeights[VertexIndex].BoneIndices[iInfluence]);
+                    }
+                }
+            }
+            Palette.Sort();
+
+            for (uint32 VertexIndex : SectionVertices)
+            {
+                FObjectExporterSkinWeight& SkinWeight = SkinWeights[VertexIndex];
+                for (int32 iInfluence = 0; iInfluence < 4; iInfluence++)
+                {
+                    SkinWeight.BoneIndices[iInfluence] = SkinWeight.BoneWeights[iInfluence] > 0.0f ? (uint16)Palette.IndexOfByKey(SkinWeight.BoneIndices[iInfluence]) : 0;
+                }
+            }
+
+            Section.FirstBone = Palettes.Num();
+            Section.NumBones = Palette.Num();
+            Palettes.Append(Palette);
+        }
+    }
+
+    // Sections of an engine skeletal mesh LOD own their vertices, a shared vertex keeps the palette of its first section
+    if (NumSharedVertices > 0)
+    {
+        UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("Palettes %s: %d vertices are shared by several sections."), *AssetName, NumSharedVertices);
+    }
+
+    UE_LOG(ObjectExporterAssetDataLog, Log, TEXT("Palettes %s: %d -> %d bone map entries over %d sections."), *AssetName, BoneMap.Num(), Palettes.Num(), Sections.Num());
+
+    BoneMap = MoveTemp(Palettes);
+}
+
+FObjectExporterAssetData::FObjectExporterAssetData(uint32 InFileType, const TCHAR* AssetType, const FString& AssetName)
+    : FileType(InFileType)
+    , Timing(AssetType, AssetName)
+{
+
+}
+
+bool FObjectExporterAssetData::Save(const FString& FullFilePathName)
+{
+    Timing.BeginWrite();
+
+    if (!Process())
+    {
+        UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("Save %s: the asset could not be processed, %s is not written."), *Timing.AssetName, *FullFilePathName);
+
+        return false;
+    }
+
+    FObjectExporterFileWriter FileWriter(FileType);
+    Encode(FileWriter);
+
+    if (!FileWriter.SaveToFile(FullFilePathName))
+    {
+        UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("Save %s: failed to write %s."), *Timing.AssetName, *FullFilePathName);
+
+        return false;
+    }
+
+    Timing.EndWrite(FileWriter.GetFileSize());
+    ObjectExporterStats::Record(Timing);
+
+    return true;
+}
+
+bool FObjectExporterAssetData::SaveJson(const FString& FullFilePathName)
+{
+    Timing.BeginWrite();
+
+    FObjectExporterJsonWriter JsonWriter;
+    if (JsonWriter.Open(FullFilePathName))
+    {
+        JsonWriter.BeginObject();
+        JsonWriter.Write(TEXT("FileVersion"), (int32)EObjectExporterFileVersion::Latest);
+        JsonWriter.Write(TEXT("Name"), GetAssetName());
+        EncodeJson(JsonWriter);
+        JsonWriter.EndObject();
+    }
+
+    if (!JsonWriter.Close())
+    {
+        UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("SaveJson %s: failed to write %s."), *Timing.AssetName, *FullFilePathName);
+
+        return false;
+    }
+
+    Timing.EndWrite(JsonWriter.GetFileSize());
+    ObjectExporterStats::Record(Timing);
+
+    return true;
+}
+
+FStaticMeshExportData::FStaticMeshExportData(const FString& AssetName)
+    : FObjectExporterAssetData(ObjectExporterFile::StaticMesh, TEXT("StaticMesh"), AssetName)
+    , bOptimizeMesh(false)
+    , bGenerateMeshlets(false)
+{
+
+}
+
+TSharedPtr<FStaticMeshExportData, ESPMode::ThreadSafe> FStaticMeshExportData::Gather(const UStaticMesh* StaticMesh)
+{
+    if (StaticMesh == nullptr || StaticMesh->RenderData == nullptr)
+    {
+        return nullptr;
+    }
+
+    TSharedPtr<FStaticMeshExportData, ESPMode::ThreadSafe> Data = MakeShared<FStaticMeshExportData, ESPMode::ThreadSafe>(StaticMesh->GetName());
+    Data->bOptimizeMesh = CVarObjectExporterOptimizeMeshes.GetValueOnGameThread() != 0;
+    Data->bGenerateMeshlets = CVarObjectExporterGenerateMeshlets.GetValueOnGameThread() != 0;
+    Data->VertexFormat = FObjectExporterVertexFormatSettings::Get();
+    Data->LODGeneration = FObjectExporterLODGenerationSettings::Get();
+
+    for (const FStaticMaterial& StaticMaterial : StaticMesh->StaticMaterials)
+    {
+        Data->MaterialNames.Add(StaticMaterial.MaterialInterface != nullptr ? GetResourceName(StaticMaterial.MaterialInterface) : FString());
+    }
+
+    // Build each LOD into contiguous staging buffers, every chunk is then written with a single Serialize
+    for (int32 LODIndex = 0; LODIndex < StaticMesh->RenderData->LODResources.Num(); LODIndex++)
+    {
+        const FStaticMeshLODResources& CurLOD = StaticMesh->RenderData->LODResources[LODIndex];
+
+        // Vertex data
+        const FPositionVertexBuffer& PositionVertexBuffer = CurLOD.VertexBuffers.PositionVertexBuffer;
+        const FStaticMeshVertexBuffer& StaticMeshVertexBuffer = CurLOD.VertexBuffers.StaticMeshVertexBuffer;
+        FIndexArrayView LODIndices = CurLOD.IndexBuffer.GetArrayView();
+        const int32 NumVertices = PositionVertexBuffer.GetNumVertices();
+
+        FObjectExporterMeshLOD& LOD = Data->LODs.AddZeroed_GetRef();
+        LOD.FirstVertex = Data->Vertices.Num();
+        LOD.NumVertices = NumVertices;
+        LOD.FirstIndex = Data->Indices.Num();
+        LOD.NumIndices = LODIndices.Num();
+        LOD.ScreenSize = StaticMesh->RenderData->ScreenSize[LODIndex].Default;
+
+        FObjectExporterMeshVertex* Vertex = Data->Vertices.GetData() + Data->Vertices.AddUninitialized(NumVertices);
+        for (int32 iVertex = 0; iVertex < NumVertices; iVertex++, Vertex++)
+        {
+            FVector4 TangentZ = StaticMeshVertexBuffer.VertexTangentZ(iVertex);
+            FVector Normal = FVector(TangentZ.X, TangentZ.Y, TangentZ.Z) * TangentZ.W;
+
+            ObjectExporterFile::CopyVector(Vertex->Position, PositionVertexBuffer.VertexPosition(iVertex));
+            ObjectExporterFile::CopyVector(Vertex->Normal, Normal);
+            ObjectExporterFile::CopyVector2D(Vertex->UV, StaticMeshVertexBuffer.GetVertexUV(iVertex, 0));
+        }
+
+        // Index data
+        uint32* Index = Data->Indices.GetData() + Data->Indices.AddUninitialized(LODIndices.Num());
+        for (int32 iIndex = 0; iIndex < LODIndices.Num(); iIndex++)
+        {
+            Index[iIndex] = LODIndices[iIndex];
+        }
+
+        // Section data
+        LOD.FirstSection = Data->Sections.Num();
+        LOD.NumSections = CurLOD.Sections.Num();
+
+        for (const FStaticMeshSection& CurSection : CurLOD.Sections)
+        {
+            FObjectExporterMeshSection& Section = Data->Sections.AddZeroed_GetRef();
+            Section.FirstIndex = LOD.FirstIndex + CurSection.FirstIndex;
+            Section.NumIndices = CurSection.NumTriangles * 3;
+            Section.MinVertexIndex = CurSection.MinVertexIndex;
+            Section.MaxVertexIndex = CurSection.MaxVertexIndex;
+            Section.MaterialIndex = CurSection.MaterialIndex;
+        }
+    }
+
+    Data->Timing.EndGather();
+
+    return Data;
+}
+
+SIZE_T FStaticMeshExportData::GetAllocatedSize() const
+{
+    return LODs.GetAllocatedSize() + Sections.GetAllocatedSize() + MaterialNames.GetAllocatedSize() + Vertices.GetAllocatedSize() + Indices.GetAllocatedSize()
+        + Meshlets.GetAllocatedSize();
+}
+
+bool FStaticMeshExportData::Process()
+{
+    GenerateMeshLODs(GetAssetName(), LODGeneration, LODs, Sections, Vertices, Indices, nullptr);
+
+    if (bOptimizeMesh)
+    {
+        OptimizeMeshLODs(GetAssetName(), LODs, Sections, Vertices, Indices, nullptr);
+    }
+
+    if (bGenerateMeshlets)
+    {
+        for (const FObjectExporterMeshLOD& LOD : LODs)
+        {
+            const FObjectExporterMeshVertex* LODVertices = Vertices.GetData() + LOD.FirstVertex;
+
+            for (uint32 SectionIndex = LOD.FirstSection; SectionIndex < LOD.FirstSection + LOD.NumSections; SectionIndex++)
+            {
+                const FObjectExporterMeshSection& Section = Sections[SectionIndex];
+                ObjectExporterMeshlet::BuildMeshlets(Indices.GetData() + Section.FirstIndex, Section.NumIndices, LODVertices, SectionIndex, Meshlets);
+            }
+        }
+    }
+
+    return true;
+}
+
+void FStaticMeshExportData::Encode(FObjectExporterFileWriter& FileWriter) const
+{
+    FObjectExporterStaticMeshInfo Info;
+    Info.IndexSize = AddIndicesChunk(FileWriter, Indices);
+
+    FileWriter.AddSingleElementChunk(ObjectExporterChunk::Info, Info);
+    FileWriter.AddChunk(ObjectExporterChunk::LODs, LODs);
+    FileWriter.AddChunk(ObjectExporterChunk::Sections, Sections);
+    AddMaterialNamesChunk(FileWriter, MaterialNames);
+    ObjectExporterVertexFormat::AddVertexChunks(FileWriter, GetAssetName(), VertexFormat, Vertices, nullptr);
+
+    if (Meshlets.Meshlets.Num() > 0)
+    {
+        FileWriter.AddChunk(ObjectExporterChunk::Meshlets, Meshlets.Meshlets);
+        FileWriter.AddChunk(ObjectExporterChunk::MeshletVertices, Meshlets.Vertices);
+
+        TArray<uint8>& MeshletTriangles = FileWriter.AddChunk(ObjectExporterChunk::MeshletTriangles, 3);
+        MeshletTriangles.Append(Meshlets.Triangles);
+    }
+}
+
+void FStaticMeshExportData::EncodeJson(FObjectExporterJsonWriter& JsonWriter) const
+{
+    WriteJsonStrings(JsonWriter, TEXT("Materials"), MaterialNames);
+    WriteJsonMeshLODs(JsonWriter, LODs, Sections, Vertices, nullptr, Indices);
+}
+
+FSkeletalMeshExportData::FSkeletalMeshExportData(const FString& AssetName)
+    : FObjectExporterAssetData(ObjectExporterFile::SkeletalMesh, TEXT("SkeletalMesh"), AssetName)
+    , bOptimizeMesh(false)
+{
+
+}
+
+TSharedPtr<FSkeletalMeshExportData, ESPMode::ThreadSafe> FSkeletalMeshExportData::Gather(const USkeletalMesh* SkeletalMesh)
+{
+    if (SkeletalMesh == nullptr || SkeletalMesh->GetResourceForRendering() == nullptr || SkeletalMesh->Skeleton == nullptr)
+    {
+        return nullptr;
+    }
+
+    TSharedPtr<FSkeletalMeshExportData, ESPMode::ThreadSafe> Data = MakeShared<FSkeletalMeshExportData, ESPMode::ThreadSafe>(SkeletalMesh->GetName());
+    Data->SkeletonName = GetResourceName(SkeletalMesh->Skeleton);
+    Data->bOptimizeMesh = CVarObjectExporterOptimizeMeshes.GetValueOnGameThread() != 0;
+    Data->VertexFormat = FObjectExporterVertexFormatSettings::Get();
+    Data->LODGeneration = FObjectExporterLODGenerationSettings::Get();
+
+    for (const FSkeletalMaterial& SkeletalMaterial : SkeletalMesh->Materials)
+    {
+        Data->MaterialNames.Add(SkeletalMaterial.MaterialInterface != nullptr ? GetResourceName(SkeletalMaterial.MaterialInterface) : FString());
+    }
+
+    // Mesh bones, the skinning reference pose can differ from the skeleton's
+    const FReferenceSkeleton& MeshRefSkeleton = SkeletalMesh->RefSkeleton;
+    const FReferenceSkeleton& SkeletonRefSkeleton = SkeletalMesh->Skeleton->GetReferenceSkeleton();
+    for (int32 BoneIndex = 0; BoneIndex < MeshRefSkeleton.GetRawBoneNum(); BoneIndex++)
+    {
+        const FName BoneName = MeshRefSkeleton.GetBoneName(BoneIndex);
+        Data->MeshBoneNames.Add(BoneName.ToString());
+        Data->MeshBoneParents.Add(MeshRefSkeleton.GetParentIndex(BoneIndex));
+        Data->MeshBoneSkeletonIndices.Add(SkeletonRefSkeleton.FindBoneIndex(BoneName));
+    }
+    Data->MeshRefPose = MeshRefSkeleton.GetRawRefBonePose();
+
+    // Build each LOD into contiguous staging buffers, every chunk is then written with a single Serialize
+    const TIndirectArray<FSkeletalMeshLODRenderData>& LODRenderData = SkeletalMesh->GetResourceForRendering()->LODRenderData;
+    for (int32 LODIndex = 0; LODIndex < LODRenderData.Num(); LODIndex++)
+    {
+        const FSkeletalMeshLODRenderData& CurLOD = LODRenderData[LODIndex];
+        const FSkeletalMeshLODInfo* LODInfo = SkeletalMesh->GetLODInfo(LODIndex);
+
+        // Vertex data
+        const FPositionVertexBuffer& PositionVertexBuffer = CurLOD.StaticVertexBuffers.PositionVertexBuffer;
+        const FStaticMeshVertexBuffer& StaticMeshVertexBuffer = CurLOD.StaticVertexBuffers.StaticMeshVertexBuffer;
+        TArray<FSkinWeightInfo> WeightInfos;
+        CurLOD.SkinWeightVertexBuffer.GetSkinWeights(WeightInfos);
+        TArray<uint32> LODIndices;
+        CurLOD.MultiSizeIndexContainer.GetIndexBuffer(LODIndices);
+        const int32 NumVertices = PositionVertexBuffer.GetNumVertices();
+
+        FObjectExporterMeshLOD& LOD = Data->LODs.AddZeroed_GetRef();
+        LOD.FirstVertex = Data->Vertices.Num();
+        LOD.NumVertices = NumVertices;
+        LOD.FirstIndex = Data->Indices.Num();
+        LOD.NumIndices = LODIndices.Num();
+        LOD.ScreenSize = LODInfo != nullptr ? LODInfo->ScreenSize.Default : 0.0f;
+
+        FObjectExporterMeshVertex* Vertex = Data->Vertices.GetData() + Data->Vertices.AddUninitialized(NumVertices);
+        for (int32 iVertex = 0; iVertex < NumVertices; iVertex++, Vertex++)
+        {
+            FVector4 TangentZ = StaticMeshVertexBuffer.VertexTangentZ(iVertex);
+            FVector Normal = FVector(TangentZ.X, TangentZ.Y, TangentZ.Z);
+
+            ObjectExporterFile::CopyVector(Vertex->Position, PositionVertexBuffer.VertexPosition(iVertex));
+            ObjectExporterFile::CopyVector(Vertex->Normal, Normal);
+            ObjectExporterFile::CopyVector2D(Vertex->UV, StaticMeshVertexBuffer.GetVertexUV(iVertex, 0));
+        }
+
+        // Index data
+        Data->Indices.Append(LODIndices);
+
+        // Section data, influences of a vertex index into the bone map of the section owning it
+        LOD.FirstSection = Data->Sections.Num();
+        LOD.NumSections = CurLOD.RenderSections.Num();
+
+        FObjectExporterSkinWeight* SkinWeights = Data->SkinWeights.GetData() + Data->SkinWeights.AddZeroed(NumVertices);
+        for (const FSkelMeshRenderSection& CurSection : CurLOD.RenderSections)
+        {
+            FObjectExporterMeshSection& Section = Data->Sections.AddZeroed_GetRef();
+            Section.FirstIndex = LOD.FirstIndex + CurSection.BaseIndex;
+            Section.NumIndices = CurSection.NumTriangles * 3;
+            Section.MinVertexIndex = CurSection.BaseVertexIndex;
+            Section.MaxVertexIndex = CurSection.BaseVertexIndex + FMath::Max<int32>(CurSection.NumVertices - 1, 0);
+            Section.MaterialIndex = CurSection.MaterialIndex;
+            Section.FirstBone = Data->BoneMap.Num();
+            Section.NumBones = CurSection.BoneMap.Num();
+
+            Data->BoneMap.Append(CurSection.BoneMap);
+
+            for (uint32 iVertex = CurSection.BaseVertexIndex; iVertex < CurSection.BaseVertexIndex + CurSection.NumVertices; iVertex++)
+            {
+                const FSkinWeightInfo& WeightInfo = WeightInfos[iVertex];
+                FObjectExporterSkinWeight& SkinWeight = SkinWeights[iVertex];
+                for (int32 iInfluence = 0; iInfluence < 4; iInfluence++)
+                {
+                    SkinWeight.BoneIndices[iInfluence] = CurSection.BoneMap[WeightInfo.InfluenceBones[iInfluence]];
+                    SkinWeight.BoneWeights[iInfluence] = WeightInfo.InfluenceWeights[iInfluence] / 255.0f;
+                }
+            }
+        }
+    }
+
+    Data->Timing.EndGather();
+
+    return Data;
+}
+
+SIZE_T FSkeletalMeshExportData::GetAllocatedSize() const
+{
+    SIZE_T Size = LODs.GetAllocatedSize() + Sections.GetAllocatedSize() + BoneMap.GetAllocatedSize() + MaterialNames.GetAllocatedSize()
+        + Vertices.GetAllocatedSize() + SkinWeights.GetAllocatedSize() + Indices.GetAllocatedSize() + MeshBoneNames.GetAllocatedSize()
+        + MeshBoneParents.GetAllocatedSize() + MeshBoneSkeletonIndices.GetAllocatedSize() + MeshRefPose.GetAllocatedSize() + MeshInverseBindMatrices.GetAllocatedSize();
+    for (const FString& BoneName : MeshBoneNames)
+    {
+        Size += BoneName.GetAllocatedSize();
+    }
+
+    return Size;
+}
+
+bool FSkeletalMeshExportData::Process()
+{
+    GenerateMeshLODs(GetAssetName(), LODGeneration, LODs, Sections, Vertices, Indices, &SkinWeights);
+
+    if (bOptimizeMesh)
+    {
+        OptimizeMeshLODs(GetAssetName(), LODs, Sections, Vertices, Indices, &SkinWeights);
+    }
+
+    BuildSectionPalettes(GetAssetName(), LODs, Sections, BoneMap, SkinWeights, Indices);
+
+    // Encode reads an inverse bind matrix per mesh bone
+    TArray<uint32> BoneOrder;
+    TArray<FObjectExporterMatrix> BindMatrices;
+    return ComputeBindMatrices(MeshBoneParents, MeshRefPose, BoneOrder, BindMatrices, MeshInverseBindMatrices);
+}
+
+void FSkeletalMeshExportData::Encode(FObjectExporterFileWriter& FileWriter) const
+{
+    FObjectExporterSkeletalMeshInfo Info;
+    Info.SkeletonName = FileWriter.AddString(SkeletonName);
+    Info.IndexSize = AddIndicesChunk(FileWriter, Indices);
+
+    FileWriter.AddSingleElementChunk(ObjectExporterChunk::Info, Info);
+    FileWriter.AddChunk(ObjectExporterChunk::LODs, LODs);
+    FileWriter.AddChunk(ObjectExporterChunk::Sections, Sections);
+    FileWriter.AddChunk(ObjectExporterChunk::BoneMap, BoneMap);
+    AddMaterialNamesChunk(FileWriter, MaterialNames);
+    ObjectExporterVertexFormat::AddVertexChunks(FileWriter, GetAssetName(), VertexFormat, Vertices, &SkinWeights);
+
+    TArray<FObjectExporterMeshBone> MeshBones;
+    MeshBones.AddZeroed(MeshBoneNames.Num());
+    for (int32 BoneIndex = 0; BoneIndex < MeshBoneNames.Num(); BoneIndex++)
+    {
+        FObjectExporterMeshBone& MeshBone = MeshBones[BoneIndex];
+        MeshBone.Name = FileWriter.AddString(MeshBoneNames[BoneIndex]);
+        MeshBone.ParentIndex = MeshBoneParents[BoneIndex];
+        MeshBone.SkeletonBoneIndex = MeshBoneSkeletonIndices[BoneIndex];
+        MeshBone.InverseBindMatrix = MeshInverseBindMatrices[BoneIndex];
+    }
+
+    FileWriter.AddChunk(ObjectExporterChunk::MeshBones, MeshBones);
+}
+
+void FSkeletalMeshExportData::EncodeJson(FObjectExporterJsonWriter& JsonWriter) const
+{
+    JsonWriter.Write(TEXT("Skeleton"), SkeletonName);
+    WriteJsonStrings(JsonWriter, TEXT("Materials"), MaterialNames);
+
+    // Reference pose of the mesh in parent space, SkeletonBone is INDEX_NONE for bones missing from the skeleton
+    JsonWriter.BeginArray(TEXT("Bones"));
+    for (int32 BoneIndex = 0; BoneIndex < MeshBoneNames.Num(); BoneIndex++)
+    {
+        JsonWriter.BeginObject();
+        JsonWriter.Write(TEXT("Name"), MeshBoneNames[BoneIndex]);
+        JsonWriter.Write(TEXT("Parent"), MeshBoneParents[BoneIndex]);
+        JsonWriter.Write(TEXT("SkeletonBone"), MeshBoneSkeletonIndices[BoneIndex]);
+        WriteJsonTransform(JsonWriter, MeshRefPose[BoneIndex]);
+        JsonWriter.EndObject();
+    }
+    JsonWriter.EndArray();
+
+    WriteJsonMeshLODs(JsonWriter, LODs, Sections, Vertices, &SkinWeights, Indices);
+}
+
+FSkeletonExportData::FSkeletonExportData(const FString& AssetName)
+    : FObjectExporterAssetData(ObjectExporterFile::Skeleton, TEXT("Skeleton"), AssetName)
+{
+
+}
+
+TSharedPtr<FSkeletonExportData, ESPMode::ThreadSafe> FSkeletonExportData::Gather(const USkeleton* Skeleton)
+{
+    if (Skeleton == nullptr)
+    {
+        return nullptr;
+    }
+
+    TSharedPtr<FSkeletonExportData, ESPMode::ThreadSafe> Data = MakeShared<FSkeletonExportData, ESPMode::ThreadSafe>(Skeleton->GetName());
+
+    const TArray<FMeshBoneInfo>& BoneInfos = Skeleton->GetReferenceSkeleton().GetRawRefBoneInfo();
+    check(BoneInfos.Num() == Skeleton->GetReferenceSkeleton().GetRawRefBonePose().Num());
+
+    Data->BoneNames.Reserve(BoneInfos.Num());
+    Data->ParentIndices.Reserve(BoneInfos.Num());
+    for (const FMeshBoneInfo& BoneInfo : BoneInfos)
+    {
+        Data->BoneNames.Add(BoneInfo.Name.ToString());
+        Data->ParentIndices.Add(BoneInfo.ParentIndex);
+    }
+    Data->RefPose = Skeleton->GetReferenceSkeleton().GetRawRefBonePose();
+
+    Data->Timing.EndGather();
+
+    return Data;
+}
+
+SIZE_T FSkeletonExportData::GetAllocatedSize() const
+{
+    SIZE_T Size = BoneNames.GetAllocatedSize() + ParentIndices.GetAllocatedSize() + RefPose.GetAllocatedSize() + BoneOrder.GetAllocatedSize()
+        + BindMatrices.GetAllocatedSize() + InverseBindMatrices.GetAllocatedSize();
+    for (const FString& BoneName : BoneNames)
+    {
+        Size += BoneName.GetAllocatedSize();
+    }
+
+    return Size;
+}
+
+bool FSkeletonExportData::Process()
+{
+    // BORD, BMAT and BINV have to hold one entry per bone
+    return ComputeBindMatrices(ParentIndices, RefPose, BoneOrder, BindMatrices, InverseBindMatrices);
+}
+
+void FSkeletonExportData::Encode(FObjectExporterFileWriter& FileWriter) const
+{
+    TArray<FObjectExporterBone> Bones;
+    Bones.AddZeroed(BoneNames.Num());
+
+    for (int32 BoneIndex = 0; BoneIndex < BoneNames.Num(); BoneIndex++)
+    {
+        const FTransform& BoneTransform = RefPose[BoneIndex];
+
+        FObjectExporterBone& Bone = Bones[BoneIndex];
+        Bone.Name = FileWriter.AddString(BoneNames[BoneIndex]);
+        Bone.ParentIndex = ParentIndices[BoneIndex];
+        ObjectExporterFile::CopyQuat(Bone.Rotation, BoneTransform.GetRotation());
+        ObjectExporterFile::CopyVector(Bone.Translation, BoneTransform.GetTranslation());
+        ObjectExporterFile::CopyVector(Bone.Scale, BoneTransform.GetScale3D());
+    }
+
+    FileWriter.AddChunk(ObjectExporterChunk::Bones, Bones);
+    FileWriter.AddChunk(ObjectExporterChunk::BoneOrder, BoneOrder);
+    FileWriter.AddChunk(ObjectExporterChunk::BindMatrices, BindMatrices);
+    FileWriter.AddChunk(ObjectExporterChunk::InverseBindMatrices, InverseBindMatrices);
+}
+
+void FSkeletonExportData::EncodeJson(FObjectExporterJsonWriter& JsonWriter) const
+{
+    JsonWriter.BeginArray(TEXT("Bones"));
+    for (int32 BoneIndex = 0; BoneIndex < BoneNames.Num(); BoneIndex++)
+    {
+        JsonWriter.BeginObject();
+        JsonWriter.Write(TEXT("Name"), BoneNames[BoneIndex]);
+        JsonWriter.Write(TEXT("Parent"), ParentIndices[BoneIndex]);
+        WriteJsonTransform(JsonWriter, RefPose[BoneIndex]);
+        JsonWriter.EndObject();
+    }
+    JsonWriter.EndArray();
+}
+
+FAnimSequenceExportData::FAnimSequenceExportData(const FString& AssetName)
+    : FObjectExporterAssetData(ObjectExporterFile::AnimSequence, TEXT("AnimSequence"), AssetName)
+    , NumFrames(0)
+    , SequenceLength(0.0f)
+{
+
+}
+
+TSharedPtr<FAnimSequenceExportData, ESPMode::ThreadSafe> FAnimSequenceExportData::Gather(const UAnimSequence* AnimSequence)
+{
+    if (AnimSequence == nullptr)
+    {
+        return nullptr;
+    }
+
+    TSharedPtr<FAnimSequenceExportData, ESPMode::ThreadSafe> Data = MakeShared<FAnimSequenceExportData, ESPMode::ThreadSafe>(AnimSequence->GetName());
+    Data->NumFrames = AnimSequence->GetNumberOfFrames();
+    Data->SequenceLength = AnimSequence->SequenceLength;
+    Data->Tracks = AnimSequence->GetRawAnimationData();
+
+    for (const FTrackToSkeletonMap& TrackToSkeleton : AnimSequence->GetRawTrackToSkeletonMapTable())
+    {
+        Data->TrackBoneIndices.Add(TrackToSkeleton.BoneTreeIndex);
+    }
+
+    const USkeleton* Skeleton = AnimSequence->GetSkeleton();
+    if (Skeleton != nullptr)
+    {
+        Data->SkeletonName = Skeleton->GetName();
+        ObjectExporterAnimCompression::BuildBoneTracks(Skeleton, Data->TrackBoneIndices, Data->BoneTracks);
+    }
+    Data->Compression = FObjectExporterAnimCompressionSettings::Get();
+
+    Data->Timing.EndGather();
+
+    return Data;
+}
+
+SIZE_T FAnimSequenceExportData::GetAllocatedSize() const
+{
+    SIZE_T Size = SkeletonName.GetAllocatedSize() + TrackBoneIndices.GetAllocatedSize() + Tracks.GetAllocatedSize() + BoneTracks.GetAllocatedSize();
+    for (const FRawAnimSequenceTrack& Track : Tracks)
+    {
+        Size += Track.PosKeys.GetAllocatedSize() + Track.RotKeys.GetAllocatedSize() + Track.ScaleKeys.GetAllocatedSize();
+    }
+
+    return Size + CompressedData.GetAllocatedSize() + FrameMajorData.GetAllocatedSize();
+}
+
+bool FAnimSequenceExportData::Process()
+{
+    if (Compression.bFrameMajor)
+    {
+        ObjectExporterAnimCompression::BuildFrameMajorTracks(Tracks, TrackBoneIndices, NumFrames, Compression, FrameMajorData);
+
+        UE_LOG(ObjectExporterAssetDataLog, Log, TEXT("Frame major %s: %d tracks, %u rotation, %u translation and %u scale lanes, %u bytes per frame."),
+            *GetAssetName(), Tracks.Num(), FrameMajorData.Layout.NumRotationLanes, FrameMajorData.Layout.NumTranslationLanes,
+            FrameMajorData.Layout.NumScaleLanes, FrameMajorData.Layout.FrameStride * (uint32)sizeof(float));
+        return true;
+    }
+
+    if (!Compression.bCompress)
+    {
+        return true;
+    }
+
+    if (!ObjectExporterAnimCompression::CompressTracks(Tracks, TrackBoneIndices, NumFrames, Compression, CompressedData))
+    {
+        UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("Compress %s: %d frames do not fit 16 bit frame indices, keys are written raw."), *GetAssetName(), NumFrames);
+        CompressedData = FObjectExporterCompressedAnimData();
+        return true;
+    }
+
+    int32 RawSize = 0;
+    for (const FRawAnimSequenceTrack& Track : Tracks)
+    {
+        RawSize += sizeof(FObjectExporterAnimTrack) + Track.PosKeys.Num() * sizeof(FVector) + Track.RotKeys.Num() * sizeof(FQuat) + Track.ScaleKeys.Num() * sizeof(FVector);
+    }
+
+    const int32 CompressedSize = CompressedData.Tracks.Num() * sizeof(FObjectExporterCompressedAnimTrack) + CompressedData.KeyFrames.Num() * sizeof(uint16)
+        + (CompressedData.PositionKeys.Num() + CompressedData.RotationKeys.Num() + CompressedData.ScaleKeys.Num()) * sizeof(uint16);
+
+    UE_LOG(ObjectExporterAssetDataLog, Log, TEXT("Compress %s: %d tracks, %d -> %d bytes, max error translation %f, rotation %f, scale %f."),
+        *GetAssetName(), Tracks.Num(), RawSize, CompressedSize, CompressedData.MaxPositionError, CompressedData.MaxRotationError, CompressedData.MaxScaleError);
+
+    return true;
+}
+
+void FAnimSequenceExportData::Encode(FObjectExporterFileWriter& FileWriter) const
+{
+    FObjectExporterAnimSequenceInfo Info;
+    Info.NumFrames = NumFrames;
+    Info.SequenceLength = SequenceLength;
+    Info.Encoding = FrameMajorData.Tracks.Num() > 0 ? EObjectExporterAnimEncoding::FrameMajor
+        : CompressedData.Tracks.Num() > 0 ? EObjectExporterAnimEncoding::Compressed : EObjectExporterAnimEncoding::Raw;
+    Info.SkeletonName = FileWriter.AddString(SkeletonName);
+    Info.NumTracks = Tracks.Num();
+    Info.NumBones = BoneTracks.Num();
+
+    FileWriter.AddSingleElementChunk(ObjectExporterChunk::Info, Info);
+    FileWriter.AddChunk(ObjectExporterChunk::BoneTracks, BoneTracks);
+
+    if (Info.Encoding == EObjectExporterAnimEncoding::FrameMajor)
+    {
+        FileWriter.AddSingleElementChunk(ObjectExporterChunk::FrameLayout, FrameMajorData.Layout);
+        FileWriter.AddChunk(ObjectExporterChunk::FrameTracks, FrameMajorData.Tracks);
+
+        // One element per frame
+        FileWriter.AddChunk(ObjectExporterChunk::FrameKeys, FrameMajorData.Layout.FrameStride * sizeof(float)).Append(
+            reinterpret_cast<const uint8*>(FrameMajorData.Keys.GetData()), FrameMajorData.Keys.Num() * sizeof(float));
+
+        return;
+    }
+
+    if (Info.Encoding == EObjectExporterAnimEncoding::Compressed)
+    {
+        FileWriter.AddChunk(ObjectExporterChunk::CompressedTracks, CompressedData.Tracks);
+        FileWriter.AddChunk(ObjectExporterChunk::KeyFrames, CompressedData.KeyFrames);
+
+        // Keys are uint16[3] records
+        FileWriter.AddChunk(ObjectExporterChunk::QuantizedPositionKeys, 3 * sizeof(uint16)).Append(
+            reinterpret_cast<const uint8*>(CompressedData.PositionKeys.GetData()), CompressedData.PositionKeys.Num() * sizeof(uint16));
+        FileWriter.AddChunk(ObjectExporterChunk::QuantizedRotationKeys, 3 * sizeof(uint16)).Append(
+            reinterpret_cast<const uint8*>(CompressedData.RotationKeys.GetData()), CompressedData.RotationKeys.Num() * sizeof(uint16));
+        FileWriter.AddChunk(ObjectExporterChunk::QuantizedScaleKeys, 3 * sizeof(uint16)).Append(
+            reinterpret_cast<const uint8*>(CompressedData.ScaleKeys.GetData()), CompressedData.ScaleKeys.Num() * sizeof(uint16));
+
+        return;
+    }
+
+    TArray<uint8>& PositionKeys = FileWriter.AddChunk(ObjectExporterChunk::PositionKeys, sizeof(FVector));
+    TArray<uint8>& RotationKeys = FileWriter.AddChunk(ObjectExporterChunk::RotationKeys, sizeof(FQuat));
+    TArray<uint8>& ScaleKeys = FileWriter.AddChunk(ObjectExporterChunk::ScaleKeys, sizeof(FVector));
+
+    TArray<FObjectExporterAnimTrack> TrackTable;
+    TrackTable.AddZeroed(Tracks.Num());
+
+    for (int32 TrackIndex = 0; TrackIndex < Tracks.Num(); TrackIndex++)
+    {
+        const FRawAnimSequenceTrack& SequenceTrack = Tracks[TrackIndex];
+
+        FObjectExporterAnimTrack& Track = TrackTable[TrackIndex];
+        Track.BoneIndex = TrackBoneIndices[TrackIndex];
+        Track.FirstPositionKey = PositionKeys.Num() / sizeof(FVector);
+        Track.NumPositionKeys = SequenceTrack.PosKeys.Num();
+        Track.FirstRotationKey = RotationKeys.Num() / sizeof(FQuat);
+        Track.NumRotationKeys = SequenceTrack.RotKeys.Num();
+        Track.FirstScaleKey = ScaleKeys.Num() / sizeof(FVector);
+        Track.NumScaleKeys = SequenceTrack.ScaleKeys.Num();
+
+        PositionKeys.Append(reinterpret_cast<const uint8*>(SequenceTrack.PosKeys.GetData()), SequenceTrack.PosKeys.Num() * sizeof(FVector));
+        RotationKeys.Append(reinterpret_cast<const uint8*>(SequenceTrack.RotKeys.GetData()), SequenceTrack.RotKeys.Num() * sizeof(FQuat));
+        ScaleKeys.Append(reinterpret_cast<const uint8*>(SequenceTrack.ScaleKeys.GetData()), SequenceTrack.ScaleKeys.Num() * sizeof(FVector));
+    }
+
+    FileWriter.AddChunk(ObjectExporterChunk::Tracks, TrackTable);
+}
+
+void FAnimSequenceExportData::EncodeJson(FObjectExporterJsonWriter& JsonWriter) const
+{
+    JsonWriter.Write(TEXT("Skeleton"), SkeletonName);
+    JsonWriter.Write(TEXT("FrameCount"), NumFrames);
+    JsonWriter.Write(TEXT("SequenceLength"), SequenceLength);
+
+    // Raw keys, one per frame or a single one for constant channels
+    JsonWriter.BeginArray(TEXT("Tracks"));
+    for (int32 TrackIndex = 0; TrackIndex < Tracks.Num(); TrackIndex++)
+    {
+        const FRawAnimSequenceTrack& Track = Tracks[TrackIndex];
+
+        JsonWriter.BeginObject();
+        JsonWriter.Write(TEXT("BoneIndex"), TrackBoneIndices[TrackIndex]);
+
+        // Channels without keys are left out
+        if (Track.PosKeys.Num() > 0)
+        {
+            JsonWriter.WriteArray(TEXT("PositionKeys"), &Track.PosKeys.GetData()->X, Track.PosKeys.Num(), 3, sizeof(FVector) / sizeof(float));
+        }
+        if (Track.RotKeys.Num() > 0)
+        {
+            JsonWriter.WriteArray(TEXT("RotationKeys"), &Track.RotKeys.GetData()->X, Track.RotKeys.Num(), 4, sizeof(FQuat) / sizeof(float));
+        }
+        if (Track.ScaleKeys.Num() > 0)
+        {
+            JsonWriter.WriteArray(TEXT("ScaleKeys"), &Track.ScaleKeys.GetData()->X, Track.ScaleKeys.Num(), 3, sizeof(FVector) / sizeof(float));
+        }
+        JsonWriter.EndObject();
+    }
+    JsonWriter.EndArray();
+}
+
+FMaterialExportData::FMaterialExportData(const FString& AssetName)
+    : FObjectExporterAssetData(ObjectExporterFile::Material, TEXT("Material"), AssetName)
+    , BlendMode(0)
+{
+
+}
+
+TSharedPtr<FMaterialExportData, ESPMode::ThreadSafe> FMaterialExportData::Gather(const UMaterialInstance* MaterialInstance, TArray<UTexture*>& OutTextures)
+{
+    if (MaterialInstance == nullptr)
+    {
+        return nullptr;
+    }
+
+    TSharedPtr<FMaterialExportData, ESPMode::ThreadSafe> Data = MakeShared<FMaterialExportData, ESPMode::ThreadSafe>(MaterialInstance->GetName());
+    Data->BlendMode = (int32)MaterialInstance->BlendMode;
+    Data->BaseMaterialName = GetResourceName(MaterialInstance->GetMaterial());
+
+    TArray<FMaterialParameterInfo> OutTextureParameterInfo;
+    TArray<FGuid> GuidsTexture;
+    MaterialInstance->GetAllTextureParameterInfo(OutTextureParameterInfo, GuidsTexture);
+    for (const FMaterialParameterInfo& ParameterInfo : OutTextureParameterInfo)
+    {
+        UTexture* Texture = nullptr;
+        MaterialInstance->GetTextureParameterValue(ParameterInfo, Texture);
+
+        if (Texture != nullptr)
+        {
+            Data->TextureParameterNames.Add(ParameterInfo.Name.ToString());
+            Data->TextureNames.Add(GetResourceName(Texture));
+            OutTextures.Add(Texture);
+        }
+    }
+
+    TArray<FMaterialParameterInfo> OutScalarParameterInfo;
+    TArray<FGuid> GuidsScalar;
+    MaterialInstance->GetAllScalarParameterInfo(OutScalarParameterInfo, GuidsScalar);
+    for (const FMaterialParameterInfo& ParameterInfo : OutScalarParameterInfo)
+    {
+        float Value = 0.0f;
+        if (MaterialInstance->GetScalarParameterValue(ParameterInfo, Value))
+        {
+            Data->ScalarParameterNames.Add(ParameterInfo.Name.ToString());
+            Data->Scalars.Add(Value);
+        }
+    }
+
+    TArray<FMaterialParameterInfo> OutVectorParameterInfo;
+    TArray<FGuid> GuidsVector;
+    MaterialInstance->GetAllVectorParameterInfo(OutVectorParameterInfo, GuidsVector);
+    for (const FMaterialParameterInfo& ParameterInfo : OutVectorParameterInfo)
+    {
+        FLinearColor Value = FLinearColor::Black;
+        if (MaterialInstance->GetVectorParameterValue(ParameterInfo, Value))
+        {
+            Data->VectorParameterNames.Add(ParameterInfo.Name.ToString());
+            Data->Vectors.Add(Value);
+        }
+    }
+
+    Data->Timing.EndGather();
+
+    return Data;
+}
+
+SIZE_T FMaterialExportData::GetAllocatedSize() const
+{
+    SIZE_T Size = TextureParameterNames.GetAllocatedSize() + TextureNames.GetAllocatedSize() + ScalarParameterNames.GetAllocatedSize()
+        + Scalars.GetAllocatedSize() + VectorParameterNames.GetAllocatedSize() + Vectors.GetAllocatedSize();
+    for (const TArray<FString>* Names : { &TextureParameterNames, &TextureNames, &ScalarParameterNames, &VectorParameterNames })
+    {
+        for (const FString& Name : *Names)
+        {
+            Size += Name.GetAllocatedSize();
+        }
+    }
+
+    return Size;
+}
+
+void FMaterialExportData::Encode(FObjectExporterFileWriter& FileWriter) const
+{
+    TArray<FObjectExporterMaterialParameter> Parameters;
+    auto AddParameter = [&FileWriter, &Parameters](const FString& Name, EObjectExporterMaterialParameterType Type, int32 Offset, int32 TextureSlot)
+    {
+        FObjectExporterMaterialParameter& Parameter = Parameters.AddZeroed_GetRef();
+        Parameter.NameHash = ObjectExporterFile::HashName(Name);
+        Parameter.Name = FileWriter.AddString(Name);
+        Parameter.Type = Type;
+        Parameter.Offset = Offset;
+        Parameter.TextureSlot = TextureSlot;
+    };
+
+    // std140: every vector in its own 16 byte slot, then the scalars tightly packed
+    TArray<float> ConstantBlock;
+    for (int32 VectorIndex = 0; VectorIndex < Vectors.Num(); VectorIndex++)
+    {
+        AddParameter(VectorParameterNames[VectorIndex], EObjectExporterMaterialParameterType::Vector, ConstantBlock.Num() * sizeof(float), INDEX_NONE);
+        ObjectExporterFile::CopyColor(&ConstantBlock[ConstantBlock.AddUninitialized(4)], Vectors[VectorIndex]);
+    }
+
+    for (int32 ScalarIndex = 0; ScalarIndex < Scalars.Num(); ScalarIndex++)
+    {
+        AddParameter(ScalarParameterNames[ScalarIndex], EObjectExporterMaterialParameterType::Scalar, ConstantBlock.Num() * sizeof(float), INDEX_NONE);
+        ConstantBlock.Add(Scalars[ScalarIndex]);
+    }
+    ConstantBlock.AddZeroed(Align(ConstantBlock.Num(), 4) - ConstantBlock.Num());
+
+    TArray<uint32> TextureNameOffsets;
+    for (int32 TextureSlot = 0; TextureSlot < TextureNames.Num(); TextureSlot++)
+    {
+        AddParameter(TextureParameterNames[TextureSlot], EObjectExporterMaterialParameterType::Texture, INDEX_NONE, TextureSlot);
+        TextureNameOffsets.Add(FileWriter.AddString(TextureNames[TextureSlot]));
+    }
+
+    Parameters.StableSort([](const FObjectExporterMaterialParameter& A, const FObjectExporterMaterialParameter& B)
+    {
+        return A.NameHash < B.NameHash;
+    });
+
+    for (int32 ParameterIndex = 1; ParameterIndex < Parameters.Num(); ParameterIndex++)
+    {
+        if (Parameters[ParameterIndex].NameHash == Parameters[ParameterIndex - 1].NameHash)
+        {
+            UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("Material %s: two parameters have the name hash %08x, the runtime can only bind one of them."), *GetAssetName(), Parameters[ParameterIndex].NameHash);
+        }
+    }
+
+    FObjectExporterMaterialInfo Info;
+    Info.BlendMode = BlendMode;
+    Info.SortKey = ((uint32)BlendMode << 28) | (ObjectExporterFile::HashName(BaseMaterialName) & 0x0FFFFFFFu);
+    Info.BaseMaterialName = FileWriter.AddString(BaseMaterialName);
+    Info.ConstantBlockSize = ConstantBlock.Num() * sizeof(float);
+
+    FileWriter.AddSingleElementChunk(ObjectExporterChunk::Info, Info);
+    FileWriter.AddChunk(ObjectExporterChunk::Textures, TextureNameOffsets);
+    FileWriter.AddChunk(ObjectExporterChunk::MaterialParameters, Parameters);
+    FileWriter.AddChunk(ObjectExporterChunk::ConstantBlock, ConstantBlock);
+}
+
+void FMaterialExportData::EncodeJson(FObjectExporterJsonWriter& JsonWriter) const
+{
+    JsonWriter.Write(TEXT("BlendMode"), BlendMode);
+    JsonWriter.Write(TEXT("BaseMaterial"), BaseMaterialName);
+
+    JsonWriter.BeginArray(TEXT("Textures"));
+    for (int32 TextureSlot = 0; TextureSlot < TextureNames.Num(); TextureSlot++)
+    {
+        JsonWriter.BeginObject();
+        JsonWriter.Write(TEXT("Parameter"), TextureParameterNames[TextureSlot]);
+        JsonWriter.Write(TEXT("Texture"), TextureNames[TextureSlot]);
+        JsonWriter.EndObject();
+    }
+    JsonWriter.EndArray();
+
+    JsonWriter.BeginArray(TEXT("Scalars"));
+    for (int32 ScalarIndex = 0; ScalarIndex < Scalars.Num(); ScalarIndex++)
+    {
+        JsonWriter.BeginObject();
+        JsonWriter.Write(TEXT("Parameter"), ScalarParameterNames[ScalarIndex]);
+        JsonWriter.Write(TEXT("Value"), Scalars[ScalarIndex]);
+        JsonWriter.EndObject();
+    }
+    JsonWriter.EndArray();
+
+    JsonWriter.BeginArray(TEXT("Vectors"));
+    for (int32 VectorIndex = 0; VectorIndex < Vectors.Num(); VectorIndex++)
+    {
+        float Value[4];
+        ObjectExporterFile::CopyColor(Value, Vectors[VectorIndex]);
+
+        JsonWriter.BeginObject();
+        JsonWriter.Write(TEXT("Parameter"), VectorParameterNames[VectorIndex]);
+        JsonWriter.WriteArray(TEXT("Value"), Value, 4);
+        JsonWriter.EndObject();
+    }
+    JsonWriter.EndArray();
+}
+
+FTextureExportData::FTextureExportData(const FString& AssetName)
+    : FObjectExporterAssetData(ObjectExporterFile::Texture, TEXT("Texture"), AssetName)
+    , Info()
+    , ResidentMipSize(0)
+{
+
+}
+
+static EObjectExporterTextureFormat GetTextureFormat(EPixelFormat PixelFormat)
+{
+    switch (PixelFormat)
+    {
+    case PF_R8G8B8A8: return EObjectExporterTextureFormat::RGBA8;
+    case PF_B8G8R8A8: return EObjectExporterTextureFormat::BGRA8;
+    case PF_G8: return EObjectExporterTextureFormat::R8;
+    case PF_FloatRGBA: return EObjectExporterTextureFormat::RGBA16F;
+    case PF_DXT1: return EObjectExporterTextureFormat::BC1;
+    case PF_DXT5: return EObjectExporterTextureFormat::BC3;
+    case PF_BC4: return EObjectExporterTextureFormat::BC4;
+    case PF_BC5: return EObjectExporterTextureFormat::BC5;
+    case PF_BC6H: return EObjectExporterTextureFormat::BC6H;
+    case PF_BC7: return EObjectExporterTextureFormat::BC7;
+    case PF_ETC2_RGB: return EObjectExporterTextureFormat::ETC2_RGB;
+    case PF_ETC2_RGBA: return EObjectExporterTextureFormat::ETC2_RGBA;
+    case PF_ASTC_4x4: return EObjectExporterTextureFormat::ASTC_4x4;
+    case PF_ASTC_6x6: return EObjectExporterTextureFormat::ASTC_6x6;
+    case PF_ASTC_8x8: return EObjectExporterTextureFormat::ASTC_8x8;
+    case PF_ASTC_10x10: return EObjectExporterTextureFormat::ASTC_10x10;
+    case PF_ASTC_12x12: return EObjectExporterTextureFormat::ASTC_12x12;
+    default: return EObjectExporterTextureFormat::Unknown;
+    }
+}
+
+const ITargetPlatform* FTextureExportData::GetTargetPlatform()
+{
+    ITargetPlatformManagerModule& TargetPlatformManager = GetTargetPlatformManagerRef();
+
+    const FString PlatformName = CVarObjectExporterTextureTargetPlatform.GetValueOnGameThread();
+    if (!PlatformName.IsEmpty())
+    {
+        if (const ITargetPlatform* TargetPlatform = TargetPlatformManager.FindTargetPlatform(PlatformName))
+        {
+            return TargetPlatform;
+        }
+
+        UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("ObjectExporter.TextureTargetPlatform: unknown platform %s, textures are exported for the editor platform."), *PlatformName);
+    }
+
+    return TargetPlatformManager.GetRunningTargetPlatform();
+}
+
+FTextureExportData::FCacheRequest FTextureExportData::BeginCache(UTexture* Texture, const ITargetPlatform* TargetPlatform)
+{
+    FCacheRequest Request;
+
+    TMap<FString, FTexturePlatformData*>* CookedPlatformData = Texture != nullptr ? Texture->GetCookedPlatformData() : nullptr;
+    if (CookedPlatformData == nullptr || TargetPlatform == nullptr)
+    {
+        return Request;
+    }
+
+    // Cooked data keeps every mip inline, unlike the editor's own platform data whose streamed mips stay in the DDC.
+    // Data cached for the platform alone, e.g. by an earlier export, is used as is.
+    if (CookedPlatformData->Num() == 1 && Texture->IsCachedCookedPlatformDataLoaded(TargetPlatform))
+    {
+        Request.DerivedDataKey = CookedPlatformData->CreateConstIterator().Key();
+
+        return Request;
+    }
+
+    // The engine does not expose the derived data key of a platform, so the build starts on an empty map whose only
+    // entry is then the platform's. Data cached for other platforms or by the cooker is set aside and left untouched.
+    TMap<FString, FTexturePlatformData*> OtherPlatformData = MoveTemp(*CookedPlatformData);
+    CookedPlatformData->Reset();
+
+    Texture->BeginCacheForCookedPlatformData(TargetPlatform);
+
+    if (CookedPlatformData->Num() == 1)
+    {
+        Request.DerivedDataKey = CookedPlatformData->CreateConstIterator().Key();
+        Request.bOwnsPlatformData = !OtherPlatformData.Contains(Request.DerivedDataKey);
+    }
+
+    // Layered textures, or data that was already cached or in flight for the platform: the new build is dropped
+    if (!Request.bOwnsPlatformData)
+    {
+        Texture->ClearCachedCookedPlatformData(TargetPlatform);
+    }
+
+    CookedPlatformData->Append(MoveTemp(OtherPlatformData));
+
+    return Request;
+}
+
+TSharedPtr<FTextureExportData, ESPMode::ThreadSafe> FTextureExportData::Gather(UTexture* Texture, const ITargetPlatform* TargetPlatform, const FCacheRequest& Request)
+{
+    if (Texture == nullptr || TargetPlatform == nullptr)
+    {
+        return nullptr;
+    }
+
+    const FString AssetName = GetResourceName(Texture);
+    if (!Texture->IsA<UTexture2D>())
+    {
+        UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("Texture %s: only 2D textures are exported."), *AssetName);
+
+        return nullptr;
+    }
+
+    if (Request.DerivedDataKey.IsEmpty())
+    {
+        UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("Texture %s: no single layer platform data for %s."), *AssetName, *TargetPlatform->PlatformName());
+
+        return nullptr;
+    }
+
+    // The texture compressors run on the thread pool, they never wait on the game thread
+    const double WaitStartTime = FPlatformTime::Seconds();
+    while (!Texture->IsCachedCookedPlatformDataLoaded(TargetPlatform))
+    {
+        if (FPlatformTime::Seconds() - WaitStartTime > TEXTURE_CACHE_TIMEOUT)
+        {
+            // The build is left to the texture, releasing it would wait for it as well
+            UE_LOG(ObjectExporterAssetDataLog, Error, TEXT("Texture %s: platform data for %s not built after %d s."), *AssetName, *TargetPlatform->PlatformName(), TEXTURE_CACHE_TIMEOUT);
+
+            return nullptr;
+        }
+
+        FPlatformProcess::Sleep(0.001f);
+    }
+
+    TMap<FString, FTexturePlatformData*>* CookedPlatformData = Texture->GetCookedPlatformData();
+    FTexturePlatformData* PlatformData = CookedPlatformData != nullptr ? CookedPlatformData->FindRef(Request.DerivedDataKey) : nullptr;
+
+    TSharedPtr<FTextureExportData, ESPMode::ThreadSafe> Data = MakeShared<FTextureExportData, ESPMode::ThreadSafe>(AssetName);
+    Data->ResidentMipSize = FMath::Max(CVarObjectExporterTextureResidentMipSize.GetValueOnGameThread(), 0);
+
+    bool bValid = PlatformData != nullptr && PlatformData->VTData == nullptr && PlatformData->Mips.Num() > 0;
+    if (!bValid)
+    {
+        UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("Texture %s: no single layer, non virtual platform data for %s."), *AssetName, *TargetPlatform->PlatformName());
+    }
+
+    if (bValid)
+    {
+        const FPixelFormatInfo& FormatInfo = GPixelFormats[PlatformData->PixelFormat];
+
+        FObjectExporterTextureInfo& Info = Data->Info;
+        Info.Format = GetTextureFormat(PlatformData->PixelFormat);
+        Info.Width = PlatformData->SizeX;
+        Info.Height = PlatformData->SizeY;
+        Info.NumMips = PlatformData->Mips.Num();
+        Info.BlockSizeX = FormatInfo.BlockSizeX;
+        Info.BlockSizeY = FormatInfo.BlockSizeY;
+        Info.BytesPerBlock = FormatInfo.BlockBytes;
+        Info.Flags = Texture->SRGB ? OBJECT_EXPORTER_TEXTURE_FLAG_SRGB : 0;
+
+        if (Info.Format == EObjectExporterTextureFormat::Unknown)
+        {
+            UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("Texture %s: pixel format %s is not exported."), *AssetName, FormatInfo.Name);
+            bValid = false;
+        }
+
+        for (int32 MipIndex = 0; bValid && MipIndex < PlatformData->Mips.Num(); MipIndex++)
+        {
+            FTexture2DMipMap& SourceMip = PlatformData->Mips[MipIndex];
+
+            FObjectExporterTextureMip& Mip = Data->Mips.AddZeroed_GetRef();
+            Mip.Width = SourceMip.SizeX;
+            Mip.Height = SourceMip.SizeY;
+            Mip.DataOffset = Align(Data->MipData.Num(), OBJECT_EXPORTER_CHUNK_ALIGNMENT);
+            Mip.DataSize = FMath::DivideAndRoundUp(Mip.Width, Info.BlockSizeX) * FMath::DivideAndRoundUp(Mip.Height, Info.BlockSizeY) * Info.BytesPerBlock;
+
+            // Anything but tightly packed blocks (packed mip tails, row padding) would be misread by the runtime
+            if (SourceMip.BulkData.GetBulkDataSize() != Mip.DataSize)
+            {
+                UE_LOG(ObjectExporterAssetDataLog, Warning, TEXT("Texture %s: mip %d holds %lld bytes, %u expected."), *AssetName, MipIndex, SourceMip.BulkData.GetBulkDataSize(), Mip.DataSize);
+                bValid = false;
+                break;
+            }
+
+            Data->MipData.AddZeroed(Mip.DataOffset + Mip.DataSize - Data->MipData.Num());
+            FMemory::Memcpy(&Data->MipData[Mip.DataOffset], SourceMip.BulkData.LockReadOnly(), Mip.DataSize);
+            SourceMip.BulkData.Unlock();
+        }
+    }
+
+    // Data cached by someone else, such as the cooker, stays
+    if (Request.bOwnsPlatformData)
+    {
+        Texture->ClearCachedCookedPlatformData(TargetPlatform);
+    }
+
+    if (!bValid)
+    {
+        return nullptr;
+    }
+
+    Data->Timing.EndGather();
+
+    return Data;
+}
+
+SIZE_T FTextureExportData::GetAllocatedSize() const
+{
+    return Mips.GetAllocatedSize() + MipData.GetAllocatedSize() + ResidentMipData.GetAllocatedSize() + StreamedMipData.GetAllocatedSize();
+}
+
+bool FTextureExportData::Process()
+{
+    // The smallest mip always stays resident, even for textures without a mip chain
+    Info.FirstResidentMip = 0;
+    while (ResidentMipSize > 0 && Info.FirstResidentMip + 1 < Info.NumMips
+        && FMath::Max(Mips[Info.FirstResidentMip].Width, Mips[Info.FirstResidentMip].Height) > (uint32)ResidentMipSize)
+    {
+        Info.FirstResidentMip++;
+    }
+
+    for (uint32 MipIndex = 0; MipIndex < Info.NumMips; MipIndex++)
+    {
+        FObjectExporterTextureMip& Mip = Mips[MipIndex];
+
+        const bool bStreamed = MipIndex < Info.FirstResidentMip;
+        TArray<uint8>& Dest = bStreamed ? StreamedMipData : ResidentMipData;
+        const uint32 DestOffset = Align(Dest.Num(), bStreamed ? OBJECT_EXPORTER_TEXTURE_STREAMING_ALIGNMENT : OBJECT_EXPORTER_CHUNK_ALIGNMENT);
+
+        Dest.AddZeroed(DestOffset + Mip.DataSize - Dest.Num());
+        FMemory::Memcpy(&Dest[DestOffset], &MipData[Mip.DataOffset], Mip.DataSize);
+        Mip.DataOffset = DestOffset;
+    }
+
+    MipData.Empty();
+
+    return true;
+}
+
+void FTextureExportData::Encode(FObjectExporterFileWriter& FileWriter) const
+{
+    FileWriter.AddSingleElementChunk(ObjectExporterChunk::Info, Info);
+    FileWriter.AddChunk(ObjectExporterChunk::TextureMips, Mips);
+    FileWriter.AddChunk(ObjectExporterChunk::TextureData, ResidentMipData);
+
+    if (StreamedMipData.Num() > 0)
+    {
+        FileWriter.AddChunk(ObjectExporterChunk::StreamedTextureData, StreamedMipData, OBJECT_EXPORTER_TEXTURE_STREAMING_ALIGNMENT);
+    }
+}
+
+void FTextureExportData::EncodeJson(FObjectExporterJsonWriter& JsonWriter) const
+{
+    // Layout only, the blocks are of no use as text
+    JsonWriter.Write(TEXT("Format"), (uint32)Info.Format);
+    JsonWriter.Write(TEXT("Width"), Info.Width);
+    JsonWriter.Write(TEXT("Height"), Info.Height);
+    JsonWriter.Write(TEXT("BlockSizeX"), Info.BlockSizeX);
+    JsonWriter.Write(TEXT("BlockSizeY"), Info.BlockSizeY);
+    JsonWriter.Write(TEXT("BytesPerBlock"), Info.BytesPerBlock);
+    JsonWriter.Write(TEXT("SRGB"), (Info.Flags & OBJECT_EXPORTER_TEXTURE_FLAG_SRGB) != 0);
+
+    JsonWriter.BeginArray(TEXT("Mips"));
+    for (const FObjectExporterTextureMip& Mip : Mips)
+    {
+        JsonWriter.BeginObject();
+        JsonWriter.Write(TEXT("Width"), Mip.Width);
+        JsonWriter.Write(TEXT("Height"), Mip.Height);
+        JsonWriter.Write(TEXT("Size"), Mip.DataSize);
+        JsonWriter.EndObject();
+    }
+    JsonWriter.EndArray();
+}
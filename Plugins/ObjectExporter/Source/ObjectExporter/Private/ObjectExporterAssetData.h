@@ -0,0 +1,266 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimSequence.h"
+#include "ObjectExporterAnimCompression.h"
+#include "ObjectExporterFileFormat.h"
+#include "ObjectExporterMeshlet.h"
+#include "ObjectExporterMeshSimplifier.h"
+#include "ObjectExporterStats.h"
+#include "ObjectExporterVertexFormat.h"
+
+class FObjectExporterFileWriter;
+class FObjectExporterJsonWriter;
+class UStaticMesh;
+class USkeletalMesh;
+class USkeleton;
+class UAnimSequence;
+class UMaterialInstance;
+class UTexture;
+class ITargetPlatform;
+
+/*
+*   Snapshot of an asset, taken on the game thread by the Gather functions.
+*   A snapshot holds no UObject references, so Save may run on any thread. It is saved once, by one thread,
+*   which also runs the expensive export time processing in Process before encoding.
+*/
+class FObjectExporterAssetData
+{
+public:
+    FObjectExporterAssetData(uint32 InFileType, const TCHAR* AssetType, const FString& AssetName);
+    virtual ~FObjectExporterAssetData() {}
+
+    /** Encodes the snapshot and writes it to FullFilePathName. Thread safe. */
+    bool Save(const FString& FullFilePathName);
+
+    /**
+    *   Writes the snapshot as JSON to FullFilePathName, streamed through a fixed size buffer. Thread safe.
+    *   JSON holds the gathered data as is, the export time processing of Process only applies to binary files.
+    */
+    bool SaveJson(const FString& FullFilePathName);
+
+    /** Memory held by the snapshot, used to bound the number of snapshots in flight. */
+    virtual SIZE_T GetAllocatedSize() const = 0;
+
+    const FString& GetAssetName() const
+    {
+        return Timing.AssetName;
+    }
+
+protected:
+    /**
+    *   Export time processing of the gathered data (mesh optimization, compression...), runs on the saving thread.
+    *   Returns false if the snapshot cannot be encoded, Save then fails without writing the file.
+    */
+    virtual bool Process()
+    {
+        return true;
+    }
+
+    virtual void Encode(FObjectExporterFileWriter& FileWriter) const = 0;
+
+    /** Writes the members of the root JSON object. */
+    virtual void EncodeJson(FObjectExporterJsonWriter& JsonWriter) const = 0;
+
+    uint32 FileType;
+    FObjectExporterAssetTiming Timing;
+};
+
+typedef TSharedPtr<FObjectExporterAssetData, ESPMode::ThreadSafe> FObjectExporterAssetDataPtr;
+
+class FStaticMeshExportData : public FObjectExporterAssetData
+{
+public:
+    static TSharedPtr<FStaticMeshExportData, ESPMode::ThreadSafe> Gather(const UStaticMesh* StaticMesh);
+
+    explicit FStaticMeshExportData(const FString& AssetName);
+
+    virtual SIZE_T GetAllocatedSize() const override;
+
+    TArray<FObjectExporterMeshLOD> LODs;
+    TArray<FObjectExporterMeshSection> Sections;
+    TArray<FString> MaterialNames;
+    TArray<FObjectExporterMeshVertex> Vertices;
+    TArray<uint32> Indices;
+    FObjectExporterMeshletData Meshlets;
+
+    /** ObjectExporter.OptimizeMeshes when gathered. */
+    bool bOptimizeMesh;
+
+    /** ObjectExporter.GenerateMeshlets when gathered. */
+    bool bGenerateMeshlets;
+
+    FObjectExporterVertexFormatSettings VertexFormat;
+    FObjectExporterLODGenerationSettings LODGeneration;
+
+protected:
+    virtual bool Process() override;
+    virtual void Encode(FObjectExporterFileWriter& FileWriter) const override;
+    virtual void EncodeJson(FObjectExporterJsonWriter& JsonWriter) const override;
+};
+
+class FSkeletalMeshExportData : public FObjectExporterAssetData
+{
+public:
+    static TSharedPtr<FSkeletalMeshExportData, ESPMode::ThreadSafe> Gather(const USkeletalMesh* SkeletalMesh);
+
+    explicit FSkeletalMeshExportData(const FString& AssetName);
+
+    virtual SIZE_T GetAllocatedSize() const override;
+
+    FString SkeletonName;
+    TArray<FObjectExporterMeshLOD> LODs;
+    TArray<FObjectExporterMeshSection> Sections;
+    TArray<FBoneIndexType> BoneMap;
+    TArray<FString> MaterialNames;
+    TArray<FObjectExporterMeshVertex> Vertices;
+    TArray<FObjectExporterSkinWeight> SkinWeights;
+    TArray<uint32> Indices;
+
+    TArray<FString> MeshBoneNames;
+    TArray<int32> MeshBoneParents;
+    TArray<int32> MeshBoneSkeletonIndices;
+    TArray<FTransform> MeshRefPose;
+    TArray<FObjectExporterMatrix> MeshInverseBindMatrices;
+
+    /** ObjectExporter.OptimizeMeshes when gathered. */
+    bool bOptimizeMesh;
+
+    FObjectExporterVertexFormatSettings VertexFormat;
+    FObjectExporterLODGenerationSettings LODGeneration;
+
+protected:
+    virtual bool Process() override;
+    virtual void Encode(FObjectExporterFileWriter& FileWriter) const override;
+    virtual void EncodeJson(FObjectExporterJsonWriter& JsonWriter) const override;
+};
+
+class FSkeletonExportData : public FObjectExporterAssetData
+{
+public:
+    static TSharedPtr<FSkeletonExportData, ESPMode::ThreadSafe> Gather(const USkeleton* Skeleton);
+
+    explicit FSkeletonExportData(const FString& AssetName);
+
+    virtual SIZE_T GetAllocatedSize() const override;
+
+    TArray<FString> BoneNames;
+    TArray<int32> ParentIndices;
+    TArray<FTransform> RefPose;
+
+    TArray<uint32> BoneOrder;
+    TArray<FObjectExporterMatrix> BindMatrices;
+    TArray<FObjectExporterMatrix> InverseBindMatrices;
+
+protected:
+    virtual bool Process() override;
+    virtual void Encode(FObjectExporterFileWriter& FileWriter) const override;
+    virtual void EncodeJson(FObjectExporterJsonWriter& JsonWriter) const override;
+};
+
+class FAnimSequenceExportData : public FObjectExporterAssetData
+{
+public:
+    static TSharedPtr<FAnimSequenceExportData, ESPMode::ThreadSafe> Gather(const UAnimSequence* AnimSequence);
+
+    explicit FAnimSequenceExportData(const FString& AssetName);
+
+    virtual SIZE_T GetAllocatedSize() const override;
+
+    int32 NumFrames;
+    float SequenceLength;
+    FString SkeletonName;
+    TArray<int32> TrackBoneIndices;
+    TArray<FRawAnimSequenceTrack> Tracks;
+    TArray<FObjectExporterAnimBoneTrack> BoneTracks;
+
+    FObjectExporterAnimCompressionSettings Compression;
+    FObjectExporterCompressedAnimData CompressedData;
+    FObjectExporterFrameMajorAnimData FrameMajorData;
+
+protected:
+    virtual bool Process() override;
+    virtual void Encode(FObjectExporterFileWriter& FileWriter) const override;
+    virtual void EncodeJson(FObjectExporterJsonWriter& JsonWriter) const override;
+};
+
+class FMaterialExportData : public FObjectExporterAssetData
+{
+public:
+    /** OutTextures receives the textures referenced by the material, they have to be exported on the game thread. */
+    static TSharedPtr<FMaterialExportData, ESPMode::ThreadSafe> Gather(const UMaterialInstance* MaterialInstance, TArray<UTexture*>& OutTextures);
+
+    explicit FMaterialExportData(const FString& AssetName);
+
+    virtual SIZE_T GetAllocatedSize() const override;
+
+    int32 BlendMode;
+    FString BaseMaterialName;
+
+    /** Texture parameters with a texture, one texture slot each. */
+    TArray<FString> TextureParameterNames;
+    TArray<FString> TextureNames;
+
+    TArray<FString> ScalarParameterNames;
+    TArray<float> Scalars;
+
+    TArray<FString> VectorParameterNames;
+    TArray<FLinearColor> Vectors;
+
+protected:
+    virtual void Encode(FObjectExporterFileWriter& FileWriter) const override;
+    virtual void EncodeJson(FObjectExporterJsonWriter& JsonWriter) const override;
+};
+
+class FTextureExportData : public FObjectExporterAssetData
+{
+public:
+    /** Platform of ObjectExporter.TextureTargetPlatform, or the editor platform when it is empty or unknown. Game thread only. */
+    static const ITargetPlatform* GetTargetPlatform();
+
+    /** The cooked platform data of a texture for the target platform, see BeginCache. */
+    struct FCacheRequest
+    {
+        FCacheRequest()
+            : bOwnsPlatformData(false)
+        {
+        }
+
+        /** Key of the platform data in the texture's cooked platform data, empty if it cannot be built. */
+        FString DerivedDataKey;
+
+        /** True if BeginCache started the platform data, Gather then releases it. */
+        bool bOwnsPlatformData;
+    };
+
+    /**
+    *   Starts building the cooked platform data of Texture in the background, unless it is already cached for the
+    *   platform. Call it for every texture before gathering any. Game thread only.
+    */
+    static FCacheRequest BeginCache(UTexture* Texture, const ITargetPlatform* TargetPlatform);
+
+    /** Waits for the platform data of Request, copies its mips and releases it if BeginCache started it. */
+    static TSharedPtr<FTextureExportData, ESPMode::ThreadSafe> Gather(UTexture* Texture, const ITargetPlatform* TargetPlatform, const FCacheRequest& Request);
+
+    explicit FTextureExportData(const FString& AssetName);
+
+    virtual SIZE_T GetAllocatedSize() const override;
+
+    FObjectExporterTextureInfo Info;
+    TArray<FObjectExporterTextureMip> Mips;
+
+    /** Every mip as gathered, split into ResidentMipData and StreamedMipData by Process. */
+    TArray<uint8> MipData;
+    TArray<uint8> ResidentMipData;
+    TArray<uint8> StreamedMipData;
+
+    /** ObjectExporter.TextureResidentMipSize when gathered. */
+    int32 ResidentMipSize;
+
+protected:
+    virtual bool Process() override;
+    virtual void Encode(FObjectExporterFileWriter& FileWriter) const override;
+    virtual void EncodeJson(FObjectExporterJsonWriter& JsonWriter) const override;
+};
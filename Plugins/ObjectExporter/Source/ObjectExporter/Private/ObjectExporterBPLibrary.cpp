@@ -13,15 +13,21 @@
 #include "Components/DirectionalLightComponent.h"
 #include "Components/PointLightComponent.h"
 #include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "EngineUtils.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Camera/CameraComponent.h"
-#include "IAssetTools.h"
-#include "AssetToolsModule.h"
 #include "Engine/SkeletalMesh.h"
 #include "Animation/SkeletalMeshActor.h"
 #include "Rendering/SkeletalMeshModel.h"
 #include "Rendering/SkeletalMeshRenderData.h"
 #include "Rendering/SkeletalMeshLODRenderData.h"
+#include "Materials/MaterialInterface.h"
+#include "ObjectExporterFileWriter.h"
+#include "ObjectExporterAnimSampler.h"
+#include "ObjectExporterAssetData.h"
+#include "ObjectExporterPipeline.h"
+#include "ObjectExporterSpatialIndex.h"
 
 
 #define TEXTURE_PATH "Bin/Texture/"
@@ -30,6 +36,7 @@
 #define SKELETALMESH_PATH "Bin/SkeletalMesh/"
 #define SKELETON_PATH "Bin/SkeletalMesh/Skeleton/"
 #define ANIMATION_PATH "Bin/SkeletalMesh/Animation/"
+#define MAP_PATH "Bin/Map/"
 
 #define JSON_FILE_POSTFIX ".json"
 #define STATIC_MESH_BINARY_FILE_POSTFIX ".stm"
@@ -38,6 +45,7 @@
 #define ANIMSEQUENCE_BINARY_FILE_POSTFIX ".anm"
 #define MATERIAL_BINARY_FILE_POSTFIX ".mat"
 #define MAP_BINARY_FILE_POSTFIX ".map"
+#define TEXTURE_BINARY_FILE_POSTFIX ".tex"
 
 DECLARE_LOG_CATEGORY_CLASS(ObjectExporterBPLibraryLog, Log, All);
 
@@ -47,327 +55,744 @@ UObjectExporterBPLibrary::UObjectExporterBPLibrary(const FObjectInitializer& Obj
 
 }
 
-bool UObjectExporterBPLibrary::ExportStaticMesh(const UStaticMesh* StaticMesh, const FString& FullFilePathName)
+static TAutoConsoleVariable<int32> CVarObjectExporterUseExportCache(
+    TEXT("ObjectExporter.UseExportCache"),
+    1,
+    TEXT("1: ExportMap skips assets whose source packages and exporter settings did not change since they were last exported (default).\n")
+    TEXT("0: ExportMap always re-exports every asset."));
+
+static TAutoConsoleVariable<float> CVarObjectExporterMapCellSize(
+    TEXT("ObjectExporter.MapCellSize"),
+    0.0f,
+    TEXT("Edge length in world units of the XY grid cells ExportMap partitions maps into, for world streaming.\n")
+    TEXT("0: ExportMap writes every actor to the map itself (default).\n")
+    TEXT(">0: ExportMap writes the actors of each grid cell to a cell of their own, embedded in the map behind a cell index."));
+
+static FString GetTextureFilePathName(const UTexture* Texture)
 {
-    FText OutError;
-    if (!FFileHelper::IsFilenameValidForSaving(FullFilePathName, OutError))
+    FString ResourcePath, ResourceName;
+    Texture->GetPathName().Split(FString("."), &ResourcePath, &ResourceName);
+
+    return FPaths::ProjectSavedDir() + TEXTURE_PATH + ResourceName + TEXTURE_BINARY_FILE_POSTFIX;
+}
+
+/**
+*   Starts the platform data builds of every texture first, so the texture compressors run in parallel, then gathers the
+*   textures in order and queues them on Pipeline. CacheKeys is parallel to Textures, or empty. Textures must be unique.
+*/
+static void QueueTextureExports(FObjectExporterPipeline& Pipeline, const TArray<UTexture*>& Textures, const TArray<FObjectExporterCacheKey>& CacheKeys)
+{
+    const ITargetPlatform* TargetPlatform = FTextureExportData::GetTargetPlatform();
+
+    TArray<FTextureExportData::FCacheRequest> CacheRequests;
+    for (UTexture* Texture : Textures)
     {
-        UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportStaticMesh: FullFilePathName is not valid. %s"), *OutError.ToString());
+        CacheRequests.Add(FTextureExportData::BeginCache(Texture, TargetPlatform));
+    }
+
+    for (int32 TextureIndex = 0; TextureIndex < Textures.Num(); TextureIndex++)
+    {
+        const FObjectExporterCacheKey CacheKey = CacheKeys.IsValidIndex(TextureIndex) ? CacheKeys[TextureIndex] : FObjectExporterCacheKey();
+        Pipeline.Enqueue(FTextureExportData::Gather(Textures[TextureIndex], TargetPlatform, CacheRequests[TextureIndex]), GetTextureFilePathName(Textures[TextureIndex]), CacheKey);
+    }
+}
+
+/** Appends the non null textures of Textures that are not in InOutTextureSet yet. */
+static void AddUniqueTextures(const TArray<UTexture*>& Textures, TArray<UTexture*>& OutUniqueTextures, TSet<UTexture*>& InOutTextureSet)
+{
+    for (UTexture* Texture : Textures)
+    {
+        if (Texture == nullptr)
+        {
+            continue;
+        }
+
+        bool bAlreadyAdded = false;
+        InOutTextureSet.Add(Texture, &bAlreadyAdded);
+
+        if (!bAlreadyAdded)
+        {
+            OutUniqueTextures.Add(Texture);
+        }
+    }
+}
+
+/** Placements of one mesh with the same materials. */
+struct FStaticMeshInstanceBatch
+{
+    FString ResourceName;
+    TArray<FString> MaterialNames;
+    TArray<FTransform> Transforms;
+    TArray<FBoxSphereBounds> Bounds;
+};
+
+/** A texture sampled by a map material, see FObjectExporterMaterialTexture. */
+struct FMapMaterialTexture
+{
+    FString Name;
+    float SamplingScale;
+    int32 UVChannel;
+};
 
+struct FMapMaterial
+{
+    FString Name;
+    TArray<FMapMaterialTexture> Textures;
+};
+
+/** Export cache and pipeline of one ExportMap run, or shared by the maps of a batch, see BeginMapExportBatch. */
+struct FMapExportBatch
+{
+    explicit FMapExportBatch(bool bInUseCache)
+        : bUseCache(bInUseCache)
+        , Pipeline(bUseCache ? &Cache : nullptr)
+    {
+        if (bUseCache)
+        {
+            Cache.LoadManifest();
+        }
+    }
+
+    /** Waits for every queued asset and returns the number of failed ones, see FObjectExporterPipeline::Flush. */
+    int32 Flush(TArray<FString>* OutWrittenFiles = nullptr)
+    {
+        const int32 NumFailedAssets = Pipeline.Flush(OutWrittenFiles);
+        if (NumFailedAssets > 0)
+        {
+            UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportMap: %d assets failed to export."), NumFailedAssets);
+        }
+
+        if (bUseCache)
+        {
+            UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportMap: %d assets up to date in the export cache."), Pipeline.GetNumUpToDate());
+            Cache.SaveManifest();
+        }
+
+        return NumFailedAssets;
+    }
+
+    bool bUseCache;
+    FObjectExporterCache Cache;
+    FObjectExporterPipeline Pipeline;
+};
+
+static TUniquePtr<FMapExportBatch> MapExportBatch;
+
+/** Map files written by ExportMap in this session by world package name, see GetMapFilePathName. */
+static TMap<FString, FString> ExportedMapFiles;
+
+/** Assets exported for one map. */
+struct FMapExportContext
+{
+    explicit FMapExportContext(FMapExportBatch& Batch)
+        : Cache(Batch.Cache)
+        , Pipeline(Batch.Pipeline)
+        , bExportAssets(true)
+    {
+    }
+
+    FObjectExporterCache& Cache;
+    FObjectExporterPipeline& Pipeline;
+
+    /** False to only gather the map records, see ExportMapRecords. */
+    bool bExportAssets;
+
+    /** Textures referenced by the gathered assets, in first use order, queued together by QueueMapTextures. */
+    TArray<UTexture*> Textures;
+    TSet<UTexture*> TextureSet;
+
+    /** Materials of the gathered components with the textures they sample, written to the map as MMAT and MTEX. */
+    TArray<FMapMaterial> Materials;
+    TMap<FString, int32> MaterialIndices;
+
+    /** Names of the materials exported as .mat files, the material instances. */
+    TSet<FString> MaterialInstanceNames;
+};
+
+/** Returns true if the asset still has to be gathered, false if it is already queued or its output is up to date. */
+static bool ShouldGatherAsset(FMapExportContext& Context, const UObject* Asset, const FString& FullFilePathName, const TArray<const UObject*>& Dependencies, FObjectExporterCacheKey& OutCacheKey)
+{
+    // Several actors usually share an asset
+    if (!Context.bExportAssets || Context.Pipeline.IsQueued(FullFilePathName))
+    {
         return false;
     }
 
-    if (StaticMesh != nullptr)
+    if (CVarObjectExporterUseExportCache.GetValueOnGameThread() != 0)
     {
-        if (FullFilePathName.EndsWith(JSON_FILE_POSTFIX))
+        OutCacheKey = Context.Cache.ComputeKey(Asset, Dependencies);
+        if (Context.Cache.IsUpToDate(FullFilePathName, OutCacheKey))
         {
-            const int32 FileVersion = 1;
-            TSharedRef<FJsonObject> JsonRootObject = MakeShareable(new FJsonObject);
-            JsonRootObject->SetNumberField("FileVersion", FileVersion);
-            JsonRootObject->SetStringField("MeshName", *StaticMesh->GetName());
+            Context.Pipeline.MarkUpToDate(FullFilePathName);
 
-            if (StaticMesh->RenderData != nullptr)
-            {
-                // Vertex format
-                TArray<TSharedPtr<FJsonValue>> JsonVertexFormat;
-                JsonRootObject->SetArrayField("VertexFormat", JsonVertexFormat);
+            return false;
+        }
+    }
 
-                // LODs
-                JsonRootObject->SetNumberField("LODCount", StaticMesh->RenderData->LODResources.Num());
+    return true;
+}
 
-                int32 LODIndex = 0;
-                TArray< TSharedPtr<FJsonValue> > JsonLODDatas;
-                for (const FStaticMeshLODResources& CurLOD : StaticMesh->RenderData->LODResources)
-                {
-                    TSharedRef<FJsonObject> JsonLODSingle = MakeShareable(new FJsonObject);
-                    JsonLODSingle->SetNumberField("LOD", LODIndex);
+/** Queues the textures that are not up to date. */
+static void QueueMapTextures(FMapExportContext& Context, const TArray<UTexture*>& Textures)
+{
+    TArray<UTexture*> QueuedTextures;
+    TArray<FObjectExporterCacheKey> CacheKeys;
+    for (UTexture* Texture : Textures)
+    {
+        FObjectExporterCacheKey CacheKey;
+        if (ShouldGatherAsset(Context, Texture, GetTextureFilePathName(Texture), TArray<const UObject*>(), CacheKey))
+        {
+            QueuedTextures.Add(Texture);
+            CacheKeys.Add(CacheKey);
+        }
+    }
 
-                    // Vertex data
-                    TArray<TSharedPtr<FJsonValue>> JsonVertices;
-                    const FPositionVertexBuffer& VertexBuffer = CurLOD.VertexBuffers.PositionVertexBuffer;
+    QueueTextureExports(Context.Pipeline, QueuedTextures, CacheKeys);
+}
 
-                    JsonLODSingle->SetNumberField("VertexCount", VertexBuffer.GetNumVertices());
+/** Returns true if the asset was queued, false if it is already queued or up to date. */
+template <typename ExportDataType, typename AssetType>
+static bool QueueAssetExport(FMapExportContext& Context, const AssetType* Asset, const FString& FullFilePathName, const TArray<const UObject*>& Dependencies = TArray<const UObject*>())
+{
+    FObjectExporterCacheKey CacheKey;
+    if (ShouldGatherAsset(Context, Asset, FullFilePathName, Dependencies, CacheKey))
+    {
+        return Context.Pipeline.Enqueue(ExportDataType::Gather(Asset), FullFilePathName, CacheKey);
+    }
 
-                    for (uint32 iVertex = 0; iVertex < VertexBuffer.GetNumVertices(); iVertex++)
-                    {
-                        const FVector& Position = VertexBuffer.VertexPosition(iVertex);
+    return false;
+}
 
-                        TSharedRef<FJsonObject> JsonVertex = MakeShareable(new FJsonObject);
-                        JsonVertex->SetNumberField("x", Position.X);
-                        JsonVertex->SetNumberField("y", Position.Y);
-                        JsonVertex->SetNumberField("z", Position.Z);
+static bool QueueMaterialExport(FMapExportContext& Context, const UMaterialInstance* MaterialInstance, const FString& FullFilePathName)
+{
+    // Parameters not overridden by the instance come from its parents
+    TArray<const UObject*> Dependencies;
+    for (const UMaterialInstance* Parent = Cast<UMaterialInstance>(MaterialInstance->Parent); Parent != nullptr; Parent = Cast<UMaterialInstance>(Parent->Parent))
+    {
+        Dependencies.Add(Parent);
+    }
+    Dependencies.Add(MaterialInstance->GetMaterial());
 
-                        JsonVertices.Emplace(MakeShareable(new FJsonValueObject(JsonVertex)));
-                    }
-                    JsonLODSingle->SetArrayField("Vertices", JsonVertices);
+    FObjectExporterCacheKey CacheKey;
+    if (ShouldGatherAsset(Context, MaterialInstance, FullFilePathName, Dependencies, CacheKey))
+    {
+        TArray<UTexture*> Textures;
+        const bool bQueued = Context.Pipeline.Enqueue(FMaterialExportData::Gather(MaterialInstance, Textures), FullFilePathName, CacheKey);
+        AddUniqueTextures(Textures, Context.Textures, Context.TextureSet);
 
-                    // Index data
-                    TArray<TSharedPtr<FJsonValue>> JsonIndices;
-                    FIndexArrayView Indices = CurLOD.IndexBuffer.GetArrayView();
+        return bQueued;
+    }
 
-                    JsonLODSingle->SetNumberField("IndexCount", Indices.Num());
+    return false;
+}
 
-                    for (int32 iIndex = 0; iIndex < Indices.Num(); iIndex++)
-                    {
-                        TSharedRef<FJsonObject> JsonIndex = MakeShareable(new FJsonObject);
-                        JsonIndex->SetNumberField("index", Indices[iIndex]);
+/** Records the textures Material samples, for streaming, and adds them to the textures to export. */
+static void AddMapMaterial(FMapExportContext& Context, const UMaterialInterface* Material, const FString& MaterialName)
+{
+    if (Context.MaterialIndices.Contains(MaterialName))
+    {
+        return;
+    }
+    Context.MaterialIndices.Add(MaterialName, Context.Materials.Num());
 
-                        JsonIndices.Emplace(MakeShareable(new FJsonValueObject(JsonIndex)));
-                    }
-                    JsonLODSingle->SetArrayField("Indices", JsonIndices);
+    TArray<UTexture*> Textures;
+    Material->GetUsedTextures(Textures, EMaterialQualityLevel::Num, true, ERHIFeatureLevel::Num, true);
+    AddUniqueTextures(Textures, Context.Textures, Context.TextureSet);
 
-                    JsonLODDatas.Emplace(MakeShareable(new FJsonValueObject(JsonLODSingle)));
+    FMapMaterial& MapMaterial = Context.Materials.AddDefaulted_GetRef();
+    MapMaterial.Name = MaterialName;
 
-                    LODIndex++;
-                }
-                JsonRootObject->SetArrayField("LODs", JsonLODDatas);
+    const TArray<FMaterialTextureInfo>& StreamingData = Material->GetTextureStreamingData();
+    for (UTexture* Texture : Textures)
+    {
+        if (Texture == nullptr)
+        {
+            continue;
+        }
 
-                FString JsonContent;
-                TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&JsonContent, 0);
-                if (FJsonSerializer::Serialize(JsonRootObject, JsonWriter))
-                {
-                    if (FFileHelper::SaveStringToFile(JsonContent, *FullFilePathName))
-                    {
-                        UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportStaticMesh: success."));
+        FString TexturePath;
+        FMapMaterialTexture& MaterialTexture = MapMaterial.Textures.AddDefaulted_GetRef();
+        Texture->GetPathName().Split(FString("."), &TexturePath, &MaterialTexture.Name);
+        MaterialTexture.SamplingScale = 1.0f;
+        MaterialTexture.UVChannel = 0;
 
-                        return true;
-                    }
+        // A texture sampled several times is streamed for its most demanding sampling, the largest UV scale
+        int32 LowerIndex = INDEX_NONE;
+        int32 HigherIndex = INDEX_NONE;
+        if (Material->FindTextureStreamingDataIndexRange(Texture->GetFName(), LowerIndex, HigherIndex))
+        {
+            MaterialTexture.SamplingScale = 0.0f;
+            for (int32 StreamingIndex = LowerIndex; StreamingIndex <= HigherIndex; StreamingIndex++)
+            {
+                if (StreamingData[StreamingIndex].SamplingScale > MaterialTexture.SamplingScale)
+                {
+                    MaterialTexture.SamplingScale = StreamingData[StreamingIndex].SamplingScale;
+                    MaterialTexture.UVChannel = StreamingData[StreamingIndex].UVChannelIndex;
                 }
             }
         }
-        else if (FullFilePathName.EndsWith(STATIC_MESH_BINARY_FILE_POSTFIX))
+    }
+}
+
+/** Collects the material name of every slot of Component (empty for unset slots) and queues the material instances. */
+static void QueueComponentMaterials(FMapExportContext& Context, const UMeshComponent* Component, TArray<FString>& OutMaterialNames)
+{
+    for (int32 MaterialIndex = 0; MaterialIndex < Component->GetNumMaterials(); MaterialIndex++)
+    {
+        UMaterialInterface* Material = Component->GetMaterial(MaterialIndex);
+
+        FString MaterialPath, MaterialName;
+        if (Material != nullptr)
         {
-            // Save to binary file
-            IFileManager& FileManager = IFileManager::Get();
-            FArchive* FileWriter = FileManager.CreateFileWriter(*FullFilePathName);
-            if (nullptr == FileWriter)
-            {
-                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportStaticMesh: CreateFileWriter failed."));
+            Material->GetPathName().Split(FString("."), &MaterialPath, &MaterialName);
+        }
+        OutMaterialNames.Add(MaterialName);
 
-                return false;
-            }
+        if (Material != nullptr)
+        {
+            AddMapMaterial(Context, Material, MaterialName);
+        }
 
-            for (const FStaticMeshLODResources& CurLOD : StaticMesh->RenderData->LODResources)
-            {
-                // Vertex data
-                const FPositionVertexBuffer& PositionVertexBuffer = CurLOD.VertexBuffers.PositionVertexBuffer;
-                const FStaticMeshVertexBuffer& StaticMeshVertexBuffer = CurLOD.VertexBuffers.StaticMeshVertexBuffer;
-                int32 NumVertices = PositionVertexBuffer.GetNumVertices();
+        UMaterialInstance* Instance = Cast<UMaterialInstance>(Material);
+        if (Instance != nullptr)
+        {
+            Context.MaterialInstanceNames.Add(MaterialName);
 
-                *FileWriter << NumVertices;
+            FString SaveMaterialPath = FPaths::ProjectSavedDir() + MATERIAL_PATH + MaterialName + MATERIAL_BINARY_FILE_POSTFIX;
 
-                for (uint32 iVertex = 0; iVertex < PositionVertexBuffer.GetNumVertices(); iVertex++)
-                {
-                    FVector Position = PositionVertexBuffer.VertexPosition(iVertex);
-                    FVector4 TangentZ = StaticMeshVertexBuffer.VertexTangentZ(iVertex);
-                    FVector Normal = FVector(TangentZ.X, TangentZ.Y, TangentZ.Z) * TangentZ.W;
-                    FVector2D UV = StaticMeshVertexBuffer.GetVertexUV(iVertex, 0);
-
-                    *FileWriter << Position;
-                    *FileWriter << Normal;
-                    *FileWriter << UV;
-                }
+            QueueMaterialExport(Context, Instance, SaveMaterialPath);
+        }
+    }
+}
 
-                // Index data
-                FIndexArrayView Indices = CurLOD.IndexBuffer.GetArrayView();
-                int32 NumIndices = Indices.Num();
+/** Appends MaterialNames to the MTLN table and returns the first entry. */
+static uint32 AddMaterialNames(FObjectExporterFileWriter& FileWriter, const TArray<FString>& MaterialNames, TArray<uint32>& MaterialNameTable)
+{
+    const uint32 FirstMaterial = MaterialNameTable.Num();
+    for (const FString& MaterialName : MaterialNames)
+    {
+        MaterialNameTable.Add(MaterialName.IsEmpty() ? OBJECT_EXPORTER_INVALID_STRING : FileWriter.AddString(MaterialName));
+    }
 
-                *FileWriter << NumIndices;
+    return FirstMaterial;
+}
 
-                for (int32 iIndex = 0; iIndex < Indices.Num(); iIndex++)
-                {
-                    uint16 Index = Indices[iIndex];
-                    *FileWriter << Index;
-                }
+struct FMapSkeletalMeshActor
+{
+    FTransform Transform;
+    FString ResourceName;
+    FString SkeletonName;
+    FString AnimationName;
+    TArray<FString> MaterialNames;
+    FBoxSphereBounds Bounds;
+};
+
+/** The bounded records of a map, written to the map itself or split into grid cells. */
+struct FMapRecords
+{
+    TArray<FObjectExporterPointLight> PointLights;
+    TArray<FBoxSphereBounds> PointLightBounds;
+    TArray<FStaticMeshInstanceBatch> InstanceBatches;
+    TArray<FMapSkeletalMeshActor> SkeletalMeshActors;
+};
+
+/** Records of FMapRecords written to one file, by index. */
+struct FMapRecordSelection
+{
+    FMapRecordSelection()
+        : Bounds(ForceInit)
+        , NumPrimitives(0)
+    {
+    }
 
-                //now save only lod 0
-                break;
-            }
+    TArray<int32> PointLights;
+
+    /** Instances per batch of FMapRecords::InstanceBatches, trailing batches without instances may be left out. */
+    TArray<TArray<int32>> Instances;
 
-            FileWriter->Close();
-            delete FileWriter;
-            FileWriter = nullptr;
+    TArray<int32> SkeletalMeshActors;
+
+    /** Encloses the bounds of the selected records. */
+    FBox Bounds;
+    int32 NumPrimitives;
+};
+
+/**
+*   Assigns every record to the XY grid cell its bounds origin falls in, in gather order.
+*   A CellSize of 0 puts every record into cell (0, 0).
+*/
+static void SelectMapRecords(const FMapRecords& Records, float CellSize, TMap<FIntPoint, FMapRecordSelection>& OutCells)
+{
+    auto FindCell = [&](const FBoxSphereBounds& Bounds) -> FMapRecordSelection&
+    {
+        FIntPoint Cell(0, 0);
+        if (CellSize > 0.0f)
+        {
+            Cell.X = FMath::FloorToInt(Bounds.Origin.X / CellSize);
+            Cell.Y = FMath::FloorToInt(Bounds.Origin.Y / CellSize);
         }
+
+        FMapRecordSelection& Selection = OutCells.FindOrAdd(Cell);
+        Selection.Bounds += Bounds.GetBox();
+        Selection.NumPrimitives++;
+
+        return Selection;
+    };
+
+    for (int32 LightIndex = 0; LightIndex < Records.PointLights.Num(); LightIndex++)
+    {
+        FindCell(Records.PointLightBounds[LightIndex]).PointLights.Add(LightIndex);
     }
 
-    UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportStaticMesh: failed."));
+    for (int32 BatchIndex = 0; BatchIndex < Records.InstanceBatches.Num(); BatchIndex++)
+    {
+        const FStaticMeshInstanceBatch& Batch = Records.InstanceBatches[BatchIndex];
+        for (int32 InstanceIndex = 0; InstanceIndex < Batch.Bounds.Num(); InstanceIndex++)
+        {
+            FMapRecordSelection& Selection = FindCell(Batch.Bounds[InstanceIndex]);
+            Selection.Instances.SetNum(FMath::Max(Selection.Instances.Num(), BatchIndex + 1));
+            Selection.Instances[BatchIndex].Add(InstanceIndex);
+        }
+    }
 
-    return false;
+    for (int32 ActorIndex = 0; ActorIndex < Records.SkeletalMeshActors.Num(); ActorIndex++)
+    {
+        FindCell(Records.SkeletalMeshActors[ActorIndex].Bounds).SkeletalMeshActors.Add(ActorIndex);
+    }
 }
 
-bool UObjectExporterBPLibrary::ExportSkeletalMesh(const USkeletalMesh* SkeletalMesh, const FString& FullFilePathName)
+/** Adds the PLIT, IBAT, ITRA, IROT, ISCL, SKAC and MTLN chunks of the selected records with their bounds and BVH. */
+static void AddMapRecordChunks(FObjectExporterFileWriter& FileWriter, const FMapRecords& Records, const FMapRecordSelection& Selection)
 {
-    FText OutError;
-    if (!FFileHelper::IsFilenameValidForSaving(FullFilePathName, OutError))
+    // Every bounded record is also added to the spatial index, directional lights affect the whole map
+    FObjectExporterSpatialIndexBuilder SpatialIndexBuilder;
+
+    TArray<FObjectExporterPointLight> PointLights;
+    TArray<FObjectExporterBounds> PointLightBounds;
+
+    for (int32 LightIndex : Selection.PointLights)
     {
-        UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportSkeletonalMesh: FullFilePathName is not valid. %s"), *OutError.ToString());
+        const FBoxSphereBounds& LightBounds = Records.PointLightBounds[LightIndex];
+        PointLights.Add(Records.PointLights[LightIndex]);
+        ObjectExporterFile::CopyBounds(PointLightBounds.AddZeroed_GetRef(), LightBounds);
+        SpatialIndexBuilder.AddPrimitive(LightBounds.GetBox(), (uint32)EObjectExporterPrimitiveType::PointLight, PointLights.Num() - 1);
+    }
 
-        return false;
+    // One contiguous SoA range of transforms per batch, so the runtime can issue one instanced draw per batch
+    TArray<FObjectExporterInstanceBatch> Batches;
+    TArray<uint32> MaterialNameTable;
+    TArray<float> InstanceTranslations;
+    TArray<float> InstanceRotations;
+    TArray<float> InstanceScales;
+    TArray<FObjectExporterBounds> InstanceBounds;
+
+    for (int32 BatchIndex = 0; BatchIndex < Selection.Instances.Num(); BatchIndex++)
+    {
+        const TArray<int32>& Instances = Selection.Instances[BatchIndex];
+        if (Instances.Num() == 0)
+        {
+            continue;
+        }
+
+        const FStaticMeshInstanceBatch& InstanceBatch = Records.InstanceBatches[BatchIndex];
+        FObjectExporterInstanceBatch& Batch = Batches.AddZeroed_GetRef();
+        Batch.ResourceName = FileWriter.AddString(InstanceBatch.ResourceName);
+        Batch.FirstMaterial = AddMaterialNames(FileWriter, InstanceBatch.MaterialNames, MaterialNameTable);
+        Batch.NumMaterials = InstanceBatch.MaterialNames.Num();
+        Batch.FirstInstance = InstanceTranslations.Num() / 3;
+        Batch.NumInstances = Instances.Num();
+
+        for (int32 InstanceIndex : Instances)
+        {
+            const FTransform& InstanceTransform = InstanceBatch.Transforms[InstanceIndex];
+            ObjectExporterFile::CopyVector(&InstanceTranslations[InstanceTranslations.AddUninitialized(3)], InstanceTransform.GetLocation());
+            ObjectExporterFile::CopyQuat(&InstanceRotations[InstanceRotations.AddUninitialized(4)], InstanceTransform.GetRotation());
+            ObjectExporterFile::CopyVector(&InstanceScales[InstanceScales.AddUninitialized(3)], InstanceTransform.GetScale3D());
+
+            const FBoxSphereBounds& Bounds = InstanceBatch.Bounds[InstanceIndex];
+            ObjectExporterFile::CopyBounds(InstanceBounds.AddZeroed_GetRef(), Bounds);
+            SpatialIndexBuilder.AddPrimitive(Bounds.GetBox(), (uint32)EObjectExporterPrimitiveType::Instance, InstanceBounds.Num() - 1);
+        }
     }
 
-    if (SkeletalMesh != nullptr)
+    TArray<FObjectExporterSkeletalMeshActor> SkeletalMeshActors;
+    TArray<FObjectExporterBounds> SkeletalMeshActorBounds;
+
+    for (int32 ActorIndex : Selection.SkeletalMeshActors)
     {
-        if (FullFilePathName.EndsWith(JSON_FILE_POSTFIX))
+        const FMapSkeletalMeshActor& Actor = Records.SkeletalMeshActors[ActorIndex];
+
+        FObjectExporterSkeletalMeshActor& SkeletalMeshActor = SkeletalMeshActors.AddZeroed_GetRef();
+        ObjectExporterFile::CopyQuat(SkeletalMeshActor.Rotation, Actor.Transform.GetRotation());
+        ObjectExporterFile::CopyVector(SkeletalMeshActor.Location, Actor.Transform.GetLocation());
+        SkeletalMeshActor.ResourceName = FileWriter.AddString(Actor.ResourceName);
+        SkeletalMeshActor.AnimationName = FileWriter.AddString(Actor.AnimationName);
+        SkeletalMeshActor.FirstMaterial = AddMaterialNames(FileWriter, Actor.MaterialNames, MaterialNameTable);
+        SkeletalMeshActor.NumMaterials = Actor.MaterialNames.Num();
+
+        ObjectExporterFile::CopyBounds(SkeletalMeshActorBounds.AddZeroed_GetRef(), Actor.Bounds);
+        SpatialIndexBuilder.AddPrimitive(Actor.Bounds.GetBox(), (uint32)EObjectExporterPrimitiveType::SkeletalMeshActor, SkeletalMeshActors.Num() - 1);
+    }
+
+    TArray<FObjectExporterBVHNode> BVHNodes;
+    TArray<FObjectExporterBVHPrimitive> BVHPrimitives;
+    SpatialIndexBuilder.Build(BVHNodes, BVHPrimitives);
+
+    FileWriter.AddChunk(ObjectExporterChunk::PointLights, PointLights);
+    FileWriter.AddChunk(ObjectExporterChunk::InstanceBatches, Batches);
+    FileWriter.AddChunk(ObjectExporterChunk::InstanceTranslations, InstanceTranslations);
+    FileWriter.AddChunk(ObjectExporterChunk::InstanceRotations, InstanceRotations);
+    FileWriter.AddChunk(ObjectExporterChunk::InstanceScales, InstanceScales);
+    FileWriter.AddChunk(ObjectExporterChunk::SkeletalMeshActors, SkeletalMeshActors);
+    FileWriter.AddChunk(ObjectExporterChunk::MaterialNames, MaterialNameTable);
+    FileWriter.AddChunk(ObjectExporterChunk::InstanceBounds, InstanceBounds);
+    FileWriter.AddChunk(ObjectExporterChunk::SkeletalMeshActorBounds, SkeletalMeshActorBounds);
+    FileWriter.AddChunk(ObjectExporterChunk::PointLightBounds, PointLightBounds);
+    FileWriter.AddChunk(ObjectExporterChunk::BVHNodes, BVHNodes);
+    FileWriter.AddChunk(ObjectExporterChunk::BVHPrimitives, BVHPrimitives);
+}
+
+/** Adds the exported material instances among MaterialNames and the textures the materials sample. */
+static void AddMaterialDependencies(const FMapExportContext& Context, const TArray<FString>& MaterialNames, TSet<TPair<uint32, FString>>& InOutDependencies)
+{
+    for (const FString& MaterialName : MaterialNames)
+    {
+        if (Context.MaterialInstanceNames.Contains(MaterialName))
         {
-            const int32 FileVersion = 1;
-            TSharedRef<FJsonObject> JsonRootObject = MakeShareable(new FJsonObject);
-            JsonRootObject->SetNumberField("FileVersion", FileVersion);
+            InOutDependencies.Add(TPair<uint32, FString>(ObjectExporterFile::Material, MaterialName));
         }
-        else if (FullFilePathName.EndsWith(SKELETAL_MESH_BINARY_FILE_POSTFIX))
+
+        if (const int32* MaterialIndex = Context.MaterialIndices.Find(MaterialName))
         {
-            // Save to binary file
-            IFileManager& FileManager = IFileManager::Get();
-            FArchive* FileWriter = FileManager.CreateFileWriter(*FullFilePathName);
-            if (nullptr == FileWriter)
+            for (const FMapMaterialTexture& Texture : Context.Materials[*MaterialIndex].Textures)
             {
-                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportSkeletonalMesh: CreateFileWriter failed."));
-
-                return false;
+                InOutDependencies.Add(TPair<uint32, FString>(ObjectExporterFile::Texture, Texture.Name));
             }
+        }
+    }
+}
 
-            for (const FSkeletalMeshLODRenderData& CurLOD : SkeletalMesh->GetResourceForRendering()->LODRenderData)
-            {
-                // Vertex data
-                const FPositionVertexBuffer& PositionVertexBuffer = CurLOD.StaticVertexBuffers.PositionVertexBuffer;
-                const FStaticMeshVertexBuffer& StaticMeshVertexBuffer = CurLOD.StaticVertexBuffers.StaticMeshVertexBuffer;
-                const TArray<FBoneIndexType>& BoneMap = CurLOD.RenderSections[0].BoneMap;
-                TArray<FSkinWeightInfo> WeightInfos;
-                CurLOD.SkinWeightVertexBuffer.GetSkinWeights(WeightInfos);
+/** Adds the DEPS chunk of a map cell, every asset its records use. */
+static void AddMapCellDependencies(FObjectExporterFileWriter& FileWriter, const FMapExportContext& Context, const FMapRecords& Records, const FMapRecordSelection& Selection)
+{
+    TSet<TPair<uint32, FString>> Dependencies;
 
-                int32 NumVertices = PositionVertexBuffer.GetNumVertices();
+    for (int32 BatchIndex = 0; BatchIndex < Selection.Instances.Num(); BatchIndex++)
+    {
+        if (Selection.Instances[BatchIndex].Num() > 0)
+        {
+            const FStaticMeshInstanceBatch& Batch = Records.InstanceBatches[BatchIndex];
+            Dependencies.Add(TPair<uint32, FString>(ObjectExporterFile::StaticMesh, Batch.ResourceName));
+            AddMaterialDependencies(Context, Batch.MaterialNames, Dependencies);
+        }
+    }
 
-                *FileWriter << NumVertices;
+    for (int32 ActorIndex : Selection.SkeletalMeshActors)
+    {
+        const FMapSkeletalMeshActor& Actor = Records.SkeletalMeshActors[ActorIndex];
+        Dependencies.Add(TPair<uint32, FString>(ObjectExporterFile::SkeletalMesh, Actor.ResourceName));
+        Dependencies.Add(TPair<uint32, FString>(ObjectExporterFile::Skeleton, Actor.SkeletonName));
+        if (!Actor.AnimationName.IsEmpty())
+        {
+            Dependencies.Add(TPair<uint32, FString>(ObjectExporterFile::AnimSequence, Actor.AnimationName));
+        }
+        AddMaterialDependencies(Context, Actor.MaterialNames, Dependencies);
+    }
 
-                for (uint32 iVertex = 0; iVertex < PositionVertexBuffer.GetNumVertices(); iVertex++)
-                {
-                    FVector Position = PositionVertexBuffer.VertexPosition(iVertex);
-                    FVector4 TangentZ = StaticMeshVertexBuffer.VertexTangentZ(iVertex);
-                    FVector Normal = FVector(TangentZ.X, TangentZ.Y, TangentZ.Z);
-                    FVector2D UV = StaticMeshVertexBuffer.GetVertexUV(iVertex, 0);
-
-                    *FileWriter << Position;
-                    *FileWriter << Normal;
-                    *FileWriter << UV;
-
-                    FBoneIndexType BoneIndex0 = BoneMap[WeightInfos[iVertex].InfluenceBones[0]];
-                    *FileWriter << BoneIndex0;
-                    FBoneIndexType BoneIndex1 = BoneMap[WeightInfos[iVertex].InfluenceBones[1]];
-                    *FileWriter << BoneIndex1;
-                    FBoneIndexType BoneIndex2 = BoneMap[WeightInfos[iVertex].InfluenceBones[2]];
-                    *FileWriter << BoneIndex2;
-                    FBoneIndexType BoneIndex3 = BoneMap[WeightInfos[iVertex].InfluenceBones[3]];
-                    *FileWriter << BoneIndex3;
-
-                    float BoneWeight0 = WeightInfos[iVertex].InfluenceWeights[0] / 255.0f;
-                    *FileWriter << BoneWeight0;
-                    float BoneWeight1 = WeightInfos[iVertex].InfluenceWeights[1] / 255.0f;
-                    *FileWriter << BoneWeight1;
-                    float BoneWeight2 = WeightInfos[iVertex].InfluenceWeights[2] / 255.0f;
-                    *FileWriter << BoneWeight2;
-                    float BoneWeight3 = WeightInfos[iVertex].InfluenceWeights[3] / 255.0f;
-                    *FileWriter << BoneWeight3;
+    TArray<TPair<uint32, FString>> SortedDependencies = Dependencies.Array();
+    SortedDependencies.Sort([](const TPair<uint32, FString>& A, const TPair<uint32, FString>& B)
+    {
+        return A.Key != B.Key ? A.Key < B.Key : A.Value < B.Value;
+    });
 
-                }
+    TArray<FObjectExporterAssetDependency> AssetDependencies;
+    for (const TPair<uint32, FString>& Dependency : SortedDependencies)
+    {
+        FObjectExporterAssetDependency& AssetDependency = AssetDependencies.AddZeroed_GetRef();
+        AssetDependency.FileType = Dependency.Key;
+        AssetDependency.Name = FileWriter.AddString(Dependency.Value);
+    }
 
-                // Index data
-                TArray<uint32> Indices;
-                CurLOD.MultiSizeIndexContainer.GetIndexBuffer(Indices);
-                int32 NumIndices = Indices.Num();
+    FileWriter.AddChunk(ObjectExporterChunk::AssetDependencies, AssetDependencies);
+}
 
-                *FileWriter << NumIndices;
+/**
+*   Writes each cell as a MapCell file into CDAT and indexes them in GRID and CELL, so the runtime keeps only the
+*   cells around the camera loaded and streams each one in with a single page aligned read.
+*/
+static int32 AddMapCellChunks(FObjectExporterFileWriter& FileWriter, const FMapExportContext& Context, const FMapRecords& Records, float CellSize, TMap<FIntPoint, FMapRecordSelection>& Cells)
+{
+    // Row by row, so neighbour cells of a row are next to each other in the file
+    Cells.KeySort([](const FIntPoint& A, const FIntPoint& B)
+    {
+        return A.Y != B.Y ? A.Y < B.Y : A.X < B.X;
+    });
 
-                for (int32 iIndex = 0; iIndex < Indices.Num(); iIndex++)
-                {
-                    uint16 Index = Indices[iIndex];
-                    *FileWriter << Index;
-                }
-                
-                auto ResourceFullName = SkeletalMesh->Skeleton->GetPathName();
+    FObjectExporterMapGrid Grid;
+    FMemory::Memzero(Grid);
+    Grid.CellSize = CellSize;
 
-                FString ResourcePath, ResourceName;
-                ResourceFullName.Split(FString("."), &ResourcePath, &ResourceName);
+    FIntPoint MinCell(MAX_int32, MAX_int32);
+    FIntPoint MaxCell(MIN_int32, MIN_int32);
 
-                *FileWriter << ResourceName;
+    TArray<FObjectExporterMapCell> MapCells;
+    TArray<uint8> CellData;
+    TArray<uint8> CellFile;
 
-                //now save only lod 0
-                break;
-            }
+    for (const TPair<FIntPoint, FMapRecordSelection>& Cell : Cells)
+    {
+        FObjectExporterFileWriter CellWriter(ObjectExporterFile::MapCell);
+        AddMapRecordChunks(CellWriter, Records, Cell.Value);
+        AddMapCellDependencies(CellWriter, Context, Records, Cell.Value);
+        CellWriter.SaveToMemory(CellFile);
+
+        FObjectExporterMapCell& MapCell = MapCells.AddZeroed_GetRef();
+        MapCell.CellX = Cell.Key.X;
+        MapCell.CellY = Cell.Key.Y;
+        MapCell.NumPrimitives = Cell.Value.NumPrimitives;
+        MapCell.DataOffset = Align(CellData.Num(), OBJECT_EXPORTER_MAP_CELL_ALIGNMENT);
+        MapCell.DataSize = CellFile.Num();
+        ObjectExporterFile::CopyBounds(MapCell.Bounds, FBoxSphereBounds(Cell.Value.Bounds));
+
+        CellData.AddZeroed(MapCell.DataOffset - CellData.Num());
+        CellData.Append(CellFile);
+
+        MinCell = FIntPoint(FMath::Min(MinCell.X, Cell.Key.X), FMath::Min(MinCell.Y, Cell.Key.Y));
+        MaxCell = FIntPoint(FMath::Max(MaxCell.X, Cell.Key.X), FMath::Max(MaxCell.Y, Cell.Key.Y));
+    }
 
-            FileWriter->Close();
-            delete FileWriter;
-            FileWriter = nullptr;
+    if (MapCells.Num() > 0)
+    {
+        Grid.MinCellX = MinCell.X;
+        Grid.MinCellY = MinCell.Y;
+        Grid.NumCellsX = MaxCell.X - MinCell.X + 1;
+        Grid.NumCellsY = MaxCell.Y - MinCell.Y + 1;
+    }
+
+    FileWriter.AddSingleElementChunk(ObjectExporterChunk::MapGrid, Grid);
+    FileWriter.AddChunk(ObjectExporterChunk::MapCells, MapCells);
+    FileWriter.AddChunk(ObjectExporterChunk::MapCellData, CellData, OBJECT_EXPORTER_MAP_CELL_ALIGNMENT);
+
+    return MapCells.Num();
+}
 
+bool UObjectExporterBPLibrary::ExportStaticMesh(const UStaticMesh* StaticMesh, const FString& FullFilePathName)
+{
+    FText OutError;
+    if (!FFileHelper::IsFilenameValidForSaving(FullFilePathName, OutError))
+    {
+        UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportStaticMesh: FullFilePathName is not valid. %s"), *OutError.ToString());
+
+        return false;
+    }
+
+    if (StaticMesh != nullptr)
+    {
+        if (FullFilePathName.EndsWith(JSON_FILE_POSTFIX))
+        {
+            TSharedPtr<FStaticMeshExportData, ESPMode::ThreadSafe> Data = FStaticMeshExportData::Gather(StaticMesh);
+            if (Data.IsValid() && Data->SaveJson(FullFilePathName))
+            {
+                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportStaticMesh: success."));
+
+                return true;
+            }
+        }
+        else if (FullFilePathName.EndsWith(STATIC_MESH_BINARY_FILE_POSTFIX))
+        {
+            // Save to binary file
+            TSharedPtr<FStaticMeshExportData, ESPMode::ThreadSafe> Data = FStaticMeshExportData::Gather(StaticMesh);
+            if (Data.IsValid() && Data->Save(FullFilePathName))
+            {
+                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportStaticMesh: success."));
+
+                return true;
+            }
         }
     }
 
     UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportStaticMesh: failed."));
 
     return false;
-
 }
 
-bool UObjectExporterBPLibrary::ExportSkeleton(const USkeleton* Skeleton, const FString& FullFilePathName)
+bool UObjectExporterBPLibrary::ExportSkeletalMesh(const USkeletalMesh* SkeletalMesh, const FString& FullFilePathName)
 {
     FText OutError;
     if (!FFileHelper::IsFilenameValidForSaving(FullFilePathName, OutError))
     {
-        UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportSkeleton: FullFilePathName is not valid. %s"), *OutError.ToString());
+        UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportSkeletonalMesh: FullFilePathName is not valid. %s"), *OutError.ToString());
 
         return false;
     }
 
-    if (Skeleton != nullptr)
+    if (SkeletalMesh != nullptr)
     {
         if (FullFilePathName.EndsWith(JSON_FILE_POSTFIX))
         {
-            const int32 FileVersion = 1;
-            TSharedRef<FJsonObject> JsonRootObject = MakeShareable(new FJsonObject);
-            JsonRootObject->SetNumberField("FileVersion", FileVersion);
+            TSharedPtr<FSkeletalMeshExportData, ESPMode::ThreadSafe> Data = FSkeletalMeshExportData::Gather(SkeletalMesh);
+            if (Data.IsValid() && Data->SaveJson(FullFilePathName))
+            {
+                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportSkeletalMesh: success."));
+
+                return true;
+            }
         }
-        else if (FullFilePathName.EndsWith(SKELETON_BINARY_FILE_POSTFIX))
+        else if (FullFilePathName.EndsWith(SKELETAL_MESH_BINARY_FILE_POSTFIX))
         {
             // Save to binary file
-            IFileManager& FileManager = IFileManager::Get();
-            FArchive* FileWriter = FileManager.CreateFileWriter(*FullFilePathName);
-            if (nullptr == FileWriter)
+            TSharedPtr<FSkeletalMeshExportData, ESPMode::ThreadSafe> Data = FSkeletalMeshExportData::Gather(SkeletalMesh);
+            if (Data.IsValid() && Data->Save(FullFilePathName))
             {
-                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportSkeleton: CreateFileWriter failed."));
+                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportSkeletalMesh: success."));
 
-                return false;
+                return true;
             }
+        }
+    }
 
-            const TArray<FMeshBoneInfo>& BoneInfos = Skeleton->GetReferenceSkeleton().GetRawRefBoneInfo();
-            const TArray<FTransform>& BonePose = Skeleton->GetReferenceSkeleton().GetRawRefBonePose();
+    UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportSkeletalMesh: failed."));
 
-            int32 NumBoneInfos = BoneInfos.Num();
-            int32 NumPosBones = BonePose.Num();
+    return false;
 
-            *FileWriter << NumBoneInfos;
-            for (FMeshBoneInfo Boneinfo : BoneInfos)
-            {
-                *FileWriter << Boneinfo.Name;
-                *FileWriter << Boneinfo.ParentIndex;
-            }
+}
 
-            *FileWriter << NumPosBones;
-            for (FTransform BoneTransform : BonePose)
+bool UObjectExporterBPLibrary::ExportSkeleton(const USkeleton* Skeleton, const FString& FullFilePathName)
+{
+    FText OutError;
+    if (!FFileHelper::IsFilenameValidForSaving(FullFilePathName, OutError))
+    {
+        UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportSkeleton: FullFilePathName is not valid. %s"), *OutError.ToString());
+
+        return false;
+    }
+
+    if (Skeleton != nullptr)
+    {
+        if (FullFilePathName.EndsWith(JSON_FILE_POSTFIX))
+        {
+            TSharedPtr<FSkeletonExportData, ESPMode::ThreadSafe> Data = FSkeletonExportData::Gather(Skeleton);
+            if (Data.IsValid() && Data->SaveJson(FullFilePathName))
             {
-                FQuat Rot = BoneTransform.GetRotation();
-                FVector Tran = BoneTransform.GetTranslation();
-                FVector Scale = BoneTransform.GetScale3D();
-                *FileWriter << Rot;
-                *FileWriter << Tran;
-                *FileWriter << Scale;
-            }
+                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportSkeleton: success."));
 
-            FileWriter->Close();
-            delete FileWriter;
-            FileWriter = nullptr;
+                return true;
+            }
+        }
+        else if (FullFilePathName.EndsWith(SKELETON_BINARY_FILE_POSTFIX))
+        {
+            // Save to binary file
+            TSharedPtr<FSkeletonExportData, ESPMode::ThreadSafe> Data = FSkeletonExportData::Gather(Skeleton);
+            if (Data.IsValid() && Data->Save(FullFilePathName))
+            {
+                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportSkeleton: success."));
 
+                return true;
+            }
         }
     }
 
-    UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportStaticMesh: failed."));
+    UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportSkeleton: failed."));
 
     return false;
 
@@ -388,52 +813,28 @@ bool UObjectExporterBPLibrary::ExportAnimSequence(const UAnimSequence* AnimSeque
     {
         if (FullFilePathName.EndsWith(JSON_FILE_POSTFIX))
         {
-            const int32 FileVersion = 1;
-            TSharedRef<FJsonObject> JsonRootObject = MakeShareable(new FJsonObject);
-            JsonRootObject->SetNumberField("FileVersion", FileVersion);
+            TSharedPtr<FAnimSequenceExportData, ESPMode::ThreadSafe> Data = FAnimSequenceExportData::Gather(AnimSequence);
+            if (Data.IsValid() && Data->SaveJson(FullFilePathName))
+            {
+                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportAnimSequence: success."));
+
+                return true;
+            }
         }
         else if (FullFilePathName.EndsWith(ANIMSEQUENCE_BINARY_FILE_POSTFIX))
         {
             // Save to binary file
-            IFileManager& FileManager = IFileManager::Get();
-            FArchive* FileWriter = FileManager.CreateFileWriter(*FullFilePathName);
-            if (nullptr == FileWriter)
-            {
-                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportAnimSequence: CreateFileWriter failed."));
-
-                return false;
-            }
-     
-            const TArray<FRawAnimSequenceTrack>& AnimationData = AnimSequence->GetRawAnimationData();
-            const TArray<FTrackToSkeletonMap>& TrackToSkeMap = AnimSequence->GetRawTrackToSkeletonMapTable();
-
-            int32 NumberOfFrames = AnimSequence->GetNumberOfFrames();
-            *FileWriter << NumberOfFrames;
-
-            float SequenceLength = AnimSequence->SequenceLength;
-            *FileWriter << SequenceLength;
-
-            int32 TrackIndex = 0;
-            for (FRawAnimSequenceTrack SequenceTrack : AnimationData)
+            TSharedPtr<FAnimSequenceExportData, ESPMode::ThreadSafe> Data = FAnimSequenceExportData::Gather(AnimSequence);
+            if (Data.IsValid() && Data->Save(FullFilePathName))
             {
-                int32 BoneIndex = TrackToSkeMap[TrackIndex].BoneTreeIndex;
-                *FileWriter << BoneIndex;
-
-                *FileWriter << SequenceTrack.PosKeys;
-                *FileWriter << SequenceTrack.RotKeys;
-                *FileWriter << SequenceTrack.ScaleKeys;
+                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportAnimSequence: success."));
 
-                TrackIndex++;
+                return true;
             }
-
-            FileWriter->Close();
-            delete FileWriter;
-            FileWriter = nullptr;
-
         }
     }
 
-    UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportStaticMesh: failed."));
+    UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportAnimSequence: failed."));
 
     return false;
 
@@ -509,73 +910,51 @@ bool UObjectExporterBPLibrary::ExportMaterialInstance(const UMaterialInstance* M
     {
         if (FullFilePathName.EndsWith(JSON_FILE_POSTFIX))
         {
-            const int32 FileVersion = 1;
-            TSharedRef<FJsonObject> JsonRootObject = MakeShareable(new FJsonObject);
-            JsonRootObject->SetNumberField("FileVersion", FileVersion);
+            // The JSON only names the textures, they are not exported along
+            TArray<UTexture*> Textures;
+            TSharedPtr<FMaterialExportData, ESPMode::ThreadSafe> Data = FMaterialExportData::Gather(MaterialInstace, Textures);
+            if (Data.IsValid() && Data->SaveJson(FullFilePathName))
+            {
+                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportMaterialInstance: success."));
+
+                return true;
+            }
         }
         else if (FullFilePathName.EndsWith(MATERIAL_BINARY_FILE_POSTFIX))
         {
             // Save to binary file
-            IFileManager& FileManager = IFileManager::Get();
-            FArchive* FileWriter = FileManager.CreateFileWriter(*FullFilePathName);
-            if (nullptr == FileWriter)
-            {
-                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportMaterialInstance: CreateFileWriter failed."));
-
-                return false;
-            }
+            TArray<UTexture*> Textures;
+            TSharedPtr<FMaterialExportData, ESPMode::ThreadSafe> Data = FMaterialExportData::Gather(MaterialInstace, Textures);
 
-            FAssetToolsModule& AssetToolsModule = FModuleManager::GetModuleChecked<FAssetToolsModule>("AssetTools");
-            TArray<FMaterialParameterInfo> OutTextureParameterInfo;
-            TArray<FGuid> GuidsTexture;
-            MaterialInstace->GetAllTextureParameterInfo(OutTextureParameterInfo, GuidsTexture);
-            int32 BlendMode = (int32)MaterialInstace->BlendMode;
-            *FileWriter << BlendMode;
-            for (const FMaterialParameterInfo& ParameterInfo : OutTextureParameterInfo)
-            {
-                UTexture* Texture = nullptr;
-                MaterialInstace->GetTextureParameterValue(ParameterInfo, Texture);
-
-                if (Texture != nullptr)
-                {
-                    FString ResourceFullName = Texture->GetPathName();
-                    FString ResourcePath, ResourceName;
-                    ResourceFullName.Split(FString("."), &ResourcePath, &ResourceName);
+            TArray<UTexture*> UniqueTextures;
+            TSet<UTexture*> TextureSet;
+            AddUniqueTextures(Textures, UniqueTextures, TextureSet);
 
-                    *FileWriter << ResourceName;
+            FObjectExporterPipeline Pipeline;
+            QueueTextureExports(Pipeline, UniqueTextures, TArray<FObjectExporterCacheKey>());
 
-                    FString SavePath = FPaths::ProjectSavedDir() + TEXTURE_PATH;
-                    TArray<UObject*> ObjectsToExport;
-                    ObjectsToExport.Add(Texture);
-                    AssetToolsModule.Get().ExportAssets(ObjectsToExport, *SavePath);
-                }
-            }
-
-            TArray<FMaterialParameterInfo> OutScalarParameterInfo;
-            TArray<FGuid> GuidsScalar;
-            MaterialInstace->GetAllScalarParameterInfo(OutScalarParameterInfo, GuidsScalar);
-            for (const FMaterialParameterInfo& ParameterInfo : OutScalarParameterInfo)
+            const int32 NumFailedTextures = Pipeline.Flush();
+            if (NumFailedTextures > 0)
             {
-                float Opacity = 1.0f;
-                if (MaterialInstace->GetScalarParameterValue(ParameterInfo, Opacity))
-                {
-                    *FileWriter << Opacity;
-                }
+                UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportMaterialInstance: %d textures failed to export."), NumFailedTextures);
             }
 
-            FileWriter->Close();
-            delete FileWriter;
-            FileWriter = nullptr;
+            if (Data.IsValid() && Data->Save(FullFilePathName))
+            {
+                UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportMaterialInstance: success."));
 
+                return true;
+            }
         }
     }
 
-    UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportStaticMesh: failed."));
+    UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportMaterialInstance: failed."));
 
     return false;
 }
 
-bool UObjectExporterBPLibrary::ExportMap(UObject* WorldContextObject, const FString& FullFilePathName)
+/** ExportMap, or ExportMapRecords without bExportAssets. */
+static bool ExportMapFile(UObject* WorldContextObject, const FString& FullFilePathName, bool bExportAssets)
 {
     if (!IsValid(WorldContextObject) || !IsValid(WorldContextObject->GetWorld()))
     {
@@ -584,23 +963,26 @@ bool UObjectExporterBPLibrary::ExportMap(UObject* WorldContextObject, const FStr
 
     if (FullFilePathName.EndsWith(MAP_BINARY_FILE_POSTFIX))
     {
-        // Save to binary file
-        IFileManager& FileManager = IFileManager::Get();
-        FArchive* FileWriter = FileManager.CreateFileWriter(*FullFilePathName);
-        if (nullptr == FileWriter)
-        {
-            UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportMap: CreateFileWriter failed."));
+        UWorld* World = WorldContextObject->GetWorld();
 
-            return false;
+        ObjectExporterStats::BeginSession();
+
+        // Assets are gathered here on the game thread and written by the pipeline in parallel.
+        // Within a batch the writes continue while the next map is gathered.
+        TUniquePtr<FMapExportBatch> LocalBatch;
+        if (!MapExportBatch.IsValid())
+        {
+            LocalBatch = MakeUnique<FMapExportBatch>(bExportAssets && CVarObjectExporterUseExportCache.GetValueOnGameThread() != 0);
         }
+        FMapExportContext Context(LocalBatch.IsValid() ? *LocalBatch : *MapExportBatch);
+        Context.bExportAssets = bExportAssets;
 
-        UWorld* World = WorldContextObject->GetWorld();
+        // Save to binary file
+        FObjectExporterFileWriter FileWriter(ObjectExporterFile::Map);
 
         TArray<AActor*> AllCameraActors;
         UGameplayStatics::GetAllActorsOfClass(World, ACameraActor::StaticClass(), AllCameraActors);
-        int32 CameraCount = AllCameraActors.Num();
-
-        *FileWriter << CameraCount;
+        TArray<FObjectExporterCamera> Cameras;
 
         for (AActor* Actor : AllCameraActors)
         {
@@ -609,198 +991,393 @@ bool UObjectExporterBPLibrary::ExportMap(UObject* WorldContextObject, const FStr
             auto Transform = Component->GetComponentToWorld();
             auto Location = Transform.GetLocation();
             auto Rotation = Transform.GetRotation();
-            auto Rotator = Rotation.Rotator();
             auto Direction = Rotation.Vector();
             auto Target = Location + Direction * 100.0f;
-            auto FOV = Component->FieldOfView;
-            auto AspectRatio = Component->AspectRatio;
 
-            *FileWriter << Location;
-            *FileWriter << Target;
-            *FileWriter << FOV;
-            *FileWriter << AspectRatio;
+            FObjectExporterCamera& Camera = Cameras.AddZeroed_GetRef();
+            ObjectExporterFile::CopyVector(Camera.Location, Location);
+            ObjectExporterFile::CopyVector(Camera.Target, Target);
+            Camera.FOV = Component->FieldOfView;
+            Camera.AspectRatio = Component->AspectRatio;
         }
 
         TArray<AActor*> AllDirectionalLightActors;
         UGameplayStatics::GetAllActorsOfClass(World, ADirectionalLight::StaticClass(), AllDirectionalLightActors);
-        int32 DirectionalLightCount = AllDirectionalLightActors.Num();
-
-        *FileWriter << DirectionalLightCount;
+        TArray<FObjectExporterDirectionalLight> DirectionalLights;
 
         for (AActor* Actor : AllDirectionalLightActors)
         {
             UDirectionalLightComponent* Component = Cast<UDirectionalLightComponent>(Actor->GetComponentByClass(UDirectionalLightComponent::StaticClass()));
             check(Component != nullptr);
             auto Transform = Component->GetComponentToWorld();
-            auto Location = Transform.GetLocation();
             auto Rotation = Transform.GetRotation();
-            auto Rotator = Rotation.Rotator();
             auto Direction = Rotation.Vector();
-            auto Color = FLinearColor::FromSRGBColor(Component->LightColor);
-            auto Intensity = Component->Intensity;
 
-            *FileWriter << Color;
-            *FileWriter << Direction;
-            *FileWriter << Intensity;
+            FObjectExporterDirectionalLight& Light = DirectionalLights.AddZeroed_GetRef();
+            ObjectExporterFile::CopyColor(Light.Color, FLinearColor::FromSRGBColor(Component->LightColor));
+            ObjectExporterFile::CopyVector(Light.Direction, Direction);
+            Light.Intensity = Component->Intensity;
         }
 
+        FMapRecords Records;
+
         TArray<AActor*> AllPointLightActors;
         UGameplayStatics::GetAllActorsOfClass(World, APointLight::StaticClass(), AllPointLightActors);
-        int32 PointLightCount = AllPointLightActors.Num();
-
-        *FileWriter << PointLightCount;
 
         for (AActor* Actor : AllPointLightActors)
         {
             UPointLightComponent* Component = Cast<UPointLightComponent>(Actor->GetComponentByClass(UPointLightComponent::StaticClass()));
             check(Component != nullptr);
             auto Transform = Component->GetComponentToWorld();
-            auto Location = Transform.GetLocation();
-            auto AttenuationRadius = Component->AttenuationRadius;
-            auto LightFalloffExponent = Component->LightFalloffExponent;
-            auto Color = FLinearColor::FromSRGBColor(Component->LightColor);
-            auto Intensity = Component->Intensity;
 
-            *FileWriter << Color;
-            *FileWriter << Location;
-            *FileWriter << Intensity;
-            *FileWriter << AttenuationRadius;
-            *FileWriter << LightFalloffExponent;
+            FObjectExporterPointLight& Light = Records.PointLights.AddZeroed_GetRef();
+            ObjectExporterFile::CopyColor(Light.Color, FLinearColor::FromSRGBColor(Component->LightColor));
+            ObjectExporterFile::CopyVector(Light.Location, Transform.GetLocation());
+            Light.Intensity = Component->Intensity;
+            Light.AttenuationRadius = Component->AttenuationRadius;
+            Light.LightFalloffExponent = Component->LightFalloffExponent;
+
+            const FSphere LightSphere(Transform.GetLocation(), Component->AttenuationRadius);
+            Records.PointLightBounds.Add(FBoxSphereBounds(LightSphere));
         }
 
+        // Static mesh actors and instanced components (including foliage) are grouped by (mesh, materials) into instance batches
+        TArray<UStaticMeshComponent*> StaticMeshComponents;
 
         TArray<AActor*> AllStaticMeshActors;
         UGameplayStatics::GetAllActorsOfClass(World, AStaticMeshActor::StaticClass(), AllStaticMeshActors);
-        int32 StaticMeshActorCount = AllStaticMeshActors.Num();
-
-        *FileWriter << StaticMeshActorCount;
 
         for (AActor* Actor : AllStaticMeshActors)
         {
             UStaticMeshComponent* Component = Cast<UStaticMeshComponent>(Actor->GetComponentByClass(UStaticMeshComponent::StaticClass()));
             check(Component != nullptr);
-            auto Transform = Component->GetComponentToWorld();
-            auto Location = Transform.GetLocation();
-            auto Rotation = Transform.GetRotation();
-            auto Rotator = Rotation.Rotator();
-            auto Direction = Rotation.Vector();
+            StaticMeshComponents.Add(Component);
+        }
+
+        for (TActorIterator<AActor> ActorIt(World); ActorIt; ++ActorIt)
+        {
+            TInlineComponentArray<UInstancedStaticMeshComponent*> InstancedComponents(*ActorIt);
+            StaticMeshComponents.Append(InstancedComponents);
+        }
+
+        TArray<FStaticMeshInstanceBatch>& InstanceBatches = Records.InstanceBatches;
+        TMap<FString, int32> InstanceBatchIndices;
+
+        for (UStaticMeshComponent* Component : StaticMeshComponents)
+        {
+            UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component);
+            if (Component->GetStaticMesh() == nullptr
+                || (InstancedComponent != nullptr && InstancedComponent->GetInstanceCount() == 0))
+            {
+                continue;
+            }
+
             auto ResourceFullName = Component->GetStaticMesh()->GetPathName();
-            auto MaterialFullName = Component->GetMaterial(0)->GetPathName();
 
             FString ResourcePath, ResourceName;
             ResourceFullName.Split(FString("."), &ResourcePath, &ResourceName);
 
-            FString MaterialPath, MaterialName;
-            MaterialFullName.Split(FString("."), &MaterialPath, &MaterialName);
+            TArray<FString> MaterialNames;
+            QueueComponentMaterials(Context, Component, MaterialNames);
 
-            *FileWriter << Rotation;
-            *FileWriter << Location;
-            *FileWriter << ResourceName;
-            *FileWriter << MaterialName;
-
-            FString SaveStaticMeshPath = FPaths::ProjectSavedDir() + STATICMESH_PATH + ResourceName + STATIC_MESH_BINARY_FILE_POSTFIX;
-            ExportStaticMesh(Component->GetStaticMesh(), SaveStaticMeshPath);
+            const FString BatchKey = ResourceName + TEXT("|") + FString::Join(MaterialNames, TEXT("|"));
+            int32* BatchIndex = InstanceBatchIndices.Find(BatchKey);
+            if (BatchIndex == nullptr)
+            {
+                BatchIndex = &InstanceBatchIndices.Add(BatchKey, InstanceBatches.Num());
 
-            TArray<UMaterialInterface*> Materials = Component->GetMaterials();
+                FStaticMeshInstanceBatch& NewBatch = InstanceBatches.AddDefaulted_GetRef();
+                NewBatch.ResourceName = ResourceName;
+                NewBatch.MaterialNames = MaterialNames;
+            }
 
-            for (UMaterialInterface* Material : Materials)
+            FStaticMeshInstanceBatch& Batch = InstanceBatches[*BatchIndex];
+            const FBoxSphereBounds MeshBounds = Component->GetStaticMesh()->GetBounds();
+            if (InstancedComponent != nullptr)
             {
-                UMaterialInstance* Instance = Cast<UMaterialInstance>(Material);
-                if (Instance->IsValidLowLevel())
+                for (int32 InstanceIndex = 0; InstanceIndex < InstancedComponent->GetInstanceCount(); InstanceIndex++)
                 {
-                    FString SaveMaterialPath = FPaths::ProjectSavedDir() + MATERIAL_PATH + MaterialName + MATERIAL_BINARY_FILE_POSTFIX;
-
-                    ExportMaterialInstance(Instance, SaveMaterialPath);
+                    FTransform InstanceTransform;
+                    InstancedComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, true);
+                    Batch.Transforms.Add(InstanceTransform);
+                    Batch.Bounds.Add(MeshBounds.TransformBy(InstanceTransform));
                 }
             }
-                
+            else
+            {
+                Batch.Transforms.Add(Component->GetComponentToWorld());
+                Batch.Bounds.Add(MeshBounds.TransformBy(Component->GetComponentToWorld()));
+            }
+
+            FString SaveStaticMeshPath = FPaths::ProjectSavedDir() + STATICMESH_PATH + ResourceName + STATIC_MESH_BINARY_FILE_POSTFIX;
+            QueueAssetExport<FStaticMeshExportData>(Context, Component->GetStaticMesh(), SaveStaticMeshPath);
         }
 
         TArray<AActor*> AllSkeletalMeshActors;
         UGameplayStatics::GetAllActorsOfClass(World, ASkeletalMeshActor::StaticClass(), AllSkeletalMeshActors);
-        int32 SkeletalMeshActorCount = AllSkeletalMeshActors.Num();
-
-        *FileWriter << SkeletalMeshActorCount;
 
         for (AActor* Actor : AllSkeletalMeshActors)
         {
             USkeletalMeshComponent* Component = Cast<USkeletalMeshComponent>(Actor->GetComponentByClass(USkeletalMeshComponent::StaticClass()));
-            check(Component != nullptr);
+            USkeletalMesh* SkeletalMesh = Component != nullptr ? Component->SkeletalMesh : nullptr;
+            if (SkeletalMesh == nullptr || SkeletalMesh->Skeleton == nullptr)
+            {
+                UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportMap: %s has no skeletal mesh with a skeleton, skipped."), *Actor->GetName());
+
+                continue;
+            }
+
             auto Transform = Component->GetComponentToWorld();
-            auto Location = Transform.GetLocation();
-            auto Rotation = Transform.GetRotation();
-            auto Rotator = Rotation.Rotator();
-            auto Direction = Rotation.Vector();
-            auto ResourceFullName = Component->SkeletalMesh->GetPathName();
-            auto AnimationFullName = Component->AnimationData.AnimToPlay->GetPathName();
-            auto MaterialFullName = Component->GetMaterial(0)->GetPathName();
+            auto ResourceFullName = SkeletalMesh->GetPathName();
 
             FString ResourcePath, ResourceName;
             ResourceFullName.Split(FString("."), &ResourcePath, &ResourceName);
 
+            // Actors without a single node animation sequence are written in their reference pose
+            UAnimSequence* AnimSequence = Cast<UAnimSequence>(Component->AnimationData.AnimToPlay);
             FString AnimationPath, AnimationName;
-            AnimationFullName.Split(FString("."), &AnimationPath, &AnimationName);
+            if (AnimSequence != nullptr)
+            {
+                AnimSequence->GetPathName().Split(FString("."), &AnimationPath, &AnimationName);
+            }
+            else
+            {
+                UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportMap: %s plays no animation sequence, exported without animation."), *Actor->GetName());
+            }
+
+            FMapSkeletalMeshActor& SkeletalMeshActor = Records.SkeletalMeshActors.AddDefaulted_GetRef();
+            SkeletalMeshActor.Transform = Transform;
+            SkeletalMeshActor.ResourceName = ResourceName;
+            SkeletalMeshActor.AnimationName = AnimationName;
+            QueueComponentMaterials(Context, Component, SkeletalMeshActor.MaterialNames);
+
+            // Bounds of the reference pose, the runtime inflates them if animations leave them
+            SkeletalMeshActor.Bounds = Component->CalcBounds(Transform);
+
+            FString SaveSkeletalMeshPath = FPaths::ProjectSavedDir() + SKELETALMESH_PATH + ResourceName + SKELETAL_MESH_BINARY_FILE_POSTFIX;
+            QueueAssetExport<FSkeletalMeshExportData>(Context, SkeletalMesh, SaveSkeletalMeshPath, { SkeletalMesh->Skeleton });
+
+            auto SkeletonFullName = SkeletalMesh->Skeleton->GetPathName();
 
-            FString MaterialPath, MaterialName;
-            MaterialFullName.Split(FString("."), &MaterialPath, &MaterialName);
+            FString SkeletonPath, SkeletonName;
+            SkeletonFullName.Split(FString("."), &SkeletonPath, &SkeletonName);
+            SkeletalMeshActor.SkeletonName = SkeletonName;
 
-            *FileWriter << Rotation;
-            *FileWriter << Location;
-            *FileWriter << ResourceName;
-            *FileWriter << AnimationName;
-            *FileWriter << MaterialName;
+            FString SaveSkeletonPath = FPaths::ProjectSavedDir() + SKELETON_PATH + SkeletonName + SKELETON_BINARY_FILE_POSTFIX;
+            QueueAssetExport<FSkeletonExportData>(Context, SkeletalMesh->Skeleton, SaveSkeletonPath);
 
-            TArray<UTexture*> MaterialTextures;
-            Component->GetUsedTextures(MaterialTextures, EMaterialQualityLevel::Num);
-            FAssetToolsModule& AssetToolsModule = FModuleManager::GetModuleChecked<FAssetToolsModule>("AssetTools");
-            for (UTexture* Texture : MaterialTextures)
+            if (AnimSequence != nullptr)
             {
-                FString SavePath = FPaths::ProjectSavedDir() + TEXTURE_PATH;
-                TArray<UObject*> ObjectsToExport;
-                ObjectsToExport.Add(Texture);
-                AssetToolsModule.Get().ExportAssets(ObjectsToExport, *SavePath);
+                FString SaveAnimSequencePath = FPaths::ProjectSavedDir() + ANIMATION_PATH + AnimationName + ANIMSEQUENCE_BINARY_FILE_POSTFIX;
+                QueueAssetExport<FAnimSequenceExportData>(Context, AnimSequence, SaveAnimSequencePath);
             }
+        }
 
-            FString SaveSkeletalMeshPath = FPaths::ProjectSavedDir() + SKELETALMESH_PATH + ResourceName + SKELETAL_MESH_BINARY_FILE_POSTFIX;
-            ExportSkeletalMesh(Component->SkeletalMesh, SaveSkeletalMeshPath);
+        QueueMapTextures(Context, Context.Textures);
 
-            TArray<UMaterialInterface*> Materials = Component->GetMaterials();
+        // The map file only depends on the actors gathered above, so it is identical however the assets get scheduled
+        // Within a batch, EndMapExportBatch reports the failed assets
+        const int32 NumFailedAssets = LocalBatch.IsValid() ? LocalBatch->Flush() : 0;
 
-            for (UMaterialInterface* Material : Materials)
-            {
-                UMaterialInstance* Instance = Cast<UMaterialInstance>(Material);
-                if (Instance->IsValidLowLevel())
-                {
-                    FString SaveMaterialPath = FPaths::ProjectSavedDir() + MATERIAL_PATH + MaterialName + MATERIAL_BINARY_FILE_POSTFIX;
+        FileWriter.AddChunk(ObjectExporterChunk::Cameras, Cameras);
+        FileWriter.AddChunk(ObjectExporterChunk::DirectionalLights, DirectionalLights);
 
-                    ExportMaterialInstance(Instance, SaveMaterialPath);
-                }
+        TArray<FObjectExporterMapMaterial> MapMaterials;
+        TArray<FObjectExporterMaterialTexture> MaterialTextures;
+        for (const FMapMaterial& Material : Context.Materials)
+        {
+            FObjectExporterMapMaterial& MapMaterial = MapMaterials.AddZeroed_GetRef();
+            MapMaterial.Name = FileWriter.AddString(Material.Name);
+            MapMaterial.FirstTexture = MaterialTextures.Num();
+            MapMaterial.NumTextures = Material.Textures.Num();
+
+            for (const FMapMaterialTexture& Texture : Material.Textures)
+            {
+                FObjectExporterMaterialTexture& MaterialTexture = MaterialTextures.AddZeroed_GetRef();
+                MaterialTexture.Name = FileWriter.AddString(Texture.Name);
+                MaterialTexture.SamplingScale = Texture.SamplingScale;
+                MaterialTexture.UVChannel = Texture.UVChannel;
             }
+        }
 
-            auto SkeletonFullName = Component->SkeletalMesh->Skeleton->GetPathName();
+        FileWriter.AddChunk(ObjectExporterChunk::MapMaterials, MapMaterials);
+        FileWriter.AddChunk(ObjectExporterChunk::MaterialTextures, MaterialTextures);
 
-            FString SkeletonPath, SkeletonName;
-            SkeletonFullName.Split(FString("."), &SkeletonPath, &SkeletonName);
+        // Partitioned maps keep the cameras, directional lights and materials, everything else goes to the cells
+        const float CellSize = CVarObjectExporterMapCellSize.GetValueOnGameThread();
+        TMap<FIntPoint, FMapRecordSelection> Cells;
+        SelectMapRecords(Records, CellSize, Cells);
 
-            FString SaveSkeletonPath = FPaths::ProjectSavedDir() + SKELETON_PATH + SkeletonName + SKELETON_BINARY_FILE_POSTFIX;
-            ExportSkeleton(Component->SkeletalMesh->Skeleton, SaveSkeletonPath);
- 
-            FString SaveAnimSequencePath = FPaths::ProjectSavedDir() + ANIMATION_PATH + AnimationName + ANIMSEQUENCE_BINARY_FILE_POSTFIX;
-            ExportAnimSequence(Cast<UAnimSequence>(Component->AnimationData.AnimToPlay), SaveAnimSequencePath);
+        if (CellSize > 0.0f)
+        {
+            const int32 NumCells = AddMapCellChunks(FileWriter, Context, Records, CellSize, Cells);
+            UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportMap: %d cells of %.0f units."), NumCells, CellSize);
+        }
+        else
+        {
+            AddMapRecordChunks(FileWriter, Records, Cells.FindOrAdd(FIntPoint(0, 0)));
         }
 
+        const bool bSuccess = FileWriter.SaveToFile(FullFilePathName);
 
-        FileWriter->Close();
-        delete FileWriter;
-        FileWriter = nullptr;
+        ObjectExporterStats::EndSession(FString::Printf(TEXT("ExportMap %s"), *World->GetMapName()));
 
-        UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportMap: success."));
+        if (bSuccess)
+        {
+            ExportedMapFiles.Add(World->GetOutermost()->GetName(), FullFilePathName);
+        }
 
-        return true;
+        if (bSuccess && NumFailedAssets == 0)
+        {
+            UE_LOG(ObjectExporterBPLibraryLog, Log, TEXT("ExportMap: success."));
 
+            return true;
+        }
+
+        if (bSuccess)
+        {
+            UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportMap: map written, but %d of its assets failed."), NumFailedAssets);
+
+            return false;
+        }
     }
 
     UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("ExportMap: failed."));
 
     return false;
 }
+
+bool UObjectExporterBPLibrary::ExportMap(UObject* WorldContextObject, const FString& FullFilePathName)
+{
+    return ExportMapFile(WorldContextObject, FullFilePathName, true);
+}
+
+bool UObjectExporterBPLibrary::ExportMapRecords(UObject* WorldContextObject, const FString& FullFilePathName)
+{
+    return ExportMapFile(WorldContextObject, FullFilePathName, false);
+}
+
+FString UObjectExporterBPLibrary::GetMapFilePathName(const UWorld* World)
+{
+    const FString PackageName = World->GetOutermost()->GetName();
+    if (const FString* FilePathName = ExportedMapFiles.Find(PackageName))
+    {
+        return *FilePathName;
+    }
+
+    return FPaths::ProjectSavedDir() + MAP_PATH + FPackageName::GetShortName(PackageName) + MAP_BINARY_FILE_POSTFIX;
+}
+
+FString UObjectExporterBPLibrary::GetAssetFilePathName(const UObject* Asset)
+{
+    FString ResourcePath, ResourceName;
+    if (Asset == nullptr || !Asset->GetPathName().Split(FString("."), &ResourcePath, &ResourceName))
+    {
+        return FString();
+    }
+
+    if (Asset->IsA<UStaticMesh>())
+    {
+        return FPaths::ProjectSavedDir() + STATICMESH_PATH + ResourceName + STATIC_MESH_BINARY_FILE_POSTFIX;
+    }
+    if (Asset->IsA<USkeletalMesh>())
+    {
+        return FPaths::ProjectSavedDir() + SKELETALMESH_PATH + ResourceName + SKELETAL_MESH_BINARY_FILE_POSTFIX;
+    }
+    if (Asset->IsA<USkeleton>())
+    {
+        return FPaths::ProjectSavedDir() + SKELETON_PATH + ResourceName + SKELETON_BINARY_FILE_POSTFIX;
+    }
+    if (Asset->IsA<UAnimSequence>())
+    {
+        return FPaths::ProjectSavedDir() + ANIMATION_PATH + ResourceName + ANIMSEQUENCE_BINARY_FILE_POSTFIX;
+    }
+    if (Asset->IsA<UMaterialInstance>())
+    {
+        return FPaths::ProjectSavedDir() + MATERIAL_PATH + ResourceName + MATERIAL_BINARY_FILE_POSTFIX;
+    }
+    if (const UTexture* Texture = Cast<UTexture>(Asset))
+    {
+        return GetTextureFilePathName(Texture);
+    }
+
+    return FString();
+}
+
+int32 UObjectExporterBPLibrary::ExportAssets(const TArray<UObject*>& Assets, TArray<FString>& OutFilePathNames)
+{
+    ObjectExporterStats::BeginSession();
+
+    FMapExportBatch Batch(CVarObjectExporterUseExportCache.GetValueOnGameThread() != 0);
+    FMapExportContext Context(Batch);
+
+    // Only the given textures, not every texture of the given materials
+    TArray<UTexture*> Textures;
+
+    for (UObject* Asset : Assets)
+    {
+        const FString FilePathName = GetAssetFilePathName(Asset);
+
+        if (const UStaticMesh* StaticMesh = Cast<UStaticMesh>(Asset))
+        {
+            QueueAssetExport<FStaticMeshExportData>(Context, StaticMesh, FilePathName);
+        }
+        else if (const USkeletalMesh* SkeletalMesh = Cast<USkeletalMesh>(Asset))
+        {
+            QueueAssetExport<FSkeletalMeshExportData>(Context, SkeletalMesh, FilePathName, { SkeletalMesh->Skeleton });
+        }
+        else if (const USkeleton* Skeleton = Cast<USkeleton>(Asset))
+        {
+            QueueAssetExport<FSkeletonExportData>(Context, Skeleton, FilePathName);
+        }
+        else if (const UAnimSequence* AnimSequence = Cast<UAnimSequence>(Asset))
+        {
+            QueueAssetExport<FAnimSequenceExportData>(Context, AnimSequence, FilePathName);
+        }
+        else if (const UMaterialInstance* MaterialInstance = Cast<UMaterialInstance>(Asset))
+        {
+            QueueMaterialExport(Context, MaterialInstance, FilePathName);
+        }
+        else if (UTexture* Texture = Cast<UTexture>(Asset))
+        {
+            Textures.AddUnique(Texture);
+        }
+    }
+
+    QueueMapTextures(Context, Textures);
+
+    const int32 NumFailedAssets = Batch.Flush(&OutFilePathNames);
+
+    ObjectExporterStats::EndSession(TEXT("ExportAssets"));
+
+    return NumFailedAssets;
+}
+
+void UObjectExporterBPLibrary::BeginMapExportBatch()
+{
+    check(IsInGameThread() && !MapExportBatch.IsValid());
+
+    MapExportBatch = MakeUnique<FMapExportBatch>(CVarObjectExporterUseExportCache.GetValueOnGameThread() != 0);
+}
+
+int32 UObjectExporterBPLibrary::EndMapExportBatch()
+{
+    check(IsInGameThread() && MapExportBatch.IsValid());
+
+    const int32 NumFailedAssets = MapExportBatch->Flush();
+    MapExportBatch.Reset();
+
+    return NumFailedAssets;
+}
+
+bool UObjectExporterBPLibrary::BenchmarkAnimSequenceSampling(const UAnimSequence* AnimSequence, int32 NumPoses)
+{
+    if (ObjectExporterAnimSampler::RunBenchmark(AnimSequence, NumPoses))
+    {
+        return true;
+    }
+
+    UE_LOG(ObjectExporterBPLibraryLog, Warning, TEXT("BenchmarkAnimSequenceSampling: failed."));
+
+    return false;
+}
@@ -0,0 +1,312 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterCache.h"
+#include "ObjectExporterFileFormat.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/SecureHash.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/Package.h"
+
+DECLARE_LOG_CATEGORY_CLASS(ObjectExporterCacheLog, Log, All);
+
+#define EXPORT_CACHE_MANIFEST_FILE "Bin/ExportCache.json"
+
+static void UpdateHash(FMD5& Md5, const FString& String)
+{
+    Md5.Update(reinterpret_cast<const uint8*>(*String), String.Len() * sizeof(TCHAR));
+}
+
+/*
+*   Console variables that change the bytes of exported assets, part of every key. Scheduling, cache, map and
+*   live export settings do not and are left out. A new output setting has to be added here.
+*/
+static const TCHAR* const OutputConsoleVariableNames[] =
+{
+    TEXT("ObjectExporter.AnimFrameMajorLayout"),
+    TEXT("ObjectExporter.AnimPositionTolerance"),
+    TEXT("ObjectExporter.AnimRotationTolerance"),
+    TEXT("ObjectExporter.AnimScaleTolerance"),
+    TEXT("ObjectExporter.CompressAnimations"),
+    TEXT("ObjectExporter.GenerateLODs"),
+    TEXT("ObjectExporter.GenerateMeshlets"),
+    TEXT("ObjectExporter.GeneratedLODMaxError"),
+    TEXT("ObjectExporter.GeneratedLODTriangleRatio"),
+    TEXT("ObjectExporter.OptimizeMeshes"),
+    TEXT("ObjectExporter.PositionErrorBudget"),
+    TEXT("ObjectExporter.QuantizeVertices"),
+    TEXT("ObjectExporter.TextureResidentMipSize"),
+    TEXT("ObjectExporter.TextureTargetPlatform"),
+    TEXT("ObjectExporter.UVErrorBudget"),
+};
+
+FObjectExporterCache::FObjectExporterCache()
+{
+    TArray<FString> Settings;
+    for (const TCHAR* Name : OutputConsoleVariableNames)
+    {
+        IConsoleVariable* ConsoleVariable = IConsoleManager::Get().FindConsoleVariable(Name);
+        if (ensureMsgf(ConsoleVariable != nullptr, TEXT("%s is not registered."), Name))
+        {
+            Settings.Add(FString::Printf(TEXT("%s=%s"), Name, *ConsoleVariable->GetString()));
+        }
+    }
+    Settings.Add(FString::Printf(TEXT("FileVersion=%d"), (int32)EObjectExporterFileVersion::Latest));
+
+    FMD5 Md5;
+    for (const FString& Setting : Settings)
+    {
+        UpdateHash(Md5, Setting);
+    }
+
+    FMD5Hash Hash;
+    Hash.Set(Md5);
+    SettingsHash = LexToString(Hash);
+}
+
+FString FObjectExporterCache::GetManifestFilePathName()
+{
+    return FPaths::ProjectSavedDir() + EXPORT_CACHE_MANIFEST_FILE;
+}
+
+FString FObjectExporterCache::GetRelativePath(const FString& FilePathName)
+{
+    FString RelativePath = FPaths::ConvertRelativePathToFull(FilePathName);
+    FPaths::MakePathRelativeTo(RelativePath, *FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir()));
+
+    return RelativePath;
+}
+
+void FObjectExporterCache::LoadManifest()
+{
+    FString JsonContent;
+    if (!FFileHelper::LoadFileToString(JsonContent, *GetManifestFilePathName()))
+    {
+        return;
+    }
+
+    TSharedPtr<FJsonObject> JsonRootObject;
+    TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(JsonContent);
+    if (!FJsonSerializer::Deserialize(JsonReader, JsonRootObject) || !JsonRootObject.IsValid())
+    {
+        UE_LOG(ObjectExporterCacheLog, Warning, TEXT("LoadManifest: %s is not valid, starting with an empty cache."), *GetManifestFilePathName());
+
+        return;
+    }
+
+    // A damaged entry discards the whole manifest, the next export then starts cold
+    TMap<FString, FOutputEntry> LoadedOutputs;
+    TMap<FString, FPackageEntry> LoadedPackages;
+
+    const TSharedPtr<FJsonObject>* JsonOutputs = nullptr;
+    if (JsonRootObject->TryGetObjectField(TEXT("Outputs"), JsonOutputs))
+    {
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& JsonOutput : (*JsonOutputs)->Values)
+        {
+            const TSharedPtr<FJsonObject>* JsonEntry = nullptr;
+            FOutputEntry Entry;
+            FString OutputSize, OutputTimeStamp;
+            if (!JsonOutput.Value.IsValid() || !JsonOutput.Value->TryGetObject(JsonEntry)
+                || !(*JsonEntry)->TryGetStringField(TEXT("Asset"), Entry.AssetPath)
+                || !(*JsonEntry)->TryGetStringField(TEXT("SourceHash"), Entry.SourceHash)
+                || !(*JsonEntry)->TryGetStringField(TEXT("OutputHash"), Entry.OutputHash)
+                || !(*JsonEntry)->TryGetStringField(TEXT("OutputSize"), OutputSize)
+                || !(*JsonEntry)->TryGetStringField(TEXT("OutputTimeStamp"), OutputTimeStamp))
+            {
+                UE_LOG(ObjectExporterCacheLog, Warning, TEXT("LoadManifest: output %s in %s is not valid, starting with an empty cache."), *JsonOutput.Key, *GetManifestFilePathName());
+
+                return;
+            }
+
+            Entry.OutputSize = FCString::Atoi64(*OutputSize);
+            Entry.OutputTimeStamp = FCString::Atoi64(*OutputTimeStamp);
+            LoadedOutputs.Add(JsonOutput.Key, MoveTemp(Entry));
+        }
+    }
+
+    const TSharedPtr<FJsonObject>* JsonPackages = nullptr;
+    if (JsonRootObject->TryGetObjectField(TEXT("Packages"), JsonPackages))
+    {
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& JsonPackage : (*JsonPackages)->Values)
+        {
+            const TSharedPtr<FJsonObject>* JsonEntry = nullptr;
+            FPackageEntry Entry;
+            FString Size, TimeStamp;
+            if (!JsonPackage.Value.IsValid() || !JsonPackage.Value->TryGetObject(JsonEntry)
+                || !(*JsonEntry)->TryGetStringField(TEXT("Hash"), Entry.Hash)
+                || !(*JsonEntry)->TryGetStringField(TEXT("Size"), Size)
+                || !(*JsonEntry)->TryGetStringField(TEXT("TimeStamp"), TimeStamp))
+            {
+                UE_LOG(ObjectExporterCacheLog, Warning, TEXT("LoadManifest: package %s in %s is not valid, starting with an empty cache."), *JsonPackage.Key, *GetManifestFilePathName());
+
+                return;
+            }
+
+            Entry.Size = FCString::Atoi64(*Size);
+            Entry.TimeStamp = FCString::Atoi64(*TimeStamp);
+            LoadedPackages.Add(JsonPackage.Key, MoveTemp(Entry));
+        }
+    }
+
+    Outputs = MoveTemp(LoadedOutputs);
+    Packages = MoveTemp(LoadedPackages);
+}
+
+bool FObjectExporterCache::SaveManifest() const
+{
+    FScopeLock Lock(&OutputsCritical);
+
+    TSharedRef<FJsonObject> JsonRootObject = MakeShareable(new FJsonObject);
+
+    TSharedRef<FJsonObject> JsonOutputs = MakeShareable(new FJsonObject);
+    for (const TPair<FString, FOutputEntry>& Output : Outputs)
+    {
+        TSharedRef<FJsonObject> JsonEntry = MakeShareable(new FJsonObject);
+        JsonEntry->SetStringField(TEXT("Asset"), Output.Value.AssetPath);
+        JsonEntry->SetStringField(TEXT("SourceHash"), Output.Value.SourceHash);
+        JsonEntry->SetStringField(TEXT("OutputHash"), Output.Value.OutputHash);
+        JsonEntry->SetStringField(TEXT("OutputSize"), LexToString(Output.Value.OutputSize));
+        JsonEntry->SetStringField(TEXT("OutputTimeStamp"), LexToString(Output.Value.OutputTimeStamp));
+        JsonOutputs->SetObjectField(Output.Key, JsonEntry);
+    }
+    JsonRootObject->SetObjectField(TEXT("Outputs"), JsonOutputs);
+
+    TSharedRef<FJsonObject> JsonPackages = MakeShareable(new FJsonObject);
+    for (const TPair<FString, FPackageEntry>& Package : Packages)
+    {
+        TSharedRef<FJsonObject> JsonEntry = MakeShareable(new FJsonObject);
+        JsonEntry->SetStringField(TEXT("Hash"), Package.Value.Hash);
+        JsonEntry->SetStringField(TEXT("Size"), LexToString(Package.Value.Size));
+        JsonEntry->SetStringField(TEXT("TimeStamp"), LexToString(Package.Value.TimeStamp));
+        JsonPackages->SetObjectField(Package.Key, JsonEntry);
+    }
+    JsonRootObject->SetObjectField(TEXT("Packages"), JsonPackages);
+
+    FString JsonContent;
+    TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&JsonContent, 0);
+    if (FJsonSerializer::Serialize(JsonRootObject, JsonWriter))
+    {
+        return FFileHelper::SaveStringToFile(JsonContent, *GetManifestFilePathName());
+    }
+
+    return false;
+}
+
+FString FObjectExporterCache::GetPackageHash(const UPackage* Package)
+{
+    if (Package == nullptr || Package->IsDirty())
+    {
+        return FString();
+    }
+
+    FString PackageFileName;
+    if (!FPackageName::DoesPackageExist(Package->GetName(), nullptr, &PackageFileName))
+    {
+        return FString();
+    }
+
+    FFileStatData StatData = IFileManager::Get().GetStatData(*PackageFileName);
+    if (!StatData.bIsValid)
+    {
+        return FString();
+    }
+
+    FPackageEntry& Entry = Packages.FindOrAdd(Package->GetName());
+    if (Entry.Hash.IsEmpty() || Entry.Size != StatData.FileSize || Entry.TimeStamp != StatData.ModificationTime.GetTicks())
+    {
+        Entry.Hash = LexToString(FMD5Hash::HashFile(*PackageFileName));
+        Entry.Size = StatData.FileSize;
+        Entry.TimeStamp = StatData.ModificationTime.GetTicks();
+    }
+
+    return Entry.Hash;
+}
+
+FObjectExporterCacheKey FObjectExporterCache::ComputeKey(const UObject* Asset, const TArray<const UObject*>& Dependencies)
+{
+    check(IsInGameThread());
+
+    FObjectExporterCacheKey Key;
+    if (Asset == nullptr)
+    {
+        return Key;
+    }
+
+    Key.AssetPath = Asset->GetPathName();
+
+    FMD5 Md5;
+    UpdateHash(Md5, SettingsHash);
+    UpdateHash(Md5, Key.AssetPath);
+
+    TArray<const UObject*> Sources;
+    Sources.Add(Asset);
+    Sources.Append(Dependencies);
+
+    for (const UObject* Source : Sources)
+    {
+        FString PackageHash = Source != nullptr ? GetPackageHash(Source->GetOutermost()) : FString();
+        if (PackageHash.IsEmpty())
+        {
+            // Unsaved or transient source, always export
+            return Key;
+        }
+
+        UpdateHash(Md5, PackageHash);
+    }
+
+    FMD5Hash Hash;
+    Hash.Set(Md5);
+    Key.SourceHash = LexToString(Hash);
+
+    return Key;
+}
+
+bool FObjectExporterCache::IsUpToDate(const FString& OutputFilePathName, const FObjectExporterCacheKey& Key) const
+{
+    if (!Key.IsValid())
+    {
+        return false;
+    }
+
+    FScopeLock Lock(&OutputsCritical);
+
+    const FOutputEntry* Entry = Outputs.Find(GetRelativePath(OutputFilePathName));
+    if (Entry == nullptr || Entry->SourceHash != Key.SourceHash)
+    {
+        return false;
+    }
+
+    FFileStatData StatData = IFileManager::Get().GetStatData(*OutputFilePathName);
+
+    return StatData.bIsValid && StatData.FileSize == Entry->OutputSize && StatData.ModificationTime.GetTicks() == Entry->OutputTimeStamp;
+}
+
+void FObjectExporterCache::Update(const FString& OutputFilePathName, const FObjectExporterCacheKey& Key)
+{
+    if (!Key.IsValid())
+    {
+        return;
+    }
+
+    FFileStatData StatData = IFileManager::Get().GetStatData(*OutputFilePathName);
+    if (!StatData.bIsValid)
+    {
+        return;
+    }
+
+    FOutputEntry Entry;
+    Entry.AssetPath = Key.AssetPath;
+    Entry.SourceHash = Key.SourceHash;
+    Entry.OutputHash = LexToString(FMD5Hash::HashFile(*OutputFilePathName));
+    Entry.OutputSize = StatData.FileSize;
+    Entry.OutputTimeStamp = StatData.ModificationTime.GetTicks();
+
+    FScopeLock Lock(&OutputsCritical);
+    Outputs.Add(GetRelativePath(OutputFilePathName), MoveTemp(Entry));
+}
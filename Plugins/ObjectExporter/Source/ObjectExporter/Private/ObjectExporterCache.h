@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPackage;
+
+/** Identifies the source state an exported file was produced from. */
+struct FObjectExporterCacheKey
+{
+    FString AssetPath;
+
+    /** Hash of the source packages, the file format version and the exporter console variables that change the output. Empty if the asset cannot be cached. */
+    FString SourceHash;
+
+    bool IsValid() const
+    {
+        return !SourceHash.IsEmpty();
+    }
+};
+
+/*
+*   Persistent export cache, stored as a JSON manifest next to the exported files (Saved/Bin/ExportCache.json).
+*
+*   Each exported file is recorded with the key of the asset it came from and the size, time stamp and hash
+*   of the written file. An export whose key matches and whose output file is untouched can be skipped.
+*   Package hashes are memoized by file size and time stamp so that a warm run does not read any package.
+*/
+class FObjectExporterCache
+{
+public:
+    FObjectExporterCache();
+
+    static FString GetManifestFilePathName();
+
+    void LoadManifest();
+    bool SaveManifest() const;
+
+    /** Computes the key of Asset, Dependencies are other assets the export reads from. Game thread only. */
+    FObjectExporterCacheKey ComputeKey(const UObject* Asset, const TArray<const UObject*>& Dependencies = TArray<const UObject*>());
+
+    /** True if OutputFilePathName was produced from Key and has not been modified since. */
+    bool IsUpToDate(const FString& OutputFilePathName, const FObjectExporterCacheKey& Key) const;
+
+    /** Records that OutputFilePathName was just written from Key. Thread safe. */
+    void Update(const FString& OutputFilePathName, const FObjectExporterCacheKey& Key);
+
+private:
+    struct FOutputEntry
+    {
+        FString AssetPath;
+        FString SourceHash;
+        FString OutputHash;
+        int64 OutputSize;
+        int64 OutputTimeStamp;
+    };
+
+    struct FPackageEntry
+    {
+        FString Hash;
+        int64 Size;
+        int64 TimeStamp;
+    };
+
+    /** Hash of the package file on disk, empty if the package has unsaved changes or was never saved. */
+    FString GetPackageHash(const UPackage* Package);
+
+    static FString GetRelativePath(const FString& FilePathName);
+
+    FString SettingsHash;
+    TMap<FString, FOutputEntry> Outputs;
+    TMap<FString, FPackageEntry> Packages;
+    mutable FCriticalSection OutputsCritical;
+};
@@ -0,0 +1,257 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterCommandlet.h"
+#include "ObjectExporterBPLibrary.h"
+#include "ObjectExporterStats.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/Package.h"
+
+DECLARE_LOG_CATEGORY_CLASS(ObjectExporterCommandletLog, Log, All);
+
+#define MAP_PATH "Bin/Map/"
+#define MAP_BINARY_FILE_POSTFIX ".map"
+#define EXPORT_REPORT_FILE "Bin/ExportReport.json"
+#define CONSOLE_VARIABLE_PREFIX "ObjectExporter."
+
+/** Outcome of one map, see SaveReport. */
+struct FMapExportResult
+{
+    FMapExportResult()
+        : bSuccess(false)
+        , LoadSeconds(0.0)
+        , ExportSeconds(0.0)
+        , FileSize(0)
+    {
+    }
+
+    FString MapName;
+    FString PackageName;
+    FString FilePathName;
+    bool bSuccess;
+    double LoadSeconds;
+    double ExportSeconds;
+    int64 FileSize;
+};
+
+UObjectExporterCommandlet::UObjectExporterCommandlet(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+    ShowErrorCount = true;
+}
+
+/** Resolves a map name such as MainMap, or checks a long package name such as /Game/Maps/MainMap. */
+static bool FindMapPackage(const FString& MapName, FString& OutPackageName)
+{
+    if (FPackageName::IsValidLongPackageName(MapName))
+    {
+        OutPackageName = MapName;
+
+        return FPackageName::DoesPackageExist(MapName);
+    }
+
+    return FPackageName::SearchForPackageOnDisk(MapName + FPackageName::GetMapPackageExtension(), &OutPackageName);
+}
+
+/** Loads the map with its sublevels and registers the components, so that they have world transforms and bounds. */
+static UWorld* LoadMap(const FString& PackageName)
+{
+    UPackage* Package = LoadPackage(nullptr, *PackageName, LOAD_None);
+    UWorld* World = Package != nullptr ? UWorld::FindWorldInPackage(Package) : nullptr;
+    if (World == nullptr)
+    {
+        return nullptr;
+    }
+
+    World->AddToRoot();
+    World->WorldType = EWorldType::Editor;
+
+    // Nothing is rendered or simulated, which also keeps -nullrhi working
+    World->InitWorld(UWorld::InitializationValues()
+        .InitializeScenes(false)
+        .AllowAudioPlayback(false)
+        .RequiresHitProxies(false)
+        .CreatePhysicsScene(false)
+        .CreateNavigation(false)
+        .CreateAISystem(false)
+        .ShouldSimulatePhysics(false)
+        .EnableTraceCollision(false)
+        .SetTransactional(false)
+        .CreateFXSystem(false));
+    World->UpdateWorldComponents(false, false);
+
+    for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+    {
+        StreamingLevel->SetShouldBeLoaded(true);
+        StreamingLevel->SetShouldBeVisible(true);
+    }
+    World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+
+    return World;
+}
+
+static void UnloadMap(UWorld* World)
+{
+    World->CleanupWorld();
+    World->RemoveFromRoot();
+
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+/** Sets the exporter console variables given as -ObjectExporter.<Name>=<Value>. */
+static void SetConsoleVariables(const TMap<FString, FString>& ParamValues)
+{
+    for (const TPair<FString, FString>& Param : ParamValues)
+    {
+        if (!Param.Key.StartsWith(TEXT(CONSOLE_VARIABLE_PREFIX)))
+        {
+            continue;
+        }
+
+        IConsoleVariable* ConsoleVariable = IConsoleManager::Get().FindConsoleVariable(*Param.Key);
+        if (ConsoleVariable != nullptr)
+        {
+            ConsoleVariable->Set(*Param.Value, ECVF_SetByCommandline);
+        }
+        else
+        {
+            UE_LOG(ObjectExporterCommandletLog, Warning, TEXT("Unknown console variable %s."), *Param.Key);
+        }
+    }
+}
+
+static bool SaveReport(const FString& ReportFilePathName, const TArray<FMapExportResult>& Results, int32 NumFailedAssets, const FObjectExporterSessionTotals& Totals)
+{
+    TSharedRef<FJsonObject> JsonRootObject = MakeShareable(new FJsonObject);
+
+    TArray<TSharedPtr<FJsonValue>> JsonMaps;
+    for (const FMapExportResult& Result : Results)
+    {
+        TSharedRef<FJsonObject> JsonMap = MakeShareable(new FJsonObject);
+        JsonMap->SetStringField(TEXT("Map"), Result.MapName);
+        JsonMap->SetStringField(TEXT("Package"), Result.PackageName);
+        JsonMap->SetStringField(TEXT("File"), Result.FilePathName);
+        JsonMap->SetBoolField(TEXT("Success"), Result.bSuccess);
+        JsonMap->SetNumberField(TEXT("LoadSeconds"), Result.LoadSeconds);
+        JsonMap->SetNumberField(TEXT("ExportSeconds"), Result.ExportSeconds);
+        JsonMap->SetNumberField(TEXT("FileSize"), Result.FileSize);
+        JsonMaps.Add(MakeShareable(new FJsonValueObject(JsonMap)));
+    }
+    JsonRootObject->SetArrayField(TEXT("Maps"), JsonMaps);
+
+    // Assets up to date in the export cache are not written and not counted
+    JsonRootObject->SetNumberField(TEXT("Assets"), Totals.NumAssets);
+    JsonRootObject->SetNumberField(TEXT("FailedAssets"), NumFailedAssets);
+    JsonRootObject->SetNumberField(TEXT("AssetBytes"), Totals.FileSize);
+    JsonRootObject->SetNumberField(TEXT("GatherSeconds"), Totals.GatherSeconds);
+    JsonRootObject->SetNumberField(TEXT("WriteSeconds"), Totals.WriteSeconds);
+    JsonRootObject->SetNumberField(TEXT("WallSeconds"), Totals.WallSeconds);
+
+    FString JsonContent;
+    TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&JsonContent);
+    if (FJsonSerializer::Serialize(JsonRootObject, JsonWriter))
+    {
+        return FFileHelper::SaveStringToFile(JsonContent, *ReportFilePathName);
+    }
+
+    return false;
+}
+
+int32 UObjectExporterCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Tokens;
+    TArray<FString> Switches;
+    TMap<FString, FString> ParamValues;
+    ParseCommandLine(*Params, Tokens, Switches, ParamValues);
+
+    TArray<FString> MapNames;
+    if (const FString* Maps = ParamValues.Find(TEXT("Maps")))
+    {
+        Maps->ParseIntoArray(MapNames, TEXT("+"));
+    }
+
+    if (MapNames.Num() == 0)
+    {
+        UE_LOG(ObjectExporterCommandletLog, Error, TEXT("Usage: -run=ObjectExporter -Maps=MainMap+TestVT [-Output=<directory>] [-Report=<file>] [-ObjectExporter.<Name>=<Value>]"));
+
+        return 1;
+    }
+
+    const FString* OutputPath = ParamValues.Find(TEXT("Output"));
+    const FString OutputDirectory = OutputPath != nullptr ? *OutputPath : FPaths::ProjectSavedDir() + MAP_PATH;
+
+    const FString* ReportPath = ParamValues.Find(TEXT("Report"));
+    const FString ReportFilePathName = ReportPath != nullptr ? *ReportPath : FPaths::ProjectSavedDir() + EXPORT_REPORT_FILE;
+
+    SetConsoleVariables(ParamValues);
+
+    ObjectExporterStats::BeginSession();
+    UObjectExporterBPLibrary::BeginMapExportBatch();
+
+    TArray<FMapExportResult> Results;
+    for (const FString& MapName : MapNames)
+    {
+        FMapExportResult& Result = Results.AddDefaulted_GetRef();
+        Result.MapName = FPackageName::GetShortName(MapName);
+        Result.FilePathName = FPaths::Combine(OutputDirectory, Result.MapName + TEXT(MAP_BINARY_FILE_POSTFIX));
+
+        if (!FindMapPackage(MapName, Result.PackageName))
+        {
+            UE_LOG(ObjectExporterCommandletLog, Error, TEXT("%s: map not found."), *MapName);
+
+            continue;
+        }
+
+        double StartTime = FPlatformTime::Seconds();
+        UWorld* World = LoadMap(Result.PackageName);
+        Result.LoadSeconds = FPlatformTime::Seconds() - StartTime;
+
+        if (World == nullptr)
+        {
+            UE_LOG(ObjectExporterCommandletLog, Error, TEXT("%s: %s could not be loaded."), *MapName, *Result.PackageName);
+
+            continue;
+        }
+
+        StartTime = FPlatformTime::Seconds();
+        Result.bSuccess = UObjectExporterBPLibrary::ExportMap(World, Result.FilePathName);
+        Result.ExportSeconds = FPlatformTime::Seconds() - StartTime;
+        Result.FileSize = Result.bSuccess ? IFileManager::Get().FileSize(*Result.FilePathName) : 0;
+
+        // The queued assets are snapshots that do not reference the world, it goes before the next map is loaded
+        UnloadMap(World);
+    }
+
+    const int32 NumFailedAssets = UObjectExporterBPLibrary::EndMapExportBatch();
+    const FObjectExporterSessionTotals Totals = ObjectExporterStats::EndSession(TEXT("ObjectExporter commandlet"));
+
+    int32 NumFailedMaps = 0;
+    for (const FMapExportResult& Result : Results)
+    {
+        UE_LOG(ObjectExporterCommandletLog, Display, TEXT("    %-24s %-7s load %8.2f s  export %8.2f s  %12lld bytes"),
+            *Result.MapName, Result.bSuccess ? TEXT("ok") : TEXT("FAILED"), Result.LoadSeconds, Result.ExportSeconds, Result.FileSize);
+
+        NumFailedMaps += Result.bSuccess ? 0 : 1;
+    }
+
+    UE_LOG(ObjectExporterCommandletLog, Display, TEXT("%d of %d maps exported, %d assets written (%llu bytes), %d assets failed, %.2f s."),
+        Results.Num() - NumFailedMaps, Results.Num(), Totals.NumAssets, Totals.FileSize, NumFailedAssets, Totals.WallSeconds);
+
+    if (!SaveReport(ReportFilePathName, Results, NumFailedAssets, Totals))
+    {
+        UE_LOG(ObjectExporterCommandletLog, Warning, TEXT("Report %s could not be written."), *ReportFilePathName);
+    }
+
+    return NumFailedMaps == 0 && NumFailedAssets == 0 ? 0 : 1;
+}
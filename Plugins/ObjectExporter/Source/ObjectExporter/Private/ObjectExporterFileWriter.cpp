@@ -0,0 +1,132 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterFileWriter.h"
+#include "HAL/FileManager.h"
+#include "Serialization/MemoryWriter.h"
+
+/** Writes zeros up to Offset. */
+static void WritePadding(FArchive& Archive, uint64 Offset)
+{
+    static uint8 Padding[OBJECT_EXPORTER_CHUNK_ALIGNMENT] = { 0 };
+
+    while ((uint64)Archive.Tell() < Offset)
+    {
+        Archive.Serialize(Padding, FMath::Min<uint64>(Offset - Archive.Tell(), sizeof(Padding)));
+    }
+}
+
+FObjectExporterFileWriter::FObjectExporterFileWriter(uint32 InFileType)
+    : FileType(InFileType)
+    , FileSize(0)
+{
+
+}
+
+TArray<uint8>& FObjectExporterFileWriter::AddChunk(uint32 ChunkId, uint32 ElementStride, uint32 Alignment)
+{
+    check(Alignment % OBJECT_EXPORTER_CHUNK_ALIGNMENT == 0);
+
+    FChunk* Chunk = new FChunk();
+    Chunk->ChunkId = ChunkId;
+    Chunk->ElementStride = ElementStride;
+    Chunk->Alignment = Alignment;
+    Chunks.Add(Chunk);
+
+    return Chunk->Payload;
+}
+
+uint32 FObjectExporterFileWriter::AddString(const FString& String)
+{
+    if (const uint32* ExistingOffset = StringOffsets.Find(String))
+    {
+        return *ExistingOffset;
+    }
+
+    const uint32 Offset = StringTable.Num();
+    FTCHARToUTF8 Converter(*String);
+    StringTable.Append(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+    StringTable.Add(0);
+
+    StringOffsets.Add(String, Offset);
+
+    return Offset;
+}
+
+bool FObjectExporterFileWriter::SaveToFile(const FString& FullFilePathName)
+{
+    FArchive* FileWriter = IFileManager::Get().CreateFileWriter(*FullFilePathName);
+    if (nullptr == FileWriter)
+    {
+        return false;
+    }
+
+    Save(*FileWriter);
+
+    bool bSuccess = FileWriter->Close();
+    delete FileWriter;
+    FileWriter = nullptr;
+
+    if (!bSuccess)
+    {
+        FileSize = 0;
+    }
+
+    return bSuccess;
+}
+
+void FObjectExporterFileWriter::SaveToMemory(TArray<uint8>& OutData)
+{
+    OutData.Reset();
+
+    FMemoryWriter MemoryWriter(OutData);
+    Save(MemoryWriter);
+}
+
+void FObjectExporterFileWriter::Save(FArchive& Archive)
+{
+    if (StringTable.Num() > 0)
+    {
+        AddChunk(ObjectExporterChunk::Strings, sizeof(uint8)) = MoveTemp(StringTable);
+        StringOffsets.Reset();
+    }
+
+    FObjectExporterFileHeader Header;
+    Header.Magic = ObjectExporterFile::Magic;
+    Header.Version = (uint16)EObjectExporterFileVersion::Latest;
+    Header.HeaderSize = sizeof(FObjectExporterFileHeader);
+    Header.FileType = FileType;
+    Header.ByteOrderMark = ObjectExporterFile::ByteOrderMark;
+    Header.ChunkCount = Chunks.Num();
+    Header.ChunkTableOffset = sizeof(FObjectExporterFileHeader);
+
+    TArray<FObjectExporterChunkEntry> ChunkTable;
+    ChunkTable.Reserve(Chunks.Num());
+
+    uint64 Offset = Align(Header.ChunkTableOffset + Chunks.Num() * sizeof(FObjectExporterChunkEntry), OBJECT_EXPORTER_CHUNK_ALIGNMENT);
+    for (const FChunk& Chunk : Chunks)
+    {
+        Offset = Align(Offset, Chunk.Alignment);
+
+        FObjectExporterChunkEntry& Entry = ChunkTable.AddZeroed_GetRef();
+        Entry.ChunkId = Chunk.ChunkId;
+        Entry.ElementStride = Chunk.ElementStride;
+        Entry.ElementCount = Chunk.ElementStride > 0 ? Chunk.Payload.Num() / Chunk.ElementStride : 0;
+        Entry.Offset = Offset;
+        Entry.Size = Chunk.Payload.Num();
+
+        Offset = Align(Offset + Entry.Size, OBJECT_EXPORTER_CHUNK_ALIGNMENT);
+    }
+    Header.FileSize = Offset;
+
+    Archive.Serialize(&Header, sizeof(Header));
+    Archive.Serialize(ChunkTable.GetData(), ChunkTable.Num() * sizeof(FObjectExporterChunkEntry));
+
+    for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ChunkIndex++)
+    {
+        WritePadding(Archive, ChunkTable[ChunkIndex].Offset);
+        Archive.Serialize(Chunks[ChunkIndex].Payload.GetData(), Chunks[ChunkIndex].Payload.Num());
+    }
+    WritePadding(Archive, Header.FileSize);
+
+    FileSize = Header.FileSize;
+}
@@ -0,0 +1,85 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ObjectExporterFileFormat.h"
+
+/*
+*   Collects the chunks of one ObjectExporter binary file in memory and writes them out
+*   behind a FObjectExporterFileHeader and chunk directory, each payload aligned to OBJECT_EXPORTER_CHUNK_ALIGNMENT.
+*/
+class FObjectExporterFileWriter
+{
+public:
+    explicit FObjectExporterFileWriter(uint32 InFileType);
+
+    /**
+    *   Adds an empty chunk and returns its payload for the caller to fill.
+    *   The reference stays valid until the writer is destroyed. ElementCount is derived from the payload size at save time.
+    *   Alignment is the file alignment of the payload, a multiple of OBJECT_EXPORTER_CHUNK_ALIGNMENT.
+    */
+    TArray<uint8>& AddChunk(uint32 ChunkId, uint32 ElementStride, uint32 Alignment = OBJECT_EXPORTER_CHUNK_ALIGNMENT);
+
+    /** Adds a chunk holding a copy of Elements. */
+    template <typename ElementType>
+    void AddChunk(uint32 ChunkId, const TArray<ElementType>& Elements, uint32 Alignment = OBJECT_EXPORTER_CHUNK_ALIGNMENT)
+    {
+        TArray<uint8>& Payload = AddChunk(ChunkId, sizeof(ElementType), Alignment);
+        Payload.Append(reinterpret_cast<const uint8*>(Elements.GetData()), Elements.Num() * sizeof(ElementType));
+    }
+
+    /** Adds a chunk holding a single record. */
+    template <typename ElementType>
+    void AddSingleElementChunk(uint32 ChunkId, const ElementType& Element)
+    {
+        TArray<uint8>& Payload = AddChunk(ChunkId, sizeof(ElementType));
+        Payload.Append(reinterpret_cast<const uint8*>(&Element), sizeof(ElementType));
+    }
+
+    /** Adds String to the STRS chunk (once) and returns its byte offset. */
+    uint32 AddString(const FString& String);
+
+    /** Writes header, chunk directory and payloads. The string table is appended as the last chunk. */
+    bool SaveToFile(const FString& FullFilePathName);
+
+    /** Same as SaveToFile into OutData, for files embedded in other files such as map cells. */
+    void SaveToMemory(TArray<uint8>& OutData);
+
+    /** Size of the file written by the last successful SaveToFile or SaveToMemory. */
+    uint64 GetFileSize() const
+    {
+        return FileSize;
+    }
+
+private:
+    /** Writes the file to Archive, which has to be at offset 0. */
+    void Save(FArchive& Archive);
+
+    struct FChunk
+    {
+        uint32 ChunkId;
+        uint32 ElementStride;
+        uint32 Alignment;
+        TArray<uint8> Payload;
+    };
+
+    struct FStringKeyFuncs : TDefaultMapHashableKeyFuncs<FString, uint32, false>
+    {
+        static bool Matches(const FString& A, const FString& B)
+        {
+            return A.Equals(B, ESearchCase::CaseSensitive);
+        }
+
+        static uint32 GetKeyHash(const FString& Key)
+        {
+            return FCrc::StrCrc32(*Key);
+        }
+    };
+
+    uint32 FileType;
+    uint64 FileSize;
+    TIndirectArray<FChunk> Chunks;
+    TArray<uint8> StringTable;
+    TMap<FString, uint32, FDefaultSetAllocator, FStringKeyFuncs> StringOffsets;
+};
@@ -0,0 +1,277 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterJsonWriter.h"
+#include "HAL/FileManager.h"
+
+FObjectExporterJsonWriter::FObjectExporterJsonWriter()
+    : Archive(nullptr)
+    , FileSize(0)
+    , BufferSize(0)
+    , Depth(0)
+    , bError(false)
+{
+    bHasValue[0] = false;
+}
+
+FObjectExporterJsonWriter::~FObjectExporterJsonWriter()
+{
+    delete Archive;
+}
+
+bool FObjectExporterJsonWriter::Open(const FString& FullFilePathName)
+{
+    check(Archive == nullptr);
+
+    Archive = IFileManager::Get().CreateFileWriter(*FullFilePathName);
+
+    return Archive != nullptr;
+}
+
+bool FObjectExporterJsonWriter::Close()
+{
+    if (Archive == nullptr)
+    {
+        return false;
+    }
+
+    WriteBytes("\n", 1);
+    Flush();
+
+    bool bSuccess = Archive->Close() && !bError && Depth == 0 && bHasValue[0];
+    delete Archive;
+    Archive = nullptr;
+
+    return bSuccess;
+}
+
+void FObjectExporterJsonWriter::BeginObject()
+{
+    BeginScope(nullptr, '{');
+}
+
+void FObjectExporterJsonWriter::BeginObject(const TCHAR* Name)
+{
+    BeginScope(Name, '{');
+}
+
+void FObjectExporterJsonWriter::EndObject()
+{
+    EndScope('}');
+}
+
+void FObjectExporterJsonWriter::BeginArray()
+{
+    BeginScope(nullptr, '[');
+}
+
+void FObjectExporterJsonWriter::BeginArray(const TCHAR* Name)
+{
+    BeginScope(Name, '[');
+}
+
+void FObjectExporterJsonWriter::EndArray()
+{
+    EndScope(']');
+}
+
+void FObjectExporterJsonWriter::Write(const FString& Value)
+{
+    BeginValue(nullptr);
+    AppendString(*Value);
+}
+
+void FObjectExporterJsonWriter::Write(const TCHAR* Name, int32 Value)
+{
+    BeginValue(Name);
+    AppendNumber((int64)Value);
+}
+
+void FObjectExporterJsonWriter::Write(const TCHAR* Name, uint32 Value)
+{
+    BeginValue(Name);
+    AppendNumber((int64)Value);
+}
+
+void FObjectExporterJsonWriter::Write(const TCHAR* Name, float Value)
+{
+    BeginValue(Name);
+    AppendNumber(Value);
+}
+
+void FObjectExporterJsonWriter::Write(const TCHAR* Name, bool Value)
+{
+    BeginValue(Name);
+    if (Value)
+    {
+        WriteBytes("true", 4);
+    }
+    else
+    {
+        WriteBytes("false", 5);
+    }
+}
+
+void FObjectExporterJsonWriter::Write(const TCHAR* Name, const TCHAR* Value)
+{
+    BeginValue(Name);
+    AppendString(Value);
+}
+
+void FObjectExporterJsonWriter::Write(const TCHAR* Name, const FString& Value)
+{
+    BeginValue(Name);
+    AppendString(*Value);
+}
+
+void FObjectExporterJsonWriter::WriteArray(const TCHAR* Name, const float* Values, int32 Count, int32 Width, int32 Stride)
+{
+    WriteNumbers(Name, Values, Count, Width, Stride);
+}
+
+void FObjectExporterJsonWriter::WriteArray(const TCHAR* Name, const uint32* Values, int32 Count, int32 Width, int32 Stride)
+{
+    WriteNumbers(Name, Values, Count, Width, Stride);
+}
+
+void FObjectExporterJsonWriter::WriteArray(const TCHAR* Name, const int32* Values, int32 Count, int32 Width, int32 Stride)
+{
+    WriteNumbers(Name, Values, Count, Width, Stride);
+}
+
+void FObjectExporterJsonWriter::WriteArray(const TCHAR* Name, const uint16* Values, int32 Count, int32 Width, int32 Stride)
+{
+    WriteNumbers(Name, Values, Count, Width, Stride);
+}
+
+void FObjectExporterJsonWriter::BeginValue(const TCHAR* Name)
+{
+    if (bHasValue[Depth])
+    {
+        WriteBytes(",", 1);
+    }
+    bHasValue[Depth] = true;
+
+    if (Name != nullptr)
+    {
+        AppendString(Name);
+        WriteBytes(":", 1);
+    }
+}
+
+void FObjectExporterJsonWriter::BeginScope(const TCHAR* Name, char Open)
+{
+    BeginValue(Name);
+    WriteBytes(&Open, 1);
+
+    if (Depth + 1 >= MaxDepth)
+    {
+        bError = true;
+
+        return;
+    }
+
+    Depth++;
+    bHasValue[Depth] = false;
+}
+
+void FObjectExporterJsonWriter::EndScope(char Close)
+{
+    if (Depth == 0)
+    {
+        bError = true;
+
+        return;
+    }
+
+    Depth--;
+    WriteBytes(&Close, 1);
+}
+
+void FObjectExporterJsonWriter::AppendNumber(float Value)
+{
+    if (!FMath::IsFinite(Value))
+    {
+        WriteBytes("null", 4);
+
+        return;
+    }
+
+    // 9 significant digits read back as the same float
+    char Text[32];
+    const int32 Length = FCStringAnsi::Snprintf(Text, sizeof(Text), "%.9g", (double)Value);
+    WriteBytes(Text, Length);
+}
+
+void FObjectExporterJsonWriter::AppendNumber(int64 Value)
+{
+    char Text[32];
+    const int32 Length = FCStringAnsi::Snprintf(Text, sizeof(Text), "%lld", (long long)Value);
+    WriteBytes(Text, Length);
+}
+
+void FObjectExporterJsonWriter::AppendString(const TCHAR* Value)
+{
+    static const char HexDigits[] = "0123456789abcdef";
+
+    WriteBytes("\"", 1);
+
+    // Escapes are resolved per UTF-8 byte, multi byte sequences never contain bytes below 0x80
+    FTCHARToUTF8 Converter(Value);
+    const char* Text = Converter.Get();
+    for (int32 Index = 0; Index < Converter.Length(); Index++)
+    {
+        const char Char = Text[Index];
+        if (Char == '"' || Char == '\\')
+        {
+            const char Escaped[2] = { '\\', Char };
+            WriteBytes(Escaped, 2);
+        }
+        else if ((uint8)Char < 0x20)
+        {
+            const char Escaped[6] = { '\\', 'u', '0', '0', HexDigits[(uint8)Char >> 4], HexDigits[Char & 0xF] };
+            WriteBytes(Escaped, 6);
+        }
+        else
+        {
+            WriteBytes(&Char, 1);
+        }
+    }
+
+    WriteBytes("\"", 1);
+}
+
+void FObjectExporterJsonWriter::WriteBytes(const char* Bytes, int32 Count)
+{
+    if (BufferSize + Count > BufferCapacity)
+    {
+        Flush();
+
+        // Only long strings get here
+        if (Count > BufferCapacity)
+        {
+            if (Archive != nullptr)
+            {
+                Archive->Serialize(const_cast<char*>(Bytes), Count);
+                bError |= Archive->IsError();
+            }
+            FileSize += Count;
+
+            return;
+        }
+    }
+
+    FMemory::Memcpy(Buffer + BufferSize, Bytes, Count);
+    BufferSize += Count;
+}
+
+void FObjectExporterJsonWriter::Flush()
+{
+    if (Archive != nullptr && BufferSize > 0)
+    {
+        Archive->Serialize(Buffer, BufferSize);
+        bError |= Archive->IsError();
+    }
+
+    FileSize += BufferSize;
+    BufferSize = 0;
+}
@@ -0,0 +1,130 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+*   Streaming JSON writer for the .json exports. Output goes through a fixed size buffer straight to the file,
+*   so memory stays bounded whatever the asset size and no value is ever allocated on the heap.
+*   Bulk data is written as flat numeric arrays ("Positions": [x, y, z, x, y, z, ...]).
+*
+*   Calls must nest properly: named Write/Begin calls inside objects, unnamed ones inside arrays.
+*   Non finite floats are written as null.
+*/
+class FObjectExporterJsonWriter
+{
+public:
+    FObjectExporterJsonWriter();
+    ~FObjectExporterJsonWriter();
+
+    /** Creates FullFilePathName. Returns false if the file cannot be created. */
+    bool Open(const FString& FullFilePathName);
+
+    /** Flushes the buffer and closes the file. Returns false if any write failed or the document is not complete. */
+    bool Close();
+
+    /** Bytes written so far. */
+    uint64 GetFileSize() const
+    {
+        return FileSize + BufferSize;
+    }
+
+    void BeginObject();
+    void BeginObject(const TCHAR* Name);
+    void EndObject();
+
+    void BeginArray();
+    void BeginArray(const TCHAR* Name);
+    void EndArray();
+
+    /** Array element. */
+    void Write(const FString& Value);
+
+    /** Object members. */
+    void Write(const TCHAR* Name, int32 Value);
+    void Write(const TCHAR* Name, uint32 Value);
+    void Write(const TCHAR* Name, float Value);
+    void Write(const TCHAR* Name, bool Value);
+    void Write(const TCHAR* Name, const TCHAR* Value);
+    void Write(const TCHAR* Name, const FString& Value);
+
+    /**
+    *   Writes Count groups of Width consecutive values as one flat array, the groups start Stride values apart
+    *   (Width when 0). A stride reads one member out of an array of records, e.g. the positions of the vertices.
+    */
+    void WriteArray(const TCHAR* Name, const float* Values, int32 Count, int32 Width = 1, int32 Stride = 0);
+    void WriteArray(const TCHAR* Name, const uint32* Values, int32 Count, int32 Width = 1, int32 Stride = 0);
+    void WriteArray(const TCHAR* Name, const int32* Values, int32 Count, int32 Width = 1, int32 Stride = 0);
+    void WriteArray(const TCHAR* Name, const uint16* Values, int32 Count, int32 Width = 1, int32 Stride = 0);
+
+    template <typename ValueType>
+    void WriteArray(const TCHAR* Name, const TArray<ValueType>& Values)
+    {
+        WriteArray(Name, Values.GetData(), Values.Num());
+    }
+
+private:
+    /** Separator and key of the next value in the current scope. */
+    void BeginValue(const TCHAR* Name);
+
+    void BeginScope(const TCHAR* Name, char Open);
+    void EndScope(char Close);
+
+    void AppendNumber(float Value);
+    void AppendNumber(int64 Value);
+
+    void AppendNumber(int32 Value)
+    {
+        AppendNumber((int64)Value);
+    }
+
+    void AppendNumber(uint32 Value)
+    {
+        AppendNumber((int64)Value);
+    }
+
+    void AppendNumber(uint16 Value)
+    {
+        AppendNumber((int64)Value);
+    }
+    void AppendString(const TCHAR* Value);
+
+    void WriteBytes(const char* Bytes, int32 Count);
+
+    template <typename ValueType>
+    void WriteNumbers(const TCHAR* Name, const ValueType* Values, int32 Count, int32 Width, int32 Stride)
+    {
+        Stride = Stride > 0 ? Stride : Width;
+
+        BeginScope(Name, '[');
+        for (int32 Index = 0; Index < Count; Index++)
+        {
+            for (int32 Component = 0; Component < Width; Component++)
+            {
+                BeginValue(nullptr);
+                AppendNumber(Values[Index * Stride + Component]);
+            }
+        }
+        EndScope(']');
+    }
+
+    void Flush();
+
+    enum
+    {
+        BufferCapacity = 64 * 1024,
+        MaxDepth = 32,
+    };
+
+    FArchive* Archive;
+    uint64 FileSize;
+    int32 BufferSize;
+    int32 Depth;
+    bool bError;
+
+    /** Per scope: true once it holds a value, so the next one needs a comma. */
+    bool bHasValue[MaxDepth];
+
+    char Buffer[BufferCapacity];
+};
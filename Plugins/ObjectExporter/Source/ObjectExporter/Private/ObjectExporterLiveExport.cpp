@@ -0,0 +1,286 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterLiveExport.h"
+#include "ObjectExporterBPLibrary.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "Camera/CameraComponent.h"
+#include "Components/LightComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Materials/MaterialInstance.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+#include "UObject/UObjectIterator.h"
+
+DECLARE_LOG_CATEGORY_CLASS(ObjectExporterLiveExportLog, Log, All);
+
+#define EXPORT_JOURNAL_FILE "Bin/ExportJournal.jsonl"
+
+/** Seconds without changes before the pending ones are exported. */
+#define LIVE_EXPORT_DELAY 0.25
+
+static TAutoConsoleVariable<int32> CVarObjectExporterLiveExport(
+    TEXT("ObjectExporter.LiveExport"),
+    0,
+    TEXT("0: saving assets and moving actors in the editor does not touch the exported files (default).\n")
+    TEXT("1: re-export the exported files of saved assets and maps and of maps with moved actors, and list them in Saved/Bin/ExportJournal.jsonl."));
+
+/** True if the exported file exists, live export only refreshes what was exported before. */
+static bool IsExported(const FString& FullFilePathName)
+{
+    return !FullFilePathName.IsEmpty() && IFileManager::Get().FileExists(*FullFilePathName);
+}
+
+FObjectExporterLiveExport::FObjectExporterLiveExport()
+    : LastChangeTime(0.0)
+{
+    // GEngine does not exist yet in the PreLoadingScreen phase the module loads in
+    PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddRaw(this, &FObjectExporterLiveExport::OnPostEngineInit);
+    PackageSavedHandle = UPackage::PackageSavedEvent.AddRaw(this, &FObjectExporterLiveExport::OnPackageSaved);
+    TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FObjectExporterLiveExport::Tick));
+}
+
+FObjectExporterLiveExport::~FObjectExporterLiveExport()
+{
+    FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+    UPackage::PackageSavedEvent.Remove(PackageSavedHandle);
+    FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+
+    if (GEngine != nullptr)
+    {
+        GEngine->OnActorMoved().Remove(ActorMovedHandle);
+    }
+}
+
+void FObjectExporterLiveExport::OnPostEngineInit()
+{
+    ActorMovedHandle = GEngine->OnActorMoved().AddRaw(this, &FObjectExporterLiveExport::OnActorMoved);
+}
+
+void FObjectExporterLiveExport::OnPackageSaved(const FString& PackageFileName, UObject* PackageObject)
+{
+    UPackage* Package = Cast<UPackage>(PackageObject);
+    if (Package == nullptr || CVarObjectExporterLiveExport.GetValueOnGameThread() == 0)
+    {
+        return;
+    }
+
+    if (UWorld* World = UWorld::FindWorldInPackage(Package))
+    {
+        AddPendingWorld(World);
+
+        return;
+    }
+
+    TArray<UObject*> Assets;
+    ForEachObjectWithPackage(Package, [&Assets](UObject* Object)
+    {
+        Assets.Add(Object);
+
+        return true;
+    }, false);
+
+    for (UObject* Asset : Assets)
+    {
+        AddPendingAsset(Asset);
+
+        // Exported files that embed data of the saved asset
+        if (const UMaterialInterface* Material = Cast<UMaterialInterface>(Asset))
+        {
+            for (TObjectIterator<UMaterialInstance> It; It; ++It)
+            {
+                const UMaterialInstance* Instance = *It;
+                while (Instance != nullptr && Instance->Parent != Material)
+                {
+                    Instance = Cast<UMaterialInstance>(Instance->Parent);
+                }
+
+                if (Instance != nullptr)
+                {
+                    AddPendingAsset(*It);
+                }
+            }
+        }
+        else if (Asset->IsA<UStaticMesh>() || Asset->IsA<USkeletalMesh>())
+        {
+            AddPendingWorldsUsingMesh(Asset);
+        }
+        else if (const USkeleton* Skeleton = Cast<USkeleton>(Asset))
+        {
+            for (TObjectIterator<USkeletalMesh> It; It; ++It)
+            {
+                if (It->Skeleton == Skeleton)
+                {
+                    AddPendingAsset(*It);
+                }
+            }
+            for (TObjectIterator<UAnimSequence> It; It; ++It)
+            {
+                if (It->GetSkeleton() == Skeleton)
+                {
+                    AddPendingAsset(*It);
+                }
+            }
+        }
+    }
+}
+
+void FObjectExporterLiveExport::OnActorMoved(AActor* Actor)
+{
+    if (Actor == nullptr || CVarObjectExporterLiveExport.GetValueOnGameThread() == 0)
+    {
+        return;
+    }
+
+    // Only actors ExportMap writes records for
+    if (Actor->FindComponentByClass<UStaticMeshComponent>() != nullptr
+        || Actor->FindComponentByClass<USkeletalMeshComponent>() != nullptr
+        || Actor->FindComponentByClass<ULightComponent>() != nullptr
+        || Actor->FindComponentByClass<UCameraComponent>() != nullptr)
+    {
+        AddPendingWorld(Actor->GetWorld());
+    }
+}
+
+void FObjectExporterLiveExport::AddPendingAsset(UObject* Asset)
+{
+    if (IsExported(UObjectExporterBPLibrary::GetAssetFilePathName(Asset)))
+    {
+        PendingAssets.Add(Asset);
+        LastChangeTime = FPlatformTime::Seconds();
+    }
+}
+
+void FObjectExporterLiveExport::AddPendingWorld(UWorld* World)
+{
+    // Play in editor worlds are copies, their changes are not saved
+    if (World != nullptr && World->WorldType == EWorldType::Editor && IsExported(UObjectExporterBPLibrary::GetMapFilePathName(World)))
+    {
+        PendingWorlds.Add(World);
+        LastChangeTime = FPlatformTime::Seconds();
+    }
+}
+
+void FObjectExporterLiveExport::AddPendingWorldsUsingMesh(const UObject* Mesh)
+{
+    // Maps bake the world bounds of the meshes they place into their BVH and grid cells
+    for (TObjectIterator<UStaticMeshComponent> It; It; ++It)
+    {
+        if (!It->IsTemplate() && It->GetStaticMesh() == Mesh)
+        {
+            AddPendingWorld(It->GetWorld());
+        }
+    }
+    for (TObjectIterator<USkeletalMeshComponent> It; It; ++It)
+    {
+        if (!It->IsTemplate() && It->SkeletalMesh == Mesh)
+        {
+            AddPendingWorld(It->GetWorld());
+        }
+    }
+}
+
+bool FObjectExporterLiveExport::Tick(float DeltaTime)
+{
+    if ((PendingAssets.Num() == 0 && PendingWorlds.Num() == 0) || FPlatformTime::Seconds() - LastChangeTime < LIVE_EXPORT_DELAY)
+    {
+        return true;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    TArray<UObject*> Assets;
+    for (const TWeakObjectPtr<UObject>& Asset : PendingAssets)
+    {
+        if (Asset.IsValid())
+        {
+            Assets.Add(Asset.Get());
+        }
+    }
+    PendingAssets.Reset();
+
+    if (Assets.Num() > 0)
+    {
+        TArray<FString> FilePathNames;
+        const int32 NumFailedAssets = UObjectExporterBPLibrary::ExportAssets(Assets, FilePathNames);
+        if (NumFailedAssets > 0)
+        {
+            UE_LOG(ObjectExporterLiveExportLog, Warning, TEXT("%d assets could not be exported."), NumFailedAssets);
+        }
+
+        // Only the written files, a failed save may have left a stale or partly written one
+        AppendJournal(TEXT("Asset"), FilePathNames);
+    }
+
+    TArray<FString> MapFilePathNames;
+    for (const TWeakObjectPtr<UWorld>& World : PendingWorlds)
+    {
+        if (!World.IsValid())
+        {
+            continue;
+        }
+
+        const FString FilePathName = UObjectExporterBPLibrary::GetMapFilePathName(World.Get());
+        if (UObjectExporterBPLibrary::ExportMapRecords(World.Get(), FilePathName))
+        {
+            MapFilePathNames.Add(FilePathName);
+        }
+    }
+    PendingWorlds.Reset();
+
+    AppendJournal(TEXT("Map"), MapFilePathNames);
+
+    UE_LOG(ObjectExporterLiveExportLog, Log, TEXT("Live export of %d assets and %d maps took %.1f ms."),
+        Assets.Num(), MapFilePathNames.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+    return true;
+}
+
+void FObjectExporterLiveExport::AppendJournal(const TCHAR* Type, const TArray<FString>& FilePathNames) const
+{
+    if (FilePathNames.Num() == 0)
+    {
+        return;
+    }
+
+    const FString Time = FDateTime::UtcNow().ToIso8601();
+
+    FString JournalLines;
+    for (const FString& FilePathName : FilePathNames)
+    {
+        FString RelativeFilePathName = FilePathName;
+        FPaths::MakePathRelativeTo(RelativeFilePathName, *FPaths::ProjectSavedDir());
+
+        TSharedRef<FJsonObject> JsonEntry = MakeShareable(new FJsonObject);
+        JsonEntry->SetStringField(TEXT("Time"), Time);
+        JsonEntry->SetStringField(TEXT("Type"), Type);
+        JsonEntry->SetStringField(TEXT("File"), RelativeFilePathName);
+
+        // One entry per line, the reader splits the appended bytes at line ends
+        FString JsonLine;
+        TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&JsonLine);
+        if (FJsonSerializer::Serialize(JsonEntry, JsonWriter))
+        {
+            JournalLines += JsonLine + TEXT("\n");
+        }
+    }
+
+    const FString JournalFilePathName = FPaths::ProjectSavedDir() + EXPORT_JOURNAL_FILE;
+    if (!FFileHelper::SaveStringToFile(JournalLines, *JournalFilePathName, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append))
+    {
+        UE_LOG(ObjectExporterLiveExportLog, Warning, TEXT("Journal %s could not be written."), *JournalFilePathName);
+    }
+}
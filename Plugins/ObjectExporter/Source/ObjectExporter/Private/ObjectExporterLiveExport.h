@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class UPackage;
+class UWorld;
+
+/*
+*   Keeps the exported files up to date while the editor runs, enabled by ObjectExporter.LiveExport.
+*
+*   Saving an asset re-exports its file, and the files of the loaded assets built on it: material instances of a
+*   saved material, meshes and animations of a saved skeleton. Saving a map or moving one of its actors rewrites
+*   the map file without its assets (UObjectExporterBPLibrary::ExportMapRecords), and so does saving a mesh that one
+*   of its actors places. Only files that were exported before are refreshed, nothing new is written.
+*
+*   Changes are collected until the editor has been idle for a moment, so a multi asset save or a drag exports
+*   once. Every refreshed file is appended to Saved/Bin/ExportJournal.jsonl as one JSON line,
+*   {"Time": ..., "Type": "Asset" or "Map", "File": <path relative to Saved/>}, which a running game tails from
+*   the size it read last to hot reload the files.
+*/
+class FObjectExporterLiveExport
+{
+public:
+    FObjectExporterLiveExport();
+    ~FObjectExporterLiveExport();
+
+private:
+    void OnPostEngineInit();
+    void OnPackageSaved(const FString& PackageFileName, UObject* PackageObject);
+    void OnActorMoved(AActor* Actor);
+    bool Tick(float DeltaTime);
+
+    void AddPendingAsset(UObject* Asset);
+    void AddPendingWorld(UWorld* World);
+    void AddPendingWorldsUsingMesh(const UObject* Mesh);
+    void AppendJournal(const TCHAR* Type, const TArray<FString>& FilePathNames) const;
+
+    TSet<TWeakObjectPtr<UObject>> PendingAssets;
+    TSet<TWeakObjectPtr<UWorld>> PendingWorlds;
+    double LastChangeTime;
+
+    FDelegateHandle PostEngineInitHandle;
+    FDelegateHandle PackageSavedHandle;
+    FDelegateHandle ActorMovedHandle;
+    FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,372 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterMeshOptimizer.h"
+
+// Scoring constants from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+#define FORSYTH_CACHE_SIZE 32
+#define FORSYTH_CACHE_DECAY_POWER 1.5f
+#define FORSYTH_LAST_TRIANGLE_SCORE 0.75f
+#define FORSYTH_VALENCE_BOOST_SCALE 2.0f
+#define FORSYTH_VALENCE_BOOST_POWER 0.5f
+
+static float ComputeVertexScore(int32 CachePosition, uint32 RemainingValence)
+{
+    if (RemainingValence == 0)
+    {
+        // No triangle left to draw with this vertex
+        return -1.0f;
+    }
+
+    float Score = 0.0f;
+    if (CachePosition >= 0)
+    {
+        if (CachePosition < 3)
+        {
+            // Used by the last triangle, a fixed score so that strips are not preferred over fans
+            Score = FORSYTH_LAST_TRIANGLE_SCORE;
+        }
+        else
+        {
+            const float Scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            Score = FMath::Pow(1.0f - (CachePosition - 3) * Scaler, FORSYTH_CACHE_DECAY_POWER);
+        }
+    }
+
+    // Finish off vertices with few triangles left first, so they leave the cache for good
+    Score += FORSYTH_VALENCE_BOOST_SCALE * FMath::Pow((float)RemainingValence, -FORSYTH_VALENCE_BOOST_POWER);
+
+    return Score;
+}
+
+/** Returns the number of cache misses of one triangle and updates the FIFO timestamps. */
+static int32 SimulateTriangle(const uint32* Triangle, TArray<uint32>& CacheTimeStamps, uint32& TimeStamp, int32 CacheSize)
+{
+    int32 Misses = 0;
+    for (int32 iCorner = 0; iCorner < 3; iCorner++)
+    {
+        const uint32 Index = Triangle[iCorner];
+        if (TimeStamp - CacheTimeStamps[Index] > (uint32)CacheSize)
+        {
+            CacheTimeStamps[Index] = TimeStamp++;
+            Misses++;
+        }
+    }
+
+    return Misses;
+}
+
+FObjectExporterVertexCacheStats ObjectExporterMeshOptimizer::AnalyzeVertexCache(const uint32* Indices, int32 NumIndices, uint32 NumVertices, int32 CacheSize)
+{
+    FObjectExporterVertexCacheStats Stats;
+    if (NumIndices < 3 || NumVertices == 0)
+    {
+        return Stats;
+    }
+
+    TArray<uint32> CacheTimeStamps;
+    CacheTimeStamps.Init(0, NumVertices);
+    uint32 TimeStamp = CacheSize + 1;
+
+    int32 Misses = 0;
+    for (int32 iIndex = 0; iIndex + 2 < NumIndices; iIndex += 3)
+    {
+        Misses += SimulateTriangle(Indices + iIndex, CacheTimeStamps, TimeStamp, CacheSize);
+    }
+
+    int32 NumReferencedVertices = 0;
+    for (uint32 CacheTimeStamp : CacheTimeStamps)
+    {
+        NumReferencedVertices += CacheTimeStamp != 0 ? 1 : 0;
+    }
+
+    Stats.ACMR = (float)Misses / (NumIndices / 3);
+    Stats.ATVR = NumReferencedVertices > 0 ? (float)Misses / NumReferencedVertices : 0.0f;
+
+    return Stats;
+}
+
+void ObjectExporterMeshOptimizer::OptimizeVertexCache(uint32* Indices, int32 NumIndices, uint32 NumVertices)
+{
+    const int32 NumTriangles = NumIndices / 3;
+    if (NumTriangles == 0)
+    {
+        return;
+    }
+
+    // Triangles of every vertex, the first RemainingValence entries are the ones not emitted yet
+    TArray<uint32> TriangleOffsets;
+    TriangleOffsets.Init(0, NumVertices + 1);
+    for (int32 iIndex = 0; iIndex < NumTriangles * 3; iIndex++)
+    {
+        TriangleOffsets[Indices[iIndex] + 1]++;
+    }
+
+    TArray<uint32> RemainingValence;
+    RemainingValence.SetNumUninitialized(NumVertices);
+    for (uint32 iVertex = 0; iVertex < NumVertices; iVertex++)
+    {
+        RemainingValence[iVertex] = TriangleOffsets[iVertex + 1];
+        TriangleOffsets[iVertex + 1] += TriangleOffsets[iVertex];
+    }
+
+    TArray<uint32> VertexTriangles;
+    VertexTriangles.SetNumUninitialized(NumTriangles * 3);
+    {
+        TArray<uint32> FillOffsets(TriangleOffsets.GetData(), NumVertices);
+        for (int32 iIndex = 0; iIndex < NumTriangles * 3; iIndex++)
+        {
+            VertexTriangles[FillOffsets[Indices[iIndex]]++] = iIndex / 3;
+        }
+    }
+
+    TArray<int32> CachePositions;
+    CachePositions.Init(INDEX_NONE, NumVertices);
+
+    TArray<float> VertexScores;
+    VertexScores.SetNumUninitialized(NumVertices);
+    for (uint32 iVertex = 0; iVertex < NumVertices; iVertex++)
+    {
+        VertexScores[iVertex] = ComputeVertexScore(INDEX_NONE, RemainingValence[iVertex]);
+    }
+
+    TBitArray<> EmittedTriangles(false, NumTriangles);
+    TArray<uint32> OptimizedIndices;
+    OptimizedIndices.Reserve(NumTriangles * 3);
+
+    uint32 Cache[FORSYTH_CACHE_SIZE + 3];
+    int32 CacheCount = 0;
+    int32 BestTriangle = INDEX_NONE;
+    int32 NextUnemittedTriangle = 0;
+
+    for (int32 NumEmitted = 0; NumEmitted < NumTriangles; NumEmitted++)
+    {
+        if (BestTriangle == INDEX_NONE)
+        {
+            // Nothing in the cache is useful anymore, restart from the next remaining triangle
+            while (EmittedTriangles[NextUnemittedTriangle])
+            {
+                NextUnemittedTriangle++;
+            }
+            BestTriangle = NextUnemittedTriangle;
+        }
+
+        const uint32* Triangle = Indices + BestTriangle * 3;
+        OptimizedIndices.Append(Triangle, 3);
+        EmittedTriangles[BestTriangle] = true;
+
+        uint32 NewCache[FORSYTH_CACHE_SIZE + 3];
+        int32 NewCacheCount = 0;
+
+        for (int32 iCorner = 0; iCorner < 3; iCorner++)
+        {
+            const uint32 Vertex = Triangle[iCorner];
+
+            uint32* LiveTriangles = VertexTriangles.GetData() + TriangleOffsets[Vertex];
+            for (uint32 iTriangle = 0; iTriangle < RemainingValence[Vertex]; iTriangle++)
+            {
+                if (LiveTriangles[iTriangle] == (uint32)BestTriangle)
+                {
+                    Swap(LiveTriangles[iTriangle], LiveTriangles[RemainingValence[Vertex] - 1]);
+                    RemainingValence[Vertex]--;
+                    break;
+                }
+            }
+
+            if (NewCacheCount == 0 || (NewCache[0] != Vertex && (NewCacheCount == 1 || NewCache[1] != Vertex)))
+            {
+                NewCache[NewCacheCount++] = Vertex;
+            }
+        }
+
+        for (int32 iCache = 0; iCache < CacheCount; iCache++)
+        {
+            const uint32 Vertex = Cache[iCache];
+            if (Vertex != Triangle[0] && Vertex != Triangle[1] && Vertex != Triangle[2])
+            {
+                NewCache[NewCacheCount++] = Vertex;
+            }
+        }
+
+        // Vertices past the cache size fell out, everything left gets the score of its new position
+        for (int32 iCache = 0; iCache < NewCacheCount; iCache++)
+        {
+            const uint32 Vertex = NewCache[iCache];
+            CachePositions[Vertex] = iCache < FORSYTH_CACHE_SIZE ? iCache : INDEX_NONE;
+            VertexScores[Vertex] = ComputeVertexScore(CachePositions[Vertex], RemainingValence[Vertex]);
+        }
+
+        CacheCount = FMath::Min(NewCacheCount, FORSYTH_CACHE_SIZE);
+        FMemory::Memcpy(Cache, NewCache, CacheCount * sizeof(uint32));
+
+        // The next triangle is the best one touching the cache
+        BestTriangle = INDEX_NONE;
+        float BestScore = -1.0f;
+
+        for (int32 iCache = 0; iCache < CacheCount; iCache++)
+        {
+            const uint32 Vertex = Cache[iCache];
+            const uint32* LiveTriangles = VertexTriangles.GetData() + TriangleOffsets[Vertex];
+            for (uint32 iTriangle = 0; iTriangle < RemainingValence[Vertex]; iTriangle++)
+            {
+                const uint32* Candidate = Indices + LiveTriangles[iTriangle] * 3;
+                const float Score = VertexScores[Candidate[0]] + VertexScores[Candidate[1]] + VertexScores[Candidate[2]];
+                if (Score > BestScore)
+                {
+                    BestScore = Score;
+                    BestTriangle = LiveTriangles[iTriangle];
+                }
+            }
+        }
+    }
+
+    FMemory::Memcpy(Indices, OptimizedIndices.GetData(), OptimizedIndices.Num() * sizeof(uint32));
+}
+
+void ObjectExporterMeshOptimizer::OptimizeOverdraw(uint32* Indices, int32 NumIndices, const FObjectExporterMeshVertex* Vertices, uint32 NumVertices, float Threshold)
+{
+    const int32 NumTriangles = NumIndices / 3;
+    if (NumTriangles < 2)
+    {
+        return;
+    }
+
+    TArray<uint32> CacheTimeStamps;
+    CacheTimeStamps.Init(0, NumVertices);
+    uint32 TimeStamp = VertexCacheSize + 1;
+
+    // Hard boundaries: triangles missing the cache with all three vertices, reordering there costs nothing
+    TArray<int32> HardClusters;
+    for (int32 iTriangle = 0; iTriangle < NumTriangles; iTriangle++)
+    {
+        if (SimulateTriangle(Indices + iTriangle * 3, CacheTimeStamps, TimeStamp, VertexCacheSize) == 3 || iTriangle == 0)
+        {
+            HardClusters.Add(iTriangle);
+        }
+    }
+    HardClusters.Add(NumTriangles);
+
+    // Soft boundaries: inside a hard cluster, wherever the cache efficiency so far is within Threshold of the whole cluster
+    TArray<int32> Clusters;
+    for (int32 iHardCluster = 0; iHardCluster + 1 < HardClusters.Num(); iHardCluster++)
+    {
+        const int32 ClusterStart = HardClusters[iHardCluster];
+        const int32 ClusterEnd = HardClusters[iHardCluster + 1];
+
+        TimeStamp += VertexCacheSize + 1;
+        int32 ClusterMisses = 0;
+        for (int32 iTriangle = ClusterStart; iTriangle < ClusterEnd; iTriangle++)
+        {
+            ClusterMisses += SimulateTriangle(Indices + iTriangle * 3, CacheTimeStamps, TimeStamp, VertexCacheSize);
+        }
+
+        const float ClusterThreshold = Threshold * ClusterMisses / (ClusterEnd - ClusterStart);
+
+        Clusters.Add(ClusterStart);
+        TimeStamp += VertexCacheSize + 1;
+        int32 SoftStart = ClusterStart;
+        int32 SoftMisses = 0;
+
+        for (int32 iTriangle = ClusterStart; iTriangle < ClusterEnd; iTriangle++)
+        {
+            SoftMisses += SimulateTriangle(Indices + iTriangle * 3, CacheTimeStamps, TimeStamp, VertexCacheSize);
+
+            if (iTriangle + 1 < ClusterEnd && SoftMisses <= ClusterThreshold * (iTriangle + 1 - SoftStart))
+            {
+                Clusters.Add(iTriangle + 1);
+                SoftStart = iTriangle + 1;
+                SoftMisses = 0;
+                TimeStamp += VertexCacheSize + 1;
+            }
+        }
+    }
+    Clusters.Add(NumTriangles);
+
+    const int32 NumClusters = Clusters.Num() - 1;
+    if (NumClusters < 2)
+    {
+        return;
+    }
+
+    // Area weighted centroid and outward normal of every cluster
+    TArray<FVector> ClusterCentroids;
+    TArray<FVector> ClusterNormals;
+    ClusterCentroids.Init(FVector::ZeroVector, NumClusters);
+    ClusterNormals.Init(FVector::ZeroVector, NumClusters);
+
+    FVector MeshCentroid = FVector::ZeroVector;
+    float MeshArea = 0.0f;
+
+    for (int32 iCluster = 0; iCluster < NumClusters; iCluster++)
+    {
+        float ClusterArea = 0.0f;
+        for (int32 iTriangle = Clusters[iCluster]; iTriangle < Clusters[iCluster + 1]; iTriangle++)
+        {
+            const FObjectExporterMeshVertex& V0 = Vertices[Indices[iTriangle * 3 + 0]];
+            const FObjectExporterMeshVertex& V1 = Vertices[Indices[iTriangle * 3 + 1]];
+            const FObjectExporterMeshVertex& V2 = Vertices[Indices[iTriangle * 3 + 2]];
+
+            const FVector P0 = GetPosition(V0);
+            const FVector P1 = GetPosition(V1);
+            const FVector P2 = GetPosition(V2);
+
+            const FVector FaceNormal = GetFaceNormal(V0, V1, V2);
+            const float Area = FaceNormal.Size();
+            ClusterCentroids[iCluster] += (P0 + P1 + P2) * (Area / 3.0f);
+            ClusterNormals[iCluster] += FaceNormal;
+            ClusterArea += Area;
+        }
+
+        MeshCentroid += ClusterCentroids[iCluster];
+        MeshArea += ClusterArea;
+
+        ClusterCentroids[iCluster] /= FMath::Max(ClusterArea, SMALL_NUMBER);
+        ClusterNormals[iCluster] = ClusterNormals[iCluster].GetSafeNormal();
+    }
+
+    MeshCentroid /= FMath::Max(MeshArea, SMALL_NUMBER);
+
+    // Clusters facing away from the center are more likely to occlude the rest
+    TArray<float> SortKeys;
+    TArray<int32> ClusterOrder;
+    for (int32 iCluster = 0; iCluster < NumClusters; iCluster++)
+    {
+        SortKeys.Add(FVector::DotProduct(ClusterCentroids[iCluster] - MeshCentroid, ClusterNormals[iCluster]));
+        ClusterOrder.Add(iCluster);
+    }
+
+    ClusterOrder.Sort([&SortKeys](int32 A, int32 B)
+    {
+        return SortKeys[A] != SortKeys[B] ? SortKeys[A] > SortKeys[B] : A < B;
+    });
+
+    TArray<uint32> SortedIndices;
+    SortedIndices.Reserve(NumTriangles * 3);
+    for (int32 iCluster : ClusterOrder)
+    {
+        SortedIndices.Append(Indices + Clusters[iCluster] * 3, (Clusters[iCluster + 1] - Clusters[iCluster]) * 3);
+    }
+
+    FMemory::Memcpy(Indices, SortedIndices.GetData(), SortedIndices.Num() * sizeof(uint32));
+}
+
+void ObjectExporterMeshOptimizer::ComputeVertexFetchRemap(const uint32* Indices, int32 NumIndices, uint32 NumVertices, TArray<uint32>& OutRemap)
+{
+    OutRemap.Init(MAX_uint32, NumVertices);
+
+    uint32 NextVertex = 0;
+    for (int32 iIndex = 0; iIndex < NumIndices; iIndex++)
+    {
+        if (OutRemap[Indices[iIndex]] == MAX_uint32)
+        {
+            OutRemap[Indices[iIndex]] = NextVertex++;
+        }
+    }
+
+    for (uint32 iVertex = 0; iVertex < NumVertices; iVertex++)
+    {
+        if (OutRemap[iVertex] == MAX_uint32)
+        {
+            OutRemap[iVertex] = NextVertex++;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ObjectExporterFileFormat.h"
+
+/** Post-transform cache efficiency of an index buffer, simulated with a FIFO cache. */
+struct FObjectExporterVertexCacheStats
+{
+    /** Average cache miss ratio: transformed vertices per triangle, 0.5 is ideal for large regular meshes. */
+    float ACMR = 0.0f;
+
+    /** Average transform to vertex ratio: transformed vertices per referenced vertex, 1.0 is ideal. */
+    float ATVR = 0.0f;
+};
+
+/*
+*   Export time index and vertex reordering. Every function works on LOD local indices in [0, NumVertices)
+*   and keeps the triangle set unchanged, only the order differs.
+*/
+namespace ObjectExporterMeshOptimizer
+{
+    /** FIFO size of the simulated post-transform cache, a conservative value for mobile GPUs. */
+    constexpr int32 VertexCacheSize = 16;
+
+    /** Clusters whose cache efficiency is within this factor of their hard cluster may be reordered for overdraw. */
+    constexpr float OverdrawThreshold = 1.05f;
+
+    inline FVector GetPosition(const FObjectExporterMeshVertex& Vertex)
+    {
+        return FVector(Vertex.Position[0], Vertex.Position[1], Vertex.Position[2]);
+    }
+
+    /**
+    *   Face normal of a triangle, not normalized: its length is twice the area. It is oriented like the vertex
+    *   normals, so the winding convention of the source mesh does not matter.
+    */
+    inline FVector GetFaceNormal(const FObjectExporterMeshVertex& V0, const FObjectExporterMeshVertex& V1, const FObjectExporterMeshVertex& V2)
+    {
+        const FVector P0 = GetPosition(V0);
+        const FVector FaceNormal = FVector::CrossProduct(GetPosition(V1) - P0, GetPosition(V2) - P0);
+        const FVector VertexNormal(V0.Normal[0] + V1.Normal[0] + V2.Normal[0], V0.Normal[1] + V1.Normal[1] + V2.Normal[1], V0.Normal[2] + V1.Normal[2] + V2.Normal[2]);
+
+        return FVector::DotProduct(FaceNormal, VertexNormal) < 0.0f ? -FaceNormal : FaceNormal;
+    }
+
+    FObjectExporterVertexCacheStats AnalyzeVertexCache(const uint32* Indices, int32 NumIndices, uint32 NumVertices, int32 CacheSize = VertexCacheSize);
+
+    /** Reorders triangles for the post-transform cache (Forsyth, linear speed vertex cache optimisation). */
+    void OptimizeVertexCache(uint32* Indices, int32 NumIndices, uint32 NumVertices);
+
+    /**
+    *   Splits cache optimized triangles into clusters (Tipsify style hard and soft boundaries) and sorts the clusters
+    *   so that outward facing ones are drawn first, which lets early depth rejection skip more of the occluded ones.
+    */
+    void OptimizeOverdraw(uint32* Indices, int32 NumIndices, const FObjectExporterMeshVertex* Vertices, uint32 NumVertices, float Threshold = OverdrawThreshold);
+
+    /** Builds an old to new vertex remap in first use order, unreferenced vertices move to the end. */
+    void ComputeVertexFetchRemap(const uint32* Indices, int32 NumIndices, uint32 NumVertices, TArray<uint32>& OutRemap);
+
+    template <typename VertexType>
+    void RemapVertices(VertexType* Vertices, uint32 NumVertices, const TArray<uint32>& Remap)
+    {
+        TArray<VertexType> SourceVertices(Vertices, NumVertices);
+        for (uint32 iVertex = 0; iVertex < NumVertices; iVertex++)
+        {
+            Vertices[Remap[iVertex]] = SourceVertices[iVertex];
+        }
+    }
+}
@@ -0,0 +1,360 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterMeshSimplifier.h"
+#include "ObjectExporterMeshOptimizer.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarObjectExporterGenerateLODs(
+    TEXT("ObjectExporter.GenerateLODs"),
+    0,
+    TEXT("Number of LODs to generate from LOD 0 for meshes that have no authored LODs, 0 to disable (default)."));
+
+static TAutoConsoleVariable<float> CVarObjectExporterGeneratedLODTriangleRatio(
+    TEXT("ObjectExporter.GeneratedLODTriangleRatio"),
+    0.5f,
+    TEXT("Fraction of the triangles of the previous LOD kept by each generated LOD."));
+
+static TAutoConsoleVariable<float> CVarObjectExporterGeneratedLODMaxError(
+    TEXT("ObjectExporter.GeneratedLODMaxError"),
+    0.05f,
+    TEXT("Largest simplification error allowed in generated LODs, relative to the mesh bounds radius."));
+
+FObjectExporterLODGenerationSettings FObjectExporterLODGenerationSettings::Get()
+{
+    FObjectExporterLODGenerationSettings Settings;
+    Settings.NumLODs = FMath::Max(CVarObjectExporterGenerateLODs.GetValueOnGameThread(), 0);
+    Settings.TriangleRatio = FMath::Clamp(CVarObjectExporterGeneratedLODTriangleRatio.GetValueOnGameThread(), 0.0f, 1.0f);
+    Settings.MaxError = FMath::Max(CVarObjectExporterGeneratedLODMaxError.GetValueOnGameThread(), 0.0f);
+
+    return Settings;
+}
+
+// Attribute costs, scaled by the squared bounds radius so they compare with squared distances
+#define SIMPLIFIER_NORMAL_WEIGHT 0.01
+#define SIMPLIFIER_UV_WEIGHT 0.01
+#define SIMPLIFIER_SKIN_WEIGHT 0.05
+
+/** Symmetric 4x4 plane quadric, accumulated with area weights. */
+struct FQuadric
+{
+    double A00 = 0.0, A11 = 0.0, A22 = 0.0, A01 = 0.0, A02 = 0.0, A12 = 0.0;
+    double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+    double C = 0.0;
+    double Weight = 0.0;
+
+    void AddPlane(const FVector& Normal, float Distance, double PlaneWeight)
+    {
+        A00 += PlaneWeight * Normal.X * Normal.X;
+        A11 += PlaneWeight * Normal.Y * Normal.Y;
+        A22 += PlaneWeight * Normal.Z * Normal.Z;
+        A01 += PlaneWeight * Normal.X * Normal.Y;
+        A02 += PlaneWeight * Normal.X * Normal.Z;
+        A12 += PlaneWeight * Normal.Y * Normal.Z;
+        B0 += PlaneWeight * Normal.X * Distance;
+        B1 += PlaneWeight * Normal.Y * Distance;
+        B2 += PlaneWeight * Normal.Z * Distance;
+        C += PlaneWeight * Distance * Distance;
+        Weight += PlaneWeight;
+    }
+
+    void Add(const FQuadric& Other)
+    {
+        A00 += Other.A00; A11 += Other.A11; A22 += Other.A22;
+        A01 += Other.A01; A02 += Other.A02; A12 += Other.A12;
+        B0 += Other.B0; B1 += Other.B1; B2 += Other.B2;
+        C += Other.C;
+        Weight += Other.Weight;
+    }
+
+    /** Mean squared distance of P to the accumulated planes. */
+    double Evaluate(const FVector& P) const
+    {
+        const double X = P.X, Y = P.Y, Z = P.Z;
+        const double Error = A00 * X * X + A11 * Y * Y + A22 * Z * Z + 2.0 * (A01 * X * Y + A02 * X * Z + A12 * Y * Z)
+            + 2.0 * (B0 * X + B1 * Y + B2 * Z) + C;
+
+        return Weight > 0.0 ? FMath::Max(Error / Weight, 0.0) : 0.0;
+    }
+};
+
+struct FCollapse
+{
+    uint32 Source;
+    uint32 Target;
+    double Cost;
+    double PositionError;
+};
+
+using ObjectExporterMeshOptimizer::GetPosition;
+
+static uint64 GetEdgeKey(uint32 A, uint32 B)
+{
+    return A < B ? ((uint64)A << 32) | B : ((uint64)B << 32) | A;
+}
+
+static float GetBoneWeight(const FObjectExporterSkinWeight& SkinWeight, uint16 BoneIndex)
+{
+    float Weight = 0.0f;
+    for (int32 iInfluence = 0; iInfluence < 4; iInfluence++)
+    {
+        Weight += SkinWeight.BoneIndices[iInfluence] == BoneIndex ? SkinWeight.BoneWeights[iInfluence] : 0.0f;
+    }
+
+    return Weight;
+}
+
+/** Sum of the absolute weight differences over the bones of both vertices, 0 to 2. */
+static double GetSkinWeightDifference(const FObjectExporterSkinWeight& A, const FObjectExporterSkinWeight& B)
+{
+    double Difference = 0.0;
+    for (int32 iInfluence = 0; iInfluence < 4; iInfluence++)
+    {
+        if (A.BoneWeights[iInfluence] > 0.0f)
+        {
+            Difference += FMath::Abs(A.BoneWeights[iInfluence] - GetBoneWeight(B, A.BoneIndices[iInfluence]));
+        }
+
+        if (B.BoneWeights[iInfluence] > 0.0f && GetBoneWeight(A, B.BoneIndices[iInfluence]) == 0.0f)
+        {
+            Difference += B.BoneWeights[iInfluence];
+        }
+    }
+
+    return Difference;
+}
+
+/** Attribute part of the cost of moving Source onto Target, in squared bounds radius units. */
+static double GetAttributeCost(const FObjectExporterMeshVertex* Vertices, const FObjectExporterSkinWeight* SkinWeights, uint32 Source, uint32 Target)
+{
+    const FObjectExporterMeshVertex& A = Vertices[Source];
+    const FObjectExporterMeshVertex& B = Vertices[Target];
+
+    const double NormalDot = A.Normal[0] * B.Normal[0] + A.Normal[1] * B.Normal[1] + A.Normal[2] * B.Normal[2];
+    const double UVDistanceSquared = FMath::Square(A.UV[0] - B.UV[0]) + FMath::Square(A.UV[1] - B.UV[1]);
+
+    double Cost = (1.0 - NormalDot) * SIMPLIFIER_NORMAL_WEIGHT + UVDistanceSquared * SIMPLIFIER_UV_WEIGHT;
+    if (SkinWeights != nullptr)
+    {
+        Cost += GetSkinWeightDifference(SkinWeights[Source], SkinWeights[Target]) * SIMPLIFIER_SKIN_WEIGHT;
+    }
+
+    return Cost;
+}
+
+/** True when moving Source onto Target turns a triangle around Source over. */
+static bool CollapseFlipsTriangle(const TArray<uint32>& Indices, const TArray<uint32>& TriangleOffsets, const TArray<uint32>& VertexTriangles,
+    const FObjectExporterMeshVertex* Vertices, uint32 Source, uint32 Target)
+{
+    const FVector TargetPosition = GetPosition(Vertices[Target]);
+
+    for (uint32 iTriangle = TriangleOffsets[Source]; iTriangle < TriangleOffsets[Source + 1]; iTriangle++)
+    {
+        const uint32* Triangle = Indices.GetData() + VertexTriangles[iTriangle] * 3;
+
+        // Triangles on the collapsed edge disappear
+        if (Triangle[0] == Target || Triangle[1] == Target || Triangle[2] == Target)
+        {
+            continue;
+        }
+
+        FVector Corners[3];
+        FVector NewCorners[3];
+        for (int32 iCorner = 0; iCorner < 3; iCorner++)
+        {
+            Corners[iCorner] = GetPosition(Vertices[Triangle[iCorner]]);
+            NewCorners[iCorner] = Triangle[iCorner] == Source ? TargetPosition : Corners[iCorner];
+        }
+
+        const FVector Normal = FVector::CrossProduct(Corners[1] - Corners[0], Corners[2] - Corners[0]);
+        const FVector NewNormal = FVector::CrossProduct(NewCorners[1] - NewCorners[0], NewCorners[2] - NewCorners[0]);
+        if (FVector::DotProduct(Normal, NewNormal) <= 0.0f)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+float ObjectExporterMeshSimplifier::Simplify(TArray<uint32>& Indices, const FObjectExporterMeshVertex* Vertices, const FObjectExporterSkinWeight* SkinWeights, uint32 NumVertices,
+    int32 TargetNumIndices, float MaxError)
+{
+    FBox Bounds(ForceInit);
+    for (uint32 Index : Indices)
+    {
+        Bounds += GetPosition(Vertices[Index]);
+    }
+
+    if (!Bounds.IsValid)
+    {
+        return 0.0f;
+    }
+
+    const double RadiusSquared = FMath::Max<double>(Bounds.GetExtent().SizeSquared(), SMALL_NUMBER);
+    const double MaxCost = FMath::Square(MaxError) * RadiusSquared;
+
+    // Plane quadrics of the source triangles, they measure the distance to the original surface
+    TArray<FQuadric> Quadrics;
+    Quadrics.SetNum(NumVertices);
+    for (int32 iIndex = 0; iIndex + 2 < Indices.Num(); iIndex += 3)
+    {
+        const FVector P0 = GetPosition(Vertices[Indices[iIndex + 0]]);
+        FVector Normal = FVector::CrossProduct(GetPosition(Vertices[Indices[iIndex + 1]]) - P0, GetPosition(Vertices[Indices[iIndex + 2]]) - P0);
+        const float Area = Normal.Size() * 0.5f;
+        if (Normal.Normalize())
+        {
+            for (int32 iCorner = 0; iCorner < 3; iCorner++)
+            {
+                Quadrics[Indices[iIndex + iCorner]].AddPlane(Normal, -FVector::DotProduct(Normal, P0), Area);
+            }
+        }
+    }
+
+    double MaxPositionError = 0.0;
+    TArray<uint32> Remap;
+    TArray<uint32> TriangleOffsets;
+    TArray<uint32> VertexTriangles;
+    TMap<uint64, int32> EdgeCounts;
+    TArray<FCollapse> Collapses;
+
+    // Each pass collapses the cheapest edges that do not share triangles, then rebuilds the topology
+    while (Indices.Num() > TargetNumIndices)
+    {
+        const int32 NumTriangles = Indices.Num() / 3;
+
+        EdgeCounts.Reset();
+        for (int32 iIndex = 0; iIndex < NumTriangles * 3; iIndex += 3)
+        {
+            for (int32 iCorner = 0; iCorner < 3; iCorner++)
+            {
+                EdgeCounts.FindOrAdd(GetEdgeKey(Indices[iIndex + iCorner], Indices[iIndex + (iCorner + 1) % 3]))++;
+            }
+        }
+
+        // Open or non-manifold edges are borders of the wedge topology: UV seams, hard edges and mesh borders
+        TBitArray<> Locked(false, NumVertices);
+        for (const TPair<uint64, int32>& Edge : EdgeCounts)
+        {
+            if (Edge.Value != 2)
+            {
+                Locked[(uint32)(Edge.Key >> 32)] = true;
+                Locked[(uint32)(Edge.Key & MAX_uint32)] = true;
+            }
+        }
+
+        Collapses.Reset();
+        for (const TPair<uint64, int32>& Edge : EdgeCounts)
+        {
+            const uint32 A = (uint32)(Edge.Key >> 32);
+            const uint32 B = (uint32)(Edge.Key & MAX_uint32);
+
+            for (int32 iDirection = 0; iDirection < 2; iDirection++)
+            {
+                const uint32 Source = iDirection == 0 ? A : B;
+                const uint32 Target = iDirection == 0 ? B : A;
+                if (!Locked[Source])
+                {
+                    const double PositionError = Quadrics[Source].Evaluate(GetPosition(Vertices[Target]));
+                    const double Cost = PositionError + GetAttributeCost(Vertices, SkinWeights, Source, Target) * RadiusSquared;
+                    Collapses.Add({ Source, Target, Cost, PositionError });
+                }
+            }
+        }
+
+        // Ties are broken by vertex index so the result does not depend on map order
+        Collapses.Sort([](const FCollapse& A, const FCollapse& B)
+        {
+            if (A.Cost != B.Cost)
+            {
+                return A.Cost < B.Cost;
+            }
+            return A.Source != B.Source ? A.Source < B.Source : A.Target < B.Target;
+        });
+
+        // Triangles around each vertex, for the flip test
+        TriangleOffsets.Reset();
+        TriangleOffsets.AddZeroed(NumVertices + 1);
+        for (int32 iIndex = 0; iIndex < NumTriangles * 3; iIndex++)
+        {
+            TriangleOffsets[Indices[iIndex] + 1]++;
+        }
+        for (uint32 iVertex = 0; iVertex < NumVertices; iVertex++)
+        {
+            TriangleOffsets[iVertex + 1] += TriangleOffsets[iVertex];
+        }
+
+        VertexTriangles.SetNumUninitialized(NumTriangles * 3);
+        {
+            TArray<uint32> Cursors(TriangleOffsets.GetData(), NumVertices);
+            for (int32 iIndex = 0; iIndex < NumTriangles * 3; iIndex++)
+            {
+                VertexTriangles[Cursors[Indices[iIndex]]++] = iIndex / 3;
+            }
+        }
+
+        Remap.SetNumUninitialized(NumVertices);
+        for (uint32 iVertex = 0; iVertex < NumVertices; iVertex++)
+        {
+            Remap[iVertex] = iVertex;
+        }
+
+        TBitArray<> Touched(false, NumVertices);
+        const int32 TrianglesToRemove = (Indices.Num() - TargetNumIndices + 2) / 3;
+        int32 NumRemovedTriangles = 0;
+
+        for (const FCollapse& Collapse : Collapses)
+        {
+            if (Collapse.Cost > MaxCost || NumRemovedTriangles >= TrianglesToRemove)
+            {
+                break;
+            }
+
+            if (Touched[Collapse.Source] || Touched[Collapse.Target]
+                || CollapseFlipsTriangle(Indices, TriangleOffsets, VertexTriangles, Vertices, Collapse.Source, Collapse.Target))
+            {
+                continue;
+            }
+
+            Remap[Collapse.Source] = Collapse.Target;
+            Quadrics[Collapse.Target].Add(Quadrics[Collapse.Source]);
+            MaxPositionError = FMath::Max(MaxPositionError, Collapse.PositionError);
+
+            // Every triangle around the source changes, none of their vertices can collapse again in this pass
+            for (uint32 iTriangle = TriangleOffsets[Collapse.Source]; iTriangle < TriangleOffsets[Collapse.Source + 1]; iTriangle++)
+            {
+                const uint32* Triangle = Indices.GetData() + VertexTriangles[iTriangle] * 3;
+                const bool bRemoved = Triangle[0] == Collapse.Target || Triangle[1] == Collapse.Target || Triangle[2] == Collapse.Target;
+                NumRemovedTriangles += bRemoved ? 1 : 0;
+
+                for (int32 iCorner = 0; iCorner < 3; iCorner++)
+                {
+                    Touched[Triangle[iCorner]] = true;
+                }
+            }
+        }
+
+        if (NumRemovedTriangles == 0)
+        {
+            break;
+        }
+
+        // Rewrite the triangles and drop the ones that collapsed
+        int32 NumIndices = 0;
+        for (int32 iIndex = 0; iIndex < NumTriangles * 3; iIndex += 3)
+        {
+            const uint32 A = Remap[Indices[iIndex + 0]];
+            const uint32 B = Remap[Indices[iIndex + 1]];
+            const uint32 C = Remap[Indices[iIndex + 2]];
+            if (A != B && B != C && A != C)
+            {
+                Indices[NumIndices++] = A;
+                Indices[NumIndices++] = B;
+                Indices[NumIndices++] = C;
+            }
+        }
+
+        Indices.SetNum(NumIndices, false);
+    }
+
+    return (float)FMath::Sqrt(MaxPositionError);
+}
@@ -0,0 +1,34 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ObjectExporterFileFormat.h"
+
+/** LOD generation options, read from the ObjectExporter.* console variables when a mesh is gathered. */
+struct FObjectExporterLODGenerationSettings
+{
+    int32 NumLODs = 0;
+    float TriangleRatio = 0.5f;
+    float MaxError = 0.0f;
+
+    /** Game thread only. */
+    static FObjectExporterLODGenerationSettings Get();
+};
+
+namespace ObjectExporterMeshSimplifier
+{
+    /**
+    *   Simplifies the triangles in Indices in place with quadric error metric edge collapses, until at most
+    *   TargetNumIndices are left or every remaining collapse costs more than MaxError (relative to the bounds radius).
+    *
+    *   Vertices are never moved or created, a collapse merges a vertex into one of its neighbours, so the attributes
+    *   and skin weights of the output are exactly those of the source. Vertices on open edges of the wedge topology
+    *   are locked, which keeps UV seams, hard normal edges, section borders and mesh borders intact. Normal, UV and
+    *   skin weight differences are added to the collapse cost so that the interior keeps its shading and deformation.
+    *
+    *   Indices are relative to Vertices, SkinWeights may be null. Returns the geometric error of the result in world units.
+    */
+    float Simplify(TArray<uint32>& Indices, const FObjectExporterMeshVertex* Vertices, const FObjectExporterSkinWeight* SkinWeights, uint32 NumVertices,
+        int32 TargetNumIndices, float MaxError);
+}
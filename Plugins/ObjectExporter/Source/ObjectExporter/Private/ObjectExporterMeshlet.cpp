@@ -0,0 +1,139 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterMeshlet.h"
+#include "ObjectExporterMeshOptimizer.h"
+
+using ObjectExporterMeshOptimizer::GetPosition;
+
+/** Bounding sphere and normal cone of the last meshlet of Data. */
+static void ComputeMeshletBounds(FObjectExporterMeshletData& Data, const FObjectExporterMeshVertex* Vertices)
+{
+    FObjectExporterMeshlet& Meshlet = Data.Meshlets.Last();
+    const uint32* MeshletVertices = Data.Vertices.GetData() + Meshlet.FirstVertex;
+    const uint8* MeshletTriangles = Data.Triangles.GetData() + Meshlet.FirstTriangle * 3;
+
+    // Sphere around the box center, cheap and stable
+    FBox Box(ForceInit);
+    for (uint32 iVertex = 0; iVertex < Meshlet.NumVertices; iVertex++)
+    {
+        Box += GetPosition(Vertices[MeshletVertices[iVertex]]);
+    }
+
+    const FVector Center = Box.GetCenter();
+    float RadiusSquared = 0.0f;
+    for (uint32 iVertex = 0; iVertex < Meshlet.NumVertices; iVertex++)
+    {
+        RadiusSquared = FMath::Max(RadiusSquared, FVector::DistSquared(Center, GetPosition(Vertices[MeshletVertices[iVertex]])));
+    }
+
+    ObjectExporterFile::CopyVector(Meshlet.Center, Center);
+    Meshlet.Radius = FMath::Sqrt(RadiusSquared);
+
+    // Triangle normals, see GetFaceNormal
+    TArray<FVector, TInlineAllocator<ObjectExporterMeshlet::MaxTriangles>> TriangleNormals;
+    TArray<FVector, TInlineAllocator<ObjectExporterMeshlet::MaxTriangles>> TriangleCorners;
+    FVector AxisSum = FVector::ZeroVector;
+
+    for (uint32 iTriangle = 0; iTriangle < Meshlet.NumTriangles; iTriangle++)
+    {
+        const FObjectExporterMeshVertex& V0 = Vertices[MeshletVertices[MeshletTriangles[iTriangle * 3 + 0]]];
+        const FObjectExporterMeshVertex& V1 = Vertices[MeshletVertices[MeshletTriangles[iTriangle * 3 + 1]]];
+        const FObjectExporterMeshVertex& V2 = Vertices[MeshletVertices[MeshletTriangles[iTriangle * 3 + 2]]];
+
+        const FVector P0 = GetPosition(V0);
+        FVector Normal = ObjectExporterMeshOptimizer::GetFaceNormal(V0, V1, V2);
+
+        // Degenerate triangles are never visible, they do not widen the cone
+        if (Normal.Normalize())
+        {
+            TriangleNormals.Add(Normal);
+            TriangleCorners.Add(P0);
+            AxisSum += Normal;
+        }
+    }
+
+    const FVector Axis = AxisSum.GetSafeNormal();
+    ObjectExporterFile::CopyVector(Meshlet.ConeAxis, Axis);
+    ObjectExporterFile::CopyVector(Meshlet.ConeApex, Center);
+    Meshlet.ConeCutoff = 1.0f;
+
+    float MinDot = 1.0f;
+    for (const FVector& Normal : TriangleNormals)
+    {
+        MinDot = FMath::Min(MinDot, FVector::DotProduct(Normal, Axis));
+    }
+
+    // Cones wider than about 84 degrees would almost never cull anything
+    if (TriangleNormals.Num() == 0 || MinDot <= 0.1f)
+    {
+        return;
+    }
+
+    // Move the apex back along the axis until it is behind every triangle plane,
+    // Center - Axis * t is behind the plane of a triangle for t >= dot(Center - Corner, Normal) / dot(Axis, Normal)
+    float MaxDistance = 0.0f;
+    for (int32 iTriangle = 0; iTriangle < TriangleNormals.Num(); iTriangle++)
+    {
+        const float PlaneDistance = FVector::DotProduct(Center - TriangleCorners[iTriangle], TriangleNormals[iTriangle]);
+        const float AxisDot = FVector::DotProduct(Axis, TriangleNormals[iTriangle]);
+        MaxDistance = FMath::Max(MaxDistance, PlaneDistance / AxisDot);
+    }
+
+    ObjectExporterFile::CopyVector(Meshlet.ConeApex, Center - Axis * MaxDistance);
+    Meshlet.ConeCutoff = FMath::Sqrt(1.0f - MinDot * MinDot);
+}
+
+void ObjectExporterMeshlet::BuildMeshlets(const uint32* Indices, int32 NumIndices, const FObjectExporterMeshVertex* Vertices, uint32 SectionIndex, FObjectExporterMeshletData& OutData)
+{
+    // Local index of each LOD vertex in the current meshlet
+    TMap<uint32, uint8> LocalIndices;
+    FObjectExporterMeshlet* Meshlet = nullptr;
+
+    for (int32 iIndex = 0; iIndex + 2 < NumIndices; iIndex += 3)
+    {
+        const uint32* Triangle = Indices + iIndex;
+
+        uint32 NumNewVertices = 0;
+        if (Meshlet != nullptr)
+        {
+            for (int32 iCorner = 0; iCorner < 3; iCorner++)
+            {
+                const bool bDuplicate = (iCorner > 0 && Triangle[iCorner] == Triangle[0]) || (iCorner > 1 && Triangle[iCorner] == Triangle[1]);
+                NumNewVertices += !bDuplicate && !LocalIndices.Contains(Triangle[iCorner]) ? 1 : 0;
+            }
+        }
+
+        if (Meshlet == nullptr || Meshlet->NumVertices + NumNewVertices > MaxVertices || Meshlet->NumTriangles + 1 > MaxTriangles)
+        {
+            if (Meshlet != nullptr)
+            {
+                ComputeMeshletBounds(OutData, Vertices);
+            }
+
+            Meshlet = &OutData.Meshlets.AddZeroed_GetRef();
+            Meshlet->FirstVertex = OutData.Vertices.Num();
+            Meshlet->FirstTriangle = OutData.Triangles.Num() / 3;
+            Meshlet->SectionIndex = SectionIndex;
+            LocalIndices.Reset();
+        }
+
+        for (int32 iCorner = 0; iCorner < 3; iCorner++)
+        {
+            uint8* LocalIndex = LocalIndices.Find(Triangle[iCorner]);
+            if (LocalIndex == nullptr)
+            {
+                LocalIndex = &LocalIndices.Add(Triangle[iCorner], (uint8)Meshlet->NumVertices++);
+                OutData.Vertices.Add(Triangle[iCorner]);
+            }
+
+            OutData.Triangles.Add(*LocalIndex);
+        }
+
+        Meshlet->NumTriangles++;
+    }
+
+    if (Meshlet != nullptr)
+    {
+        ComputeMeshletBounds(OutData, Vertices);
+    }
+}
@@ -0,0 +1,32 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ObjectExporterFileFormat.h"
+
+/** Meshlets of a static mesh, written as the MSHL, MVTX and MTRI chunks. */
+struct FObjectExporterMeshletData
+{
+    TArray<FObjectExporterMeshlet> Meshlets;
+    TArray<uint32> Vertices;
+    TArray<uint8> Triangles;
+
+    SIZE_T GetAllocatedSize() const
+    {
+        return Meshlets.GetAllocatedSize() + Vertices.GetAllocatedSize() + Triangles.GetAllocatedSize();
+    }
+};
+
+namespace ObjectExporterMeshlet
+{
+    constexpr uint32 MaxVertices = 64;
+    constexpr uint32 MaxTriangles = 124;
+
+    /**
+    *   Splits the triangles of one section into meshlets, in index order, and appends them to OutData.
+    *   Triangles are scanned in order, so clusters are tight when the indices are cache optimized (ObjectExporter.OptimizeMeshes).
+    *   Indices and Vertices are those of the section's LOD.
+    */
+    void BuildMeshlets(const uint32* Indices, int32 NumIndices, const FObjectExporterMeshVertex* Vertices, uint32 SectionIndex, FObjectExporterMeshletData& OutData);
+}
@@ -0,0 +1,156 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterPipeline.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarObjectExporterParallelExport(
+    TEXT("ObjectExporter.ParallelExport"),
+    1,
+    TEXT("0: encode and write exported assets on the game thread, in gather order.\n")
+    TEXT("1: encode and write exported assets on the thread pool (default)."));
+
+static TAutoConsoleVariable<int32> CVarObjectExporterMaxInFlightMemoryMB(
+    TEXT("ObjectExporter.MaxInFlightMemoryMB"),
+    512,
+    TEXT("Upper bound of gathered asset snapshots waiting to be written, in MB. The game thread stops gathering while it is exceeded."));
+
+FObjectExporterPipeline::FObjectExporterPipeline(FObjectExporterCache* InCache)
+    : Cache(InCache)
+    , bParallel(CVarObjectExporterParallelExport.GetValueOnGameThread() != 0 && FPlatformProcess::SupportsMultithreading())
+    , MaxInFlightBytes((SIZE_T)FMath::Max(CVarObjectExporterMaxInFlightMemoryMB.GetValueOnGameThread(), 1) * 1024 * 1024)
+    , InFlightBytes(0)
+    , NumFailed(0)
+    , NumUpToDate(0)
+{
+
+}
+
+FObjectExporterPipeline::~FObjectExporterPipeline()
+{
+    Flush();
+}
+
+bool FObjectExporterPipeline::IsQueued(const FString& FullFilePathName) const
+{
+    return QueuedFiles.Contains(FullFilePathName);
+}
+
+bool FObjectExporterPipeline::Enqueue(const FObjectExporterAssetDataPtr& Data, const FString& FullFilePathName, const FObjectExporterCacheKey& CacheKey)
+{
+    check(IsInGameThread());
+
+    if (!Data.IsValid() || IsQueued(FullFilePathName))
+    {
+        return false;
+    }
+
+    QueuedFiles.Add(FullFilePathName);
+
+    FObjectExporterCache* CacheToUpdate = CacheKey.IsValid() ? Cache : nullptr;
+    auto SaveTask = [Data, FullFilePathName, CacheKey, CacheToUpdate]()
+    {
+        if (!Data->Save(FullFilePathName))
+        {
+            return false;
+        }
+
+        if (CacheToUpdate != nullptr)
+        {
+            CacheToUpdate->Update(FullFilePathName, CacheKey);
+        }
+
+        return true;
+    };
+
+    if (!bParallel)
+    {
+        if (SaveTask())
+        {
+            WrittenFiles.Add(FullFilePathName);
+        }
+        else
+        {
+            NumFailed++;
+        }
+
+        return true;
+    }
+
+    const SIZE_T AllocatedSize = Data->GetAllocatedSize();
+    ReserveMemory(AllocatedSize);
+
+    FPendingWrite& PendingWrite = PendingWrites.AddDefaulted_GetRef();
+    PendingWrite.AllocatedSize = AllocatedSize;
+    PendingWrite.FullFilePathName = FullFilePathName;
+    PendingWrite.Result = Async(EAsyncExecution::ThreadPool, MoveTemp(SaveTask));
+
+    InFlightBytes += AllocatedSize;
+
+    return true;
+}
+
+void FObjectExporterPipeline::MarkUpToDate(const FString& FullFilePathName)
+{
+    bool bAlreadyQueued = false;
+    QueuedFiles.Add(FullFilePathName, &bAlreadyQueued);
+
+    if (!bAlreadyQueued)
+    {
+        NumUpToDate++;
+    }
+}
+
+int32 FObjectExporterPipeline::Flush(TArray<FString>* OutWrittenFiles)
+{
+    while (PendingWrites.Num() > 0)
+    {
+        Retire(0);
+    }
+
+    if (OutWrittenFiles != nullptr)
+    {
+        OutWrittenFiles->Append(WrittenFiles);
+    }
+    WrittenFiles.Reset();
+
+    const int32 Result = NumFailed;
+    NumFailed = 0;
+
+    return Result;
+}
+
+void FObjectExporterPipeline::ReserveMemory(SIZE_T AllocatedSize)
+{
+    for (int32 PendingIndex = PendingWrites.Num() - 1; PendingIndex >= 0; PendingIndex--)
+    {
+        if (PendingWrites[PendingIndex].Result.IsReady())
+        {
+            Retire(PendingIndex);
+        }
+    }
+
+    // A single snapshot larger than the budget still goes through once everything else is written
+    while (PendingWrites.Num() > 0 && InFlightBytes + AllocatedSize > MaxInFlightBytes)
+    {
+        Retire(0);
+    }
+}
+
+void FObjectExporterPipeline::Retire(int32 PendingIndex)
+{
+    FPendingWrite& PendingWrite = PendingWrites[PendingIndex];
+
+    if (PendingWrite.Result.Get())
+    {
+        WrittenFiles.Add(MoveTemp(PendingWrite.FullFilePathName));
+    }
+    else
+    {
+        NumFailed++;
+    }
+
+    InFlightBytes -= PendingWrite.AllocatedSize;
+
+    PendingWrites.RemoveAt(PendingIndex);
+}
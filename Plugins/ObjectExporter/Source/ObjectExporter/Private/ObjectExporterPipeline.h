@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "ObjectExporterAssetData.h"
+#include "ObjectExporterCache.h"
+
+/*
+*   Second phase of a multi asset export. The game thread gathers snapshots and queues them here,
+*   encoding and file writes then run on the thread pool.
+*
+*   Memory is bounded by ObjectExporter.MaxInFlightMemoryMB: Enqueue blocks the game thread while the
+*   snapshots in flight exceed the budget. Each output file is written once per pipeline.
+*   With a cache, every successful write is recorded so the next run can skip it.
+*/
+class FObjectExporterPipeline
+{
+public:
+    explicit FObjectExporterPipeline(FObjectExporterCache* InCache = nullptr);
+    ~FObjectExporterPipeline();
+
+    /** True if FullFilePathName was already queued, the caller can then skip gathering the asset. */
+    bool IsQueued(const FString& FullFilePathName) const;
+
+    /** Queues Data to be written to FullFilePathName. Returns false if the file was already queued. */
+    bool Enqueue(const FObjectExporterAssetDataPtr& Data, const FString& FullFilePathName, const FObjectExporterCacheKey& CacheKey = FObjectExporterCacheKey());
+
+    /** Counts FullFilePathName as exported without writing it, because the cache found it up to date. */
+    void MarkUpToDate(const FString& FullFilePathName);
+
+    int32 GetNumUpToDate() const
+    {
+        return NumUpToDate;
+    }
+
+    /**
+    *   Blocks until every queued asset has been written and returns the number of failed writes.
+    *   Appends the files written since the last Flush to OutWrittenFiles, files found up to date are not written.
+    */
+    int32 Flush(TArray<FString>* OutWrittenFiles = nullptr);
+
+private:
+    struct FPendingWrite
+    {
+        TFuture<bool> Result;
+        SIZE_T AllocatedSize;
+        FString FullFilePathName;
+    };
+
+    /** Retires finished writes, then waits on the oldest ones until AllocatedSize more fits the budget. */
+    void ReserveMemory(SIZE_T AllocatedSize);
+
+    void Retire(int32 PendingIndex);
+
+    FObjectExporterCache* Cache;
+    bool bParallel;
+    SIZE_T MaxInFlightBytes;
+    SIZE_T InFlightBytes;
+    int32 NumFailed;
+    int32 NumUpToDate;
+    TArray<FPendingWrite> PendingWrites;
+    TArray<FString> WrittenFiles;
+    TSet<FString> QueuedFiles;
+};
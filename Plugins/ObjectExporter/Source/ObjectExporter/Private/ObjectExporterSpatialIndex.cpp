@@ -0,0 +1,126 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterSpatialIndex.h"
+
+void FObjectExporterSpatialIndexBuilder::AddPrimitive(const FBox& Bounds, uint32 Type, uint32 Index)
+{
+    FEntry& Entry = Entries.AddDefaulted_GetRef();
+    Entry.Bounds = Bounds;
+    Entry.Centroid = Bounds.GetCenter();
+    Entry.Primitive.Type = Type;
+    Entry.Primitive.Index = Index;
+    Entry.Order = Entries.Num() - 1;
+}
+
+void FObjectExporterSpatialIndexBuilder::Build(TArray<FObjectExporterBVHNode>& OutNodes, TArray<FObjectExporterBVHPrimitive>& OutPrimitives)
+{
+    OutNodes.Reset();
+    OutPrimitives.Reset();
+
+    if (Entries.Num() > 0)
+    {
+        OutPrimitives.Reserve(Entries.Num());
+        BuildNode(0, Entries.Num(), OutNodes, OutPrimitives);
+    }
+}
+
+FBox FObjectExporterSpatialIndexBuilder::GetBounds(int32 FirstEntry, int32 NumEntries) const
+{
+    FBox Bounds(ForceInit);
+    for (int32 EntryIndex = FirstEntry; EntryIndex < FirstEntry + NumEntries; EntryIndex++)
+    {
+        Bounds += Entries[EntryIndex].Bounds;
+    }
+
+    return Bounds;
+}
+
+int32 FObjectExporterSpatialIndexBuilder::BuildNode(int32 FirstEntry, int32 NumEntries, TArray<FObjectExporterBVHNode>& OutNodes, TArray<FObjectExporterBVHPrimitive>& OutPrimitives)
+{
+    const int32 NodeIndex = OutNodes.AddZeroed();
+
+    // Split the largest range at its centroid median until there is one range per child
+    TArray<TPair<int32, int32>, TInlineAllocator<4>> Ranges;
+    Ranges.Emplace(FirstEntry, NumEntries);
+
+    while (Ranges.Num() < 4)
+    {
+        int32 LargestRange = INDEX_NONE;
+        for (int32 RangeIndex = 0; RangeIndex < Ranges.Num(); RangeIndex++)
+        {
+            if (Ranges[RangeIndex].Value > MaxLeafSize && (LargestRange == INDEX_NONE || Ranges[RangeIndex].Value > Ranges[LargestRange].Value))
+            {
+                LargestRange = RangeIndex;
+            }
+        }
+
+        if (LargestRange == INDEX_NONE)
+        {
+            break;
+        }
+
+        const int32 First = Ranges[LargestRange].Key;
+        const int32 Num = Ranges[LargestRange].Value;
+
+        FBox CentroidBounds(ForceInit);
+        for (int32 EntryIndex = First; EntryIndex < First + Num; EntryIndex++)
+        {
+            CentroidBounds += Entries[EntryIndex].Centroid;
+        }
+
+        const FVector CentroidExtent = CentroidBounds.GetExtent();
+        const int32 Axis = CentroidExtent.X >= CentroidExtent.Y ? (CentroidExtent.X >= CentroidExtent.Z ? 0 : 2) : (CentroidExtent.Y >= CentroidExtent.Z ? 1 : 2);
+
+        Sort(Entries.GetData() + First, Num, [Axis](const FEntry& A, const FEntry& B)
+        {
+            return A.Centroid[Axis] != B.Centroid[Axis] ? A.Centroid[Axis] < B.Centroid[Axis] : A.Order < B.Order;
+        });
+
+        const int32 NumLeft = Num / 2;
+        Ranges[LargestRange] = TPair<int32, int32>(First, NumLeft);
+        Ranges.Insert(TPair<int32, int32>(First + NumLeft, Num - NumLeft), LargestRange + 1);
+    }
+
+    for (int32 ChildIndex = 0; ChildIndex < 4; ChildIndex++)
+    {
+        FBox ChildBounds(ForceInit);
+        int32 Child = INDEX_NONE;
+        uint32 Count = 0;
+
+        if (ChildIndex < Ranges.Num())
+        {
+            const int32 First = Ranges[ChildIndex].Key;
+            const int32 Num = Ranges[ChildIndex].Value;
+
+            ChildBounds = GetBounds(First, Num);
+
+            if (Num <= MaxLeafSize)
+            {
+                Child = OutPrimitives.Num();
+                Count = Num;
+
+                for (int32 EntryIndex = First; EntryIndex < First + Num; EntryIndex++)
+                {
+                    OutPrimitives.Add(Entries[EntryIndex].Primitive);
+                }
+            }
+            else
+            {
+                Child = BuildNode(First, Num, OutNodes, OutPrimitives);
+            }
+        }
+
+        // Empty slots get inverted bounds, so they fail every overlap test without a branch
+        FObjectExporterBVHNode& Node = OutNodes[NodeIndex];
+        Node.MinX[ChildIndex] = ChildBounds.IsValid ? ChildBounds.Min.X : MAX_flt;
+        Node.MinY[ChildIndex] = ChildBounds.IsValid ? ChildBounds.Min.Y : MAX_flt;
+        Node.MinZ[ChildIndex] = ChildBounds.IsValid ? ChildBounds.Min.Z : MAX_flt;
+        Node.MaxX[ChildIndex] = ChildBounds.IsValid ? ChildBounds.Max.X : -MAX_flt;
+        Node.MaxY[ChildIndex] = ChildBounds.IsValid ? ChildBounds.Max.Y : -MAX_flt;
+        Node.MaxZ[ChildIndex] = ChildBounds.IsValid ? ChildBounds.Max.Z : -MAX_flt;
+        Node.Children[ChildIndex] = Child;
+        Node.Counts[ChildIndex] = Count;
+    }
+
+    return NodeIndex;
+}
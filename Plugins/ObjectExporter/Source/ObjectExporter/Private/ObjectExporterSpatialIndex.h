@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ObjectExporterFileFormat.h"
+
+/*
+*   Builds the 4-wide BVH baked into .map files.
+*
+*   Every node stores the bounds of its four children as SoA float[4] lanes, so a runtime can test all
+*   children against a frustum plane with one SIMD compare. Children are split at the centroid median
+*   of the largest axis, which keeps the build deterministic for identical input.
+*/
+class FObjectExporterSpatialIndexBuilder
+{
+public:
+    /** Largest number of primitives stored in a leaf. */
+    static constexpr int32 MaxLeafSize = 4;
+
+    void AddPrimitive(const FBox& Bounds, uint32 Type, uint32 Index);
+
+    void Build(TArray<FObjectExporterBVHNode>& OutNodes, TArray<FObjectExporterBVHPrimitive>& OutPrimitives);
+
+private:
+    struct FEntry
+    {
+        FBox Bounds;
+        FVector Centroid;
+        FObjectExporterBVHPrimitive Primitive;
+        int32 Order;
+    };
+
+    int32 BuildNode(int32 FirstEntry, int32 NumEntries, TArray<FObjectExporterBVHNode>& OutNodes, TArray<FObjectExporterBVHPrimitive>& OutPrimitives);
+
+    FBox GetBounds(int32 FirstEntry, int32 NumEntries) const;
+
+    TArray<FEntry> Entries;
+};
@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterStats.h"
+#include "Misc/ScopeLock.h"
+
+DECLARE_LOG_CATEGORY_CLASS(ObjectExporterStatsLog, Log, All);
+
+namespace ObjectExporterStats
+{
+    static FCriticalSection SessionCritical;
+    static TArray<FObjectExporterAssetTiming> SessionTimings;
+    static int32 SessionDepth = 0;
+    static double SessionStartTime = 0.0;
+
+    void BeginSession()
+    {
+        FScopeLock Lock(&SessionCritical);
+
+        if (SessionDepth++ == 0)
+        {
+            SessionTimings.Reset();
+            SessionStartTime = FPlatformTime::Seconds();
+        }
+    }
+
+    void Record(const FObjectExporterAssetTiming& Timing)
+    {
+        UE_LOG(ObjectExporterStatsLog, Log, TEXT("%s %s: gather %.2f ms, write %.2f ms, %llu bytes."),
+            Timing.AssetType, *Timing.AssetName, Timing.GatherSeconds * 1000.0, Timing.WriteSeconds * 1000.0, Timing.FileSize);
+
+        FScopeLock Lock(&SessionCritical);
+
+        if (SessionDepth > 0)
+        {
+            SessionTimings.Add(Timing);
+        }
+    }
+
+    FObjectExporterSessionTotals EndSession(const FString& SessionName)
+    {
+        FScopeLock Lock(&SessionCritical);
+
+        FObjectExporterSessionTotals Totals;
+        if (SessionDepth == 0 || --SessionDepth > 0)
+        {
+            return Totals;
+        }
+
+        SessionTimings.Sort([](const FObjectExporterAssetTiming& A, const FObjectExporterAssetTiming& B)
+        {
+            return A.GatherSeconds + A.WriteSeconds > B.GatherSeconds + B.WriteSeconds;
+        });
+
+        UE_LOG(ObjectExporterStatsLog, Log, TEXT("%s: %d assets exported, slowest first:"), *SessionName, SessionTimings.Num());
+
+        for (const FObjectExporterAssetTiming& Timing : SessionTimings)
+        {
+            UE_LOG(ObjectExporterStatsLog, Log, TEXT("    %-12s %-40s gather %8.2f ms  write %8.2f ms  %10llu bytes"),
+                Timing.AssetType, *Timing.AssetName, Timing.GatherSeconds * 1000.0, Timing.WriteSeconds * 1000.0, Timing.FileSize);
+
+            Totals.GatherSeconds += Timing.GatherSeconds;
+            Totals.WriteSeconds += Timing.WriteSeconds;
+            Totals.FileSize += Timing.FileSize;
+        }
+
+        Totals.NumAssets = SessionTimings.Num();
+        Totals.WallSeconds = FPlatformTime::Seconds() - SessionStartTime;
+
+        UE_LOG(ObjectExporterStatsLog, Log, TEXT("%s: gather %.2f ms, write %.2f ms, %llu bytes, wall %.2f ms."),
+            *SessionName, Totals.GatherSeconds * 1000.0, Totals.WriteSeconds * 1000.0, Totals.FileSize, Totals.WallSeconds * 1000.0);
+
+        SessionTimings.Reset();
+
+        return Totals;
+    }
+}
@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Time spent on a single exported asset. */
+struct FObjectExporterAssetTiming
+{
+    FObjectExporterAssetTiming(const TCHAR* InAssetType, const FString& InAssetName)
+        : AssetType(InAssetType)
+        , AssetName(InAssetName)
+        , StartTime(FPlatformTime::Seconds())
+        , GatherSeconds(0.0)
+        , WriteSeconds(0.0)
+        , FileSize(0)
+    {
+    }
+
+    /** Ends the gather phase (reading engine data into staging buffers). */
+    void EndGather()
+    {
+        GatherSeconds = FPlatformTime::Seconds() - StartTime;
+    }
+
+    /** Starts the write phase (encoding and saving), which may run later and on another thread. */
+    void BeginWrite()
+    {
+        StartTime = FPlatformTime::Seconds();
+    }
+
+    void EndWrite(uint64 InFileSize)
+    {
+        WriteSeconds = FPlatformTime::Seconds() - StartTime;
+        FileSize = InFileSize;
+    }
+
+    const TCHAR* AssetType;
+    FString AssetName;
+    double StartTime;
+    double GatherSeconds;
+    double WriteSeconds;
+    uint64 FileSize;
+};
+
+/** Sums over the assets of a session. */
+struct FObjectExporterSessionTotals
+{
+    FObjectExporterSessionTotals()
+        : NumAssets(0)
+        , GatherSeconds(0.0)
+        , WriteSeconds(0.0)
+        , FileSize(0)
+        , WallSeconds(0.0)
+    {
+    }
+
+    int32 NumAssets;
+    double GatherSeconds;
+    double WriteSeconds;
+    uint64 FileSize;
+    double WallSeconds;
+};
+
+/*
+*   Per-asset export timings. Every record is logged, and records made between BeginSession and EndSession
+*   are summarized at the end so a whole map export can be compared before and after a change.
+*/
+namespace ObjectExporterStats
+{
+    void BeginSession();
+    void Record(const FObjectExporterAssetTiming& Timing);
+
+    /** Returns the totals of the session, or zeros when it ends a nested session. */
+    FObjectExporterSessionTotals EndSession(const FString& SessionName);
+}
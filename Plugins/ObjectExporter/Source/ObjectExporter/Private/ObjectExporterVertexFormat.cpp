@@ -0,0 +1,345 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterVertexFormat.h"
+#include "ObjectExporterFileWriter.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/Float16.h"
+
+DECLARE_LOG_CATEGORY_CLASS(ObjectExporterVertexFormatLog, Log, All);
+
+static TAutoConsoleVariable<int32> CVarObjectExporterQuantizeVertices(
+    TEXT("ObjectExporter.QuantizeVertices"),
+    0,
+    TEXT("0: write mesh vertices as full floats (default).\n")
+    TEXT("1: pick the smallest vertex encodings within ObjectExporter.PositionErrorBudget and ObjectExporter.UVErrorBudget for each mesh."));
+
+static TAutoConsoleVariable<float> CVarObjectExporterPositionErrorBudget(
+    TEXT("ObjectExporter.PositionErrorBudget"),
+    0.01f,
+    TEXT("Largest position error allowed by vertex quantization, in world units."));
+
+static TAutoConsoleVariable<float> CVarObjectExporterUVErrorBudget(
+    TEXT("ObjectExporter.UVErrorBudget"),
+    1.0f / 2048.0f,
+    TEXT("Largest texture coordinate error allowed by vertex quantization. The default is half a texel of a 1024 texture."));
+
+FObjectExporterVertexFormatSettings FObjectExporterVertexFormatSettings::Get()
+{
+    FObjectExporterVertexFormatSettings Settings;
+    Settings.bQuantize = CVarObjectExporterQuantizeVertices.GetValueOnGameThread() != 0;
+    Settings.PositionErrorBudget = CVarObjectExporterPositionErrorBudget.GetValueOnGameThread();
+    Settings.UVErrorBudget = CVarObjectExporterUVErrorBudget.GetValueOnGameThread();
+
+    return Settings;
+}
+
+static uint32 GetElementSize(EObjectExporterVertexElementFormat Format)
+{
+    switch (Format)
+    {
+    case EObjectExporterVertexElementFormat::Float2:
+        return 8;
+    case EObjectExporterVertexElementFormat::Float3:
+        return 12;
+    case EObjectExporterVertexElementFormat::Float4:
+        return 16;
+    case EObjectExporterVertexElementFormat::Half2:
+        return 4;
+    case EObjectExporterVertexElementFormat::Half4:
+        return 8;
+    case EObjectExporterVertexElementFormat::UNorm16x4:
+        return 8;
+    case EObjectExporterVertexElementFormat::OctahedralSNorm16x2:
+        return 4;
+    case EObjectExporterVertexElementFormat::UInt8x4:
+        return 4;
+    case EObjectExporterVertexElementFormat::UInt16x4:
+        return 8;
+    case EObjectExporterVertexElementFormat::UNorm8x4:
+        return 4;
+    default:
+        checkNoEntry();
+        return 0;
+    }
+}
+
+static const TCHAR* GetElementFormatName(EObjectExporterVertexElementFormat Format)
+{
+    switch (Format)
+    {
+    case EObjectExporterVertexElementFormat::Float2:
+        return TEXT("Float2");
+    case EObjectExporterVertexElementFormat::Float3:
+        return TEXT("Float3");
+    case EObjectExporterVertexElementFormat::Float4:
+        return TEXT("Float4");
+    case EObjectExporterVertexElementFormat::Half2:
+        return TEXT("Half2");
+    case EObjectExporterVertexElementFormat::Half4:
+        return TEXT("Half4");
+    case EObjectExporterVertexElementFormat::UNorm16x4:
+        return TEXT("UNorm16x4");
+    case EObjectExporterVertexElementFormat::OctahedralSNorm16x2:
+        return TEXT("OctahedralSNorm16x2");
+    case EObjectExporterVertexElementFormat::UInt8x4:
+        return TEXT("UInt8x4");
+    case EObjectExporterVertexElementFormat::UInt16x4:
+        return TEXT("UInt16x4");
+    case EObjectExporterVertexElementFormat::UNorm8x4:
+        return TEXT("UNorm8x4");
+    default:
+        return TEXT("Unknown");
+    }
+}
+
+static FObjectExporterVertexAttribute AddAttribute(TArray<FObjectExporterVertexAttribute>& Attributes, uint32& Stride,
+    EObjectExporterVertexSemantic Semantic, EObjectExporterVertexElementFormat Format, uint32 Stream,
+    const FVector& Scale = FVector::OneVector, const FVector& Bias = FVector::ZeroVector)
+{
+    FObjectExporterVertexAttribute& Attribute = Attributes.AddZeroed_GetRef();
+    Attribute.Semantic = (uint32)Semantic;
+    Attribute.Format = (uint32)Format;
+    Attribute.Stream = Stream;
+    Attribute.Offset = Stride;
+    ObjectExporterFile::CopyVector(Attribute.Scale, Scale);
+    ObjectExporterFile::CopyVector(Attribute.Bias, Bias);
+
+    Stride += Align(GetElementSize(Format), 4);
+
+    return Attribute;
+}
+
+static float GetHalfError(float Value)
+{
+    return FMath::Abs(FFloat16(Value).GetFloat() - Value);
+}
+
+static uint16 QuantizeUNorm16(float Value, float Bias, float Scale)
+{
+    return Scale > 0.0f ? (uint16)FMath::Clamp(FMath::RoundToInt((Value - Bias) / Scale * 65535.0f), 0, 65535) : 0;
+}
+
+static void EncodeOctahedral(const float* Normal, int16* OutEncoded)
+{
+    const float L1Norm = FMath::Abs(Normal[0]) + FMath::Abs(Normal[1]) + FMath::Abs(Normal[2]);
+    float X = L1Norm > SMALL_NUMBER ? Normal[0] / L1Norm : 0.0f;
+    float Y = L1Norm > SMALL_NUMBER ? Normal[1] / L1Norm : 0.0f;
+
+    // Fold the lower hemisphere over the diagonals
+    if (Normal[2] < 0.0f)
+    {
+        const float FoldedX = (1.0f - FMath::Abs(Y)) * (X >= 0.0f ? 1.0f : -1.0f);
+        const float FoldedY = (1.0f - FMath::Abs(X)) * (Y >= 0.0f ? 1.0f : -1.0f);
+        X = FoldedX;
+        Y = FoldedY;
+    }
+
+    OutEncoded[0] = (int16)FMath::RoundToInt(FMath::Clamp(X, -1.0f, 1.0f) * 32767.0f);
+    OutEncoded[1] = (int16)FMath::RoundToInt(FMath::Clamp(Y, -1.0f, 1.0f) * 32767.0f);
+}
+
+static void WriteFloatAttribute(uint8* Dest, const FObjectExporterVertexAttribute& Attribute, const float* Values, int32 NumValues)
+{
+    switch ((EObjectExporterVertexElementFormat)Attribute.Format)
+    {
+    case EObjectExporterVertexElementFormat::Float2:
+    case EObjectExporterVertexElementFormat::Float3:
+    case EObjectExporterVertexElementFormat::Float4:
+        FMemory::Memcpy(Dest, Values, NumValues * sizeof(float));
+        break;
+    case EObjectExporterVertexElementFormat::Half2:
+    case EObjectExporterVertexElementFormat::Half4:
+        for (int32 Component = 0; Component < NumValues; Component++)
+        {
+            const FFloat16 Half(Values[Component]);
+            FMemory::Memcpy(Dest + Component * sizeof(uint16), &Half.Encoded, sizeof(uint16));
+        }
+        break;
+    case EObjectExporterVertexElementFormat::UNorm16x4:
+        for (int32 Component = 0; Component < NumValues; Component++)
+        {
+            const uint16 Quantized = QuantizeUNorm16(Values[Component], Attribute.Bias[Component], Attribute.Scale[Component]);
+            FMemory::Memcpy(Dest + Component * sizeof(uint16), &Quantized, sizeof(uint16));
+        }
+        break;
+    case EObjectExporterVertexElementFormat::OctahedralSNorm16x2:
+        {
+            int16 Encoded[2];
+            EncodeOctahedral(Values, Encoded);
+            FMemory::Memcpy(Dest, Encoded, sizeof(Encoded));
+        }
+        break;
+    default:
+        checkNoEntry();
+        break;
+    }
+}
+
+void ObjectExporterVertexFormat::AddVertexChunks(FObjectExporterFileWriter& FileWriter, const FString& AssetName, const FObjectExporterVertexFormatSettings& Settings,
+    const TArray<FObjectExporterMeshVertex>& Vertices, const TArray<FObjectExporterSkinWeight>* SkinWeights)
+{
+    EObjectExporterVertexElementFormat PositionFormat = EObjectExporterVertexElementFormat::Float3;
+    EObjectExporterVertexElementFormat NormalFormat = EObjectExporterVertexElementFormat::Float3;
+    EObjectExporterVertexElementFormat UVFormat = EObjectExporterVertexElementFormat::Float2;
+    EObjectExporterVertexElementFormat BoneIndexFormat = EObjectExporterVertexElementFormat::UInt16x4;
+    EObjectExporterVertexElementFormat BoneWeightFormat = EObjectExporterVertexElementFormat::Float4;
+
+    FBox Bounds(ForceInit);
+    for (const FObjectExporterMeshVertex& Vertex : Vertices)
+    {
+        Bounds += FVector(Vertex.Position[0], Vertex.Position[1], Vertex.Position[2]);
+    }
+    const FVector BoundsMin = Bounds.IsValid ? Bounds.Min : FVector::ZeroVector;
+    const FVector BoundsRange = Bounds.IsValid ? Bounds.Max - Bounds.Min : FVector::ZeroVector;
+
+    float PositionError = 0.0f;
+    float UVError = 0.0f;
+
+    if (Settings.bQuantize)
+    {
+        // Measure the actual error of each candidate encoding over the whole mesh
+        float UNormPositionError = 0.0f;
+        float HalfPositionError = 0.0f;
+        float HalfUVError = 0.0f;
+
+        for (const FObjectExporterMeshVertex& Vertex : Vertices)
+        {
+            for (int32 Component = 0; Component < 3; Component++)
+            {
+                const uint16 Quantized = QuantizeUNorm16(Vertex.Position[Component], BoundsMin[Component], BoundsRange[Component]);
+                const float Dequantized = Quantized / 65535.0f * BoundsRange[Component] + BoundsMin[Component];
+                UNormPositionError = FMath::Max(UNormPositionError, FMath::Abs(Dequantized - Vertex.Position[Component]));
+                HalfPositionError = FMath::Max(HalfPositionError, GetHalfError(Vertex.Position[Component]));
+            }
+
+            for (int32 Component = 0; Component < 2; Component++)
+            {
+                HalfUVError = FMath::Max(HalfUVError, GetHalfError(Vertex.UV[Component]));
+            }
+        }
+
+        if (UNormPositionError <= Settings.PositionErrorBudget)
+        {
+            PositionFormat = EObjectExporterVertexElementFormat::UNorm16x4;
+            PositionError = UNormPositionError;
+        }
+        else if (HalfPositionError <= Settings.PositionErrorBudget)
+        {
+            PositionFormat = EObjectExporterVertexElementFormat::Half4;
+            PositionError = HalfPositionError;
+        }
+
+        if (HalfUVError <= Settings.UVErrorBudget)
+        {
+            UVFormat = EObjectExporterVertexElementFormat::Half2;
+            UVError = HalfUVError;
+        }
+
+        // Octahedral 16 bit normals are within 0.01 degree, below any useful budget
+        NormalFormat = EObjectExporterVertexElementFormat::OctahedralSNorm16x2;
+
+        if (SkinWeights != nullptr)
+        {
+            uint16 MaxBoneIndex = 0;
+            for (const FObjectExporterSkinWeight& SkinWeight : *SkinWeights)
+            {
+                for (int32 Influence = 0; Influence < 4; Influence++)
+                {
+                    MaxBoneIndex = FMath::Max(MaxBoneIndex, SkinWeight.BoneIndices[Influence]);
+                }
+            }
+
+            BoneIndexFormat = MaxBoneIndex <= MAX_uint8 ? EObjectExporterVertexElementFormat::UInt8x4 : EObjectExporterVertexElementFormat::UInt16x4;
+
+            // The engine stores weights as 8 bit already, so this is lossless
+            BoneWeightFormat = EObjectExporterVertexElementFormat::UNorm8x4;
+        }
+    }
+
+    TArray<FObjectExporterVertexAttribute> Attributes;
+    uint32 VertexStride = 0;
+    uint32 SkinStride = 0;
+
+    const bool bRelativePositions = PositionFormat == EObjectExporterVertexElementFormat::UNorm16x4;
+    const FObjectExporterVertexAttribute PositionAttribute = AddAttribute(Attributes, VertexStride, EObjectExporterVertexSemantic::Position, PositionFormat, 0,
+        bRelativePositions ? BoundsRange : FVector::OneVector, bRelativePositions ? BoundsMin : FVector::ZeroVector);
+    const FObjectExporterVertexAttribute NormalAttribute = AddAttribute(Attributes, VertexStride, EObjectExporterVertexSemantic::Normal, NormalFormat, 0);
+    const FObjectExporterVertexAttribute UVAttribute = AddAttribute(Attributes, VertexStride, EObjectExporterVertexSemantic::TexCoord0, UVFormat, 0);
+
+    TArray<uint8>& VertexStream = FileWriter.AddChunk(ObjectExporterChunk::Vertices, VertexStride);
+    VertexStream.AddZeroed(Vertices.Num() * VertexStride);
+
+    for (int32 iVertex = 0; iVertex < Vertices.Num(); iVertex++)
+    {
+        const FObjectExporterMeshVertex& Vertex = Vertices[iVertex];
+        uint8* Dest = VertexStream.GetData() + iVertex * VertexStride;
+
+        WriteFloatAttribute(Dest + PositionAttribute.Offset, PositionAttribute, Vertex.Position, 3);
+        WriteFloatAttribute(Dest + NormalAttribute.Offset, NormalAttribute, Vertex.Normal, 3);
+        WriteFloatAttribute(Dest + UVAttribute.Offset, UVAttribute, Vertex.UV, 2);
+    }
+
+    if (SkinWeights != nullptr)
+    {
+        const FObjectExporterVertexAttribute BoneIndexAttribute = AddAttribute(Attributes, SkinStride, EObjectExporterVertexSemantic::BoneIndices, BoneIndexFormat, 1);
+        const FObjectExporterVertexAttribute BoneWeightAttribute = AddAttribute(Attributes, SkinStride, EObjectExporterVertexSemantic::BoneWeights, BoneWeightFormat, 1);
+
+        TArray<uint8>& SkinStream = FileWriter.AddChunk(ObjectExporterChunk::SkinWeights, SkinStride);
+        SkinStream.AddZeroed(SkinWeights->Num() * SkinStride);
+
+        for (int32 iVertex = 0; iVertex < SkinWeights->Num(); iVertex++)
+        {
+            const FObjectExporterSkinWeight& SkinWeight = (*SkinWeights)[iVertex];
+            uint8* Dest = SkinStream.GetData() + iVertex * SkinStride;
+
+            if (BoneIndexFormat == EObjectExporterVertexElementFormat::UInt8x4)
+            {
+                for (int32 Influence = 0; Influence < 4; Influence++)
+                {
+                    Dest[BoneIndexAttribute.Offset + Influence] = (uint8)SkinWeight.BoneIndices[Influence];
+                }
+            }
+            else
+            {
+                FMemory::Memcpy(Dest + BoneIndexAttribute.Offset, SkinWeight.BoneIndices, sizeof(SkinWeight.BoneIndices));
+            }
+
+            if (BoneWeightFormat == EObjectExporterVertexElementFormat::UNorm8x4)
+            {
+                // Rounding must not change the sum of the weights, the largest influence absorbs the difference
+                int32 QuantizedSum = 0;
+                int32 LargestInfluence = 0;
+                uint8* QuantizedWeights = Dest + BoneWeightAttribute.Offset;
+                for (int32 Influence = 0; Influence < 4; Influence++)
+                {
+                    QuantizedWeights[Influence] = (uint8)FMath::Clamp(FMath::RoundToInt(SkinWeight.BoneWeights[Influence] * 255.0f), 0, 255);
+                    QuantizedSum += QuantizedWeights[Influence];
+                    if (SkinWeight.BoneWeights[Influence] > SkinWeight.BoneWeights[LargestInfluence])
+                    {
+                        LargestInfluence = Influence;
+                    }
+                }
+
+                if (QuantizedSum > 0)
+                {
+                    QuantizedWeights[LargestInfluence] = (uint8)FMath::Clamp(QuantizedWeights[LargestInfluence] + 255 - QuantizedSum, 0, 255);
+                }
+            }
+            else
+            {
+                FMemory::Memcpy(Dest + BoneWeightAttribute.Offset, SkinWeight.BoneWeights, sizeof(SkinWeight.BoneWeights));
+            }
+        }
+    }
+
+    FileWriter.AddChunk(ObjectExporterChunk::VertexFormat, Attributes);
+
+    if (Settings.bQuantize)
+    {
+        const uint32 SourceStride = sizeof(FObjectExporterMeshVertex) + (SkinWeights != nullptr ? sizeof(FObjectExporterSkinWeight) : 0);
+
+        UE_LOG(ObjectExporterVertexFormatLog, Log, TEXT("%s: position %s (error %g), normal %s, uv %s (error %g), %u -> %u bytes per vertex."),
+            *AssetName, GetElementFormatName(PositionFormat), PositionError, GetElementFormatName(NormalFormat), GetElementFormatName(UVFormat), UVError,
+            SourceStride, VertexStride + SkinStride);
+    }
+}
@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ObjectExporterFileFormat.h"
+
+class FObjectExporterFileWriter;
+
+/** Vertex encoding options, read from the ObjectExporter.* console variables when a mesh is gathered. */
+struct FObjectExporterVertexFormatSettings
+{
+    bool bQuantize = false;
+    float PositionErrorBudget = 0.0f;
+    float UVErrorBudget = 0.0f;
+
+    /** Game thread only. */
+    static FObjectExporterVertexFormatSettings Get();
+};
+
+namespace ObjectExporterVertexFormat
+{
+    /**
+    *   Writes VFMT and VERT, plus SKIN when SkinWeights is not null.
+    *
+    *   Without quantization the streams keep the FObjectExporterMeshVertex and FObjectExporterSkinWeight layouts.
+    *   With quantization every attribute gets the smallest encoding whose measured error stays within the budget:
+    *   positions as 16 bit relative to the mesh bounds or half floats, normals octahedral 16 bit, UVs half floats,
+    *   bone indices 8 bit when every bone fits and weights unorm8. Attributes are 4 byte aligned.
+    */
+    void AddVertexChunks(FObjectExporterFileWriter& FileWriter, const FString& AssetName, const FObjectExporterVertexFormatSettings& Settings,
+        const TArray<FObjectExporterMeshVertex>& Vertices, const TArray<FObjectExporterSkinWeight>* SkinWeights);
+}
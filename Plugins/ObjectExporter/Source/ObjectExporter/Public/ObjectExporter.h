@@ -4,6 +4,8 @@
 
 #include "Modules/ModuleManager.h"
 
+class FObjectExporterLiveExport;
+
 class FObjectExporterModule : public IModuleInterface
 {
 public:
@@ -11,4 +13,9 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+
+	/** Re-exports saved assets and moved actors, see ObjectExporter.LiveExport */
+	TUniquePtr<FObjectExporterLiveExport> LiveExport;
 };
@@ -45,7 +45,36 @@ class UObjectExporterBPLibrary : public UBlueprintFunctionLibrary
     UFUNCTION(BlueprintCallable, meta = (DisplayName = "Export MaterialInstace", Keywords = "Export MaterialInstace"), Category = "UObjectExporter")
     static bool ExportMaterialInstance(const UMaterialInstance* MaterialInstace, const FString& FullFilePathName);
 
+    /** Writes the map file and the assets it uses. False if the map or, outside of a batch, any of its assets failed. */
     UFUNCTION(BlueprintCallable, meta = (DisplayName = "Export Map", Keywords = "Export Map"), Category = "UObjectExporter")
     static bool ExportMap(UObject* WorldContextObject, const FString& FullFilePathName);
 
+    /**
+    *   Maps exported between BeginMapExportBatch and EndMapExportBatch share one export pipeline and cache: an asset used
+    *   by several maps is written once, and the asset writes of a map continue while the next map is loaded and gathered.
+    *   ExportMap then writes the map files right away, EndMapExportBatch waits for the assets and returns how many failed.
+    */
+    static void BeginMapExportBatch();
+    static int32 EndMapExportBatch();
+
+    /** ExportMap without exporting the assets the map uses, for maps whose actors changed but whose assets did not. */
+    static bool ExportMapRecords(UObject* WorldContextObject, const FString& FullFilePathName);
+
+    /** The file ExportMap last wrote World to in this session, Saved/Bin/Map/<MapName>.map if it did not. */
+    static FString GetMapFilePathName(const UWorld* World);
+
+    /** The file ExportMap writes Asset to, empty for assets it does not export. */
+    static FString GetAssetFilePathName(const UObject* Asset);
+
+    /**
+    *   Exports meshes, skeletons, anim sequences, material instances and textures to their GetAssetFilePathName files
+    *   in parallel, skipping the ones the export cache finds up to date. Returns the number of failed assets and lists
+    *   the files it wrote in OutFilePathNames, failed and up to date ones are left out.
+    */
+    static int32 ExportAssets(const TArray<UObject*>& Assets, TArray<FString>& OutFilePathNames);
+
+    /** Logs the pose sampling cost of the raw and frame major animation layouts, e.g. for a TutorialTPP_Skeleton sequence. */
+    UFUNCTION(BlueprintCallable, meta = (DisplayName = "Benchmark AnimSequence Sampling", Keywords = "Benchmark AnimSequence Sampling"), Category = "UObjectExporter")
+    static bool BenchmarkAnimSequenceSampling(const UAnimSequence* AnimSequence, int32 NumPoses = 10000);
+
 };
@@ -0,0 +1,32 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "ObjectExporterCommandlet.generated.h"
+
+/*
+*   Exports maps without the editor UI, e.g. as an unattended job on a build machine:
+*
+*   UE4Editor-Cmd TestUE.uproject -run=ObjectExporter -Maps=MainMap+TestVT+REngineMap -nullrhi -unattended
+*
+*   (UE4Editor on Linux and Mac, which run commandlets from the editor binary.)
+*
+*   -Maps=          '+' separated map names, searched for under the content directories, or long package names.
+*   -Output=        Directory of the .map files, Saved/Bin/Map/ by default. Assets go to Saved/Bin/ as with ExportMap.
+*   -Report=        JSON summary of the run, Saved/Bin/ExportReport.json by default.
+*   -ObjectExporter.<Name>=<Value>  Sets an exporter console variable, e.g. -ObjectExporter.MapCellSize=25600.
+*
+*   Worlds can only be loaded on the game thread, so the maps are loaded and gathered one after the other. They are
+*   exported as one batch (see UObjectExporterBPLibrary::BeginMapExportBatch): the assets of every map are encoded and
+*   written on the thread pool while the next maps load, and assets shared by several maps are written once.
+*
+*   Returns 0 if every map and every asset was exported.
+*/
+UCLASS()
+class UObjectExporterCommandlet : public UCommandlet
+{
+    GENERATED_UCLASS_BODY()
+
+    virtual int32 Main(const FString& Params) override;
+};
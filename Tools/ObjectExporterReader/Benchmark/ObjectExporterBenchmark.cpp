@@ -0,0 +1,500 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterLegacyReader.h"
+#include "ObjectExporterReader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+/*
+*   Loads every exported file under the given paths (files or directories, Saved/Bin by default) and reports per format:
+*   load latency, throughput and the peak resident memory a load adds.
+*
+*   A load is what a runtime does before using a file: map it, validate it, build the views and read every byte once,
+*   as an upload to the GPU would. Both container files and legacy headerless files are measured, the Layout column
+*   tells which ones a format had.
+*
+*   ObjectExporterBenchmark [--iterations N] [--cold] [Path...]
+*
+*   --cold drops the files from the page cache before every load (as far as the kernel lets an unprivileged process),
+*   measuring disk reads instead of memory mapping.
+*/
+
+using namespace ObjectExporterReader;
+
+#ifndef OBJECT_EXPORTER_FIXTURES_DIR
+#define OBJECT_EXPORTER_FIXTURES_DIR "Saved/Bin"
+#endif
+
+#define BENCHMARK_DEFAULT_ITERATIONS 20
+
+namespace
+{
+
+const char* const FormatExtensions[] = { ".stm", ".skm", ".skt", ".anm", ".mat", ".tex", ".map" };
+
+struct FFormatStats
+{
+    const char* Extension;
+    std::vector<std::string> Files;
+    std::vector<double> Latencies;
+    uint64 FileBytes = 0;
+    uint64 LoadedBytes = 0;
+    double TotalSeconds = 0.0;
+    int64 PeakMemoryKB = -1;
+    uint32 NumContainerFiles = 0;
+    uint32 NumLegacyFiles = 0;
+    uint32 NumFailures = 0;
+};
+
+/** Reads every byte of the mapping, so that the measured time includes the page faults. */
+uint64 TouchFile(const FMappedFile& File)
+{
+    uint64 Checksum = 0;
+    const uint8* Data = File.GetData();
+    const uint64 NumWords = File.GetSize() / sizeof(uint64);
+
+    for (uint64 Word = 0; Word < NumWords; Word++)
+    {
+        uint64 Value;
+        std::memcpy(&Value, Data + Word * sizeof(uint64), sizeof(Value));
+        Checksum += Value;
+    }
+
+    for (uint64 Byte = NumWords * sizeof(uint64); Byte < File.GetSize(); Byte++)
+    {
+        Checksum += Data[Byte];
+    }
+
+    return Checksum;
+}
+
+EReadResult OpenContainerViews(const FContainer& Container)
+{
+    switch (Container.GetFileType())
+    {
+    case ObjectExporterFile::StaticMesh:
+    {
+        FStaticMeshView View;
+        const EReadResult Result = View.Open(Container);
+        return Result == EReadResult::Success && (!View.ValidateIndices() || !View.ValidateMeshletCones()) ? EReadResult::BadReference : Result;
+    }
+    case ObjectExporterFile::SkeletalMesh:
+    {
+        FSkeletalMeshView View;
+        const EReadResult Result = View.Open(Container);
+        return Result == EReadResult::Success && !View.ValidateIndices() ? EReadResult::BadReference : Result;
+    }
+    case ObjectExporterFile::Skeleton:
+        return FSkeletonView().Open(Container);
+    case ObjectExporterFile::AnimSequence:
+        return FAnimSequenceView().Open(Container);
+    case ObjectExporterFile::Material:
+        return FMaterialView().Open(Container);
+    case ObjectExporterFile::Texture:
+        return FTextureView().Open(Container);
+    case ObjectExporterFile::Map:
+    {
+        // A streaming runtime opens the cells of a partitioned map one at a time, a load opens all of them
+        FMapView View;
+        EReadResult Result = View.Open(Container);
+        for (uint32 CellIndex = 0; CellIndex < View.Cells.GetNum() && Result == EReadResult::Success; CellIndex++)
+        {
+            const TView<uint8> CellData = View.GetCellData(CellIndex);
+
+            FContainer CellContainer;
+            Result = CellContainer.Open(CellData.GetData(), CellData.GetNum());
+            if (Result == EReadResult::Success)
+            {
+                Result = CellContainer.GetFileType() == ObjectExporterFile::MapCell ? FMapView().Open(CellContainer) : EReadResult::WrongFileType;
+            }
+        }
+
+        return Result;
+    }
+    }
+
+    return EReadResult::UnknownFileType;
+}
+
+EReadResult OpenLegacyFile(const char* Extension, const FMappedFile& File)
+{
+    const uint8* Data = File.GetData();
+    const uint64 Size = File.GetSize();
+
+    if (std::strcmp(Extension, ".stm") == 0)
+    {
+        FLegacyStaticMesh StaticMesh;
+        return ReadLegacyStaticMesh(Data, Size, StaticMesh);
+    }
+    if (std::strcmp(Extension, ".skm") == 0)
+    {
+        FLegacySkeletalMesh SkeletalMesh;
+        return ReadLegacySkeletalMesh(Data, Size, SkeletalMesh);
+    }
+    if (std::strcmp(Extension, ".skt") == 0)
+    {
+        FLegacySkeleton Skeleton;
+        return ReadLegacySkeleton(Data, Size, Skeleton);
+    }
+    if (std::strcmp(Extension, ".anm") == 0)
+    {
+        FLegacyAnimSequence AnimSequence;
+        return ReadLegacyAnimSequence(Data, Size, AnimSequence);
+    }
+    if (std::strcmp(Extension, ".mat") == 0)
+    {
+        FLegacyMaterial Material;
+        return ReadLegacyMaterial(Data, Size, Material);
+    }
+    if (std::strcmp(Extension, ".map") == 0)
+    {
+        FLegacyMap Map;
+        return ReadLegacyMap(Data, Size, Map);
+    }
+
+    // Textures only exist as containers
+    return EReadResult::UnknownFileType;
+}
+
+bool IsContainer(const FMappedFile& File)
+{
+    uint32 Magic = 0;
+    if (File.GetSize() >= sizeof(Magic))
+    {
+        std::memcpy(&Magic, File.GetData(), sizeof(Magic));
+    }
+
+    return Magic == ObjectExporterFile::Magic;
+}
+
+void DropFromPageCache(const std::string& FilePathName)
+{
+    const int FileHandle = open(FilePathName.c_str(), O_RDONLY);
+    if (FileHandle >= 0)
+    {
+        posix_fadvise(FileHandle, 0, 0, POSIX_FADV_DONTNEED);
+        close(FileHandle);
+    }
+}
+
+EReadResult LoadFile(const char* Extension, const std::string& FilePathName, bool& bOutContainer, uint64& OutChecksum)
+{
+    FMappedFile File;
+    if (!File.Open(FilePathName.c_str()))
+    {
+        return EReadResult::OpenFailed;
+    }
+
+    bOutContainer = IsContainer(File);
+
+    EReadResult Result;
+    if (bOutContainer)
+    {
+        FContainer Container;
+        Result = Container.Open(File.GetData(), File.GetSize());
+        if (Result == EReadResult::Success)
+        {
+            Result = OpenContainerViews(Container);
+        }
+    }
+    else
+    {
+        Result = OpenLegacyFile(Extension, File);
+    }
+
+    if (Result == EReadResult::Success)
+    {
+        OutChecksum += TouchFile(File);
+    }
+
+    return Result;
+}
+
+/** Value of a "Name: 1234 kB" line of /proc/self/status, -1 if unavailable. */
+int64 ReadProcessStatusKB(const char* Name)
+{
+    FILE* Status = std::fopen("/proc/self/status", "r");
+    if (Status == nullptr)
+    {
+        return -1;
+    }
+
+    int64 Value = -1;
+    const size_t NameLength = std::strlen(Name);
+
+    char Line[256];
+    while (std::fgets(Line, sizeof(Line), Status) != nullptr)
+    {
+        if (std::strncmp(Line, Name, NameLength) == 0 && Line[NameLength] == ':')
+        {
+            Value = std::atoll(Line + NameLength + 1);
+            break;
+        }
+    }
+
+    std::fclose(Status);
+
+    return Value;
+}
+
+/** Resets the peak resident size (VmHWM) to the current one, so that each format gets its own peak. */
+bool ResetPeakMemory()
+{
+    FILE* ClearRefs = std::fopen("/proc/self/clear_refs", "w");
+    if (ClearRefs == nullptr)
+    {
+        return false;
+    }
+
+    const bool bSuccess = std::fputs("5", ClearRefs) >= 0;
+
+    return std::fclose(ClearRefs) == 0 && bSuccess;
+}
+
+const char* GetFormatExtension(const std::filesystem::path& Path)
+{
+    const std::string Extension = Path.extension().string();
+    for (const char* FormatExtension : FormatExtensions)
+    {
+        if (Extension == FormatExtension)
+        {
+            return FormatExtension;
+        }
+    }
+
+    return nullptr;
+}
+
+void AddFile(const std::filesystem::path& Path, std::vector<FFormatStats>& Formats)
+{
+    const char* Extension = GetFormatExtension(Path);
+    if (Extension == nullptr)
+    {
+        return;
+    }
+
+    for (FFormatStats& Format : Formats)
+    {
+        if (Format.Extension == Extension)
+        {
+            Format.Files.push_back(Path.string());
+            Format.FileBytes += std::filesystem::file_size(Path);
+        }
+    }
+}
+
+double GetPercentile(const std::vector<double>& SortedValues, double Percentile)
+{
+    if (SortedValues.empty())
+    {
+        return 0.0;
+    }
+
+    const size_t Index = std::min(SortedValues.size() - 1, (size_t)(Percentile * (SortedValues.size() - 1) + 0.5));
+
+    return SortedValues[Index];
+}
+
+void PrintUsage()
+{
+    std::printf("Usage: ObjectExporterBenchmark [--iterations N] [--cold] [Path...]\n");
+    std::printf("Loads the exported files under each path (default %s) and reports latency, throughput and peak memory per format.\n", OBJECT_EXPORTER_FIXTURES_DIR);
+}
+
+} // namespace
+
+int main(int ArgCount, char** Args)
+{
+    int32 NumIterations = BENCHMARK_DEFAULT_ITERATIONS;
+    bool bCold = false;
+    std::vector<std::string> Paths;
+
+    for (int32 ArgIndex = 1; ArgIndex < ArgCount; ArgIndex++)
+    {
+        if (std::strcmp(Args[ArgIndex], "--iterations") == 0 && ArgIndex + 1 < ArgCount)
+        {
+            NumIterations = std::max(1, std::atoi(Args[++ArgIndex]));
+        }
+        else if (std::strcmp(Args[ArgIndex], "--cold") == 0)
+        {
+            bCold = true;
+        }
+        else if (Args[ArgIndex][0] == '-')
+        {
+            PrintUsage();
+
+            return 2;
+        }
+        else
+        {
+            Paths.push_back(Args[ArgIndex]);
+        }
+    }
+
+    if (Paths.empty())
+    {
+        Paths.push_back(OBJECT_EXPORTER_FIXTURES_DIR);
+    }
+
+    std::vector<FFormatStats> Formats;
+    for (const char* Extension : FormatExtensions)
+    {
+        Formats.emplace_back();
+        Formats.back().Extension = Extension;
+    }
+
+    for (const std::string& Path : Paths)
+    {
+        std::error_code Error;
+        if (std::filesystem::is_directory(Path, Error))
+        {
+            for (const std::filesystem::directory_entry& Entry : std::filesystem::recursive_directory_iterator(Path, Error))
+            {
+                if (Entry.is_regular_file())
+                {
+                    AddFile(Entry.path(), Formats);
+                }
+            }
+        }
+        else if (std::filesystem::is_regular_file(Path, Error))
+        {
+            AddFile(Path, Formats);
+        }
+        else
+        {
+            std::fprintf(stderr, "%s: no such file or directory\n", Path.c_str());
+
+            return 2;
+        }
+    }
+
+    uint64 Checksum = 0;
+    uint32 NumFiles = 0;
+    uint32 NumFailures = 0;
+
+    for (FFormatStats& Format : Formats)
+    {
+        if (Format.Files.empty())
+        {
+            continue;
+        }
+
+        std::sort(Format.Files.begin(), Format.Files.end());
+        NumFiles += (uint32)Format.Files.size();
+
+        // Failures are reported once, from the first pass
+        for (const std::string& FilePathName : Format.Files)
+        {
+            bool bContainer = false;
+            uint64 Unused = 0;
+            const EReadResult Result = LoadFile(Format.Extension, FilePathName, bContainer, Unused);
+            if (Result != EReadResult::Success)
+            {
+                std::fprintf(stderr, "%s: %s\n", FilePathName.c_str(), GetResultName(Result));
+                Format.NumFailures++;
+            }
+
+            Format.NumContainerFiles += bContainer ? 1 : 0;
+            Format.NumLegacyFiles += bContainer ? 0 : 1;
+        }
+        NumFailures += Format.NumFailures;
+
+        const bool bPeakMemory = ResetPeakMemory();
+        const int64 BaseMemoryKB = ReadProcessStatusKB("VmRSS");
+
+        for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+        {
+            for (const std::string& FilePathName : Format.Files)
+            {
+                if (bCold)
+                {
+                    DropFromPageCache(FilePathName);
+                }
+
+                bool bContainer = false;
+                const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+                const EReadResult Result = LoadFile(Format.Extension, FilePathName, bContainer, Checksum);
+                const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+                if (Result == EReadResult::Success)
+                {
+                    Format.Latencies.push_back(Seconds);
+                    Format.TotalSeconds += Seconds;
+                    Format.LoadedBytes += std::filesystem::file_size(FilePathName);
+                }
+            }
+        }
+
+        const int64 PeakMemoryKB = ReadProcessStatusKB("VmHWM");
+        if (bPeakMemory && BaseMemoryKB >= 0 && PeakMemoryKB >= 0)
+        {
+            Format.PeakMemoryKB = std::max<int64>(0, PeakMemoryKB - BaseMemoryKB);
+        }
+
+        std::sort(Format.Latencies.begin(), Format.Latencies.end());
+    }
+
+    std::printf("%d iterations, %s page cache\n\n", NumIterations, bCold ? "cold" : "warm");
+    std::printf("%-6s %-10s %6s %12s %8s %10s %10s %10s %10s %12s %10s\n",
+        "Format", "Layout", "Files", "Bytes", "Loads", "Mean us", "P50 us", "P95 us", "Max us", "MB/s", "Peak KB");
+
+    for (const FFormatStats& Format : Formats)
+    {
+        if (Format.Files.empty())
+        {
+            continue;
+        }
+
+        const char* Layout = Format.NumLegacyFiles == 0 ? "container" : (Format.NumContainerFiles == 0 ? "legacy" : "mixed");
+        const double Mean = Format.Latencies.empty() ? 0.0 : Format.TotalSeconds / Format.Latencies.size();
+        const double Throughput = Format.TotalSeconds > 0.0 ? Format.LoadedBytes / Format.TotalSeconds / (1024.0 * 1024.0) : 0.0;
+
+        char PeakMemory[32];
+        if (Format.PeakMemoryKB >= 0)
+        {
+            std::snprintf(PeakMemory, sizeof(PeakMemory), "%lld", (long long)Format.PeakMemoryKB);
+        }
+        else
+        {
+            std::snprintf(PeakMemory, sizeof(PeakMemory), "n/a");
+        }
+
+        std::printf("%-6s %-10s %6zu %12llu %8zu %10.1f %10.1f %10.1f %10.1f %12.1f %10s\n",
+            Format.Extension + 1, Layout, Format.Files.size(), (unsigned long long)Format.FileBytes, Format.Latencies.size(),
+            Mean * 1e6, GetPercentile(Format.Latencies, 0.5) * 1e6, GetPercentile(Format.Latencies, 0.95) * 1e6,
+            Format.Latencies.empty() ? 0.0 : Format.Latencies.back() * 1e6, Throughput, PeakMemory);
+    }
+
+    struct rusage Usage;
+    if (getrusage(RUSAGE_SELF, &Usage) == 0)
+    {
+        std::printf("\nProcess peak RSS %ld KB, checksum %016llx\n", Usage.ru_maxrss, (unsigned long long)Checksum);
+    }
+
+    if (NumFiles == 0)
+    {
+        std::fprintf(stderr, "No exported files found.\n");
+
+        return 1;
+    }
+
+    if (NumFailures > 0)
+    {
+        std::fprintf(stderr, "%u of %u files failed to load.\n", NumFailures, NumFiles);
+
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,783 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+
+/*
+*   Engine independent copy of Plugins/ObjectExporter/Source/ObjectExporter/Private/ObjectExporterFileFormat.h,
+*   keep both in sync when the format changes. Records and identifiers are the same as in the plugin, the engine
+*   integer types are aliased to their <cstdint> counterparts.
+*
+*   [FObjectExporterFileHeader]
+*   [FObjectExporterChunkEntry * ChunkCount]
+*   [chunk 0 payload, aligned to OBJECT_EXPORTER_CHUNK_ALIGNMENT or a larger chunk specific alignment]
+*   [chunk 1 payload, aligned to OBJECT_EXPORTER_CHUNK_ALIGNMENT or a larger chunk specific alignment]
+*   ...
+*/
+
+namespace ObjectExporterReader
+{
+    using uint8 = std::uint8_t;
+    using uint16 = std::uint16_t;
+    using uint32 = std::uint32_t;
+    using uint64 = std::uint64_t;
+    using int16 = std::int16_t;
+    using int32 = std::int32_t;
+    using int64 = std::int64_t;
+
+    constexpr int32 INDEX_NONE = -1;
+}
+
+#define OBJECT_EXPORTER_CHUNK_ALIGNMENT 16
+#define OBJECT_EXPORTER_INVALID_STRING 0xFFFFFFFFu
+
+// File alignment of streamed texture mips (TSTM), so that each one is a page aligned read
+#define OBJECT_EXPORTER_TEXTURE_STREAMING_ALIGNMENT 4096
+
+// File alignment of map cells (CDAT) and of each cell in it, so that streaming a cell in is one page aligned read
+#define OBJECT_EXPORTER_MAP_CELL_ALIGNMENT 4096
+
+// FObjectExporterTextureInfo::Flags
+#define OBJECT_EXPORTER_TEXTURE_FLAG_SRGB 0x1u
+
+namespace ObjectExporterReader
+{
+
+constexpr uint32 ObjectExporterFourCC(char A, char B, char C, char D)
+{
+    return (uint32)(uint8)A | ((uint32)(uint8)B << 8) | ((uint32)(uint8)C << 16) | ((uint32)(uint8)D << 24);
+}
+
+namespace ObjectExporterFile
+{
+    constexpr uint32 Magic = ObjectExporterFourCC('O', 'E', 'X', 'P');
+
+    /** Written in native order, a reader seeing 0x04030201 knows the file has to be byte swapped. */
+    constexpr uint32 ByteOrderMark = 0x01020304;
+
+    // File types
+    constexpr uint32 StaticMesh = ObjectExporterFourCC('S', 'T', 'M', ' ');
+    constexpr uint32 SkeletalMesh = ObjectExporterFourCC('S', 'K', 'M', ' ');
+    constexpr uint32 Skeleton = ObjectExporterFourCC('S', 'K', 'T', ' ');
+    constexpr uint32 AnimSequence = ObjectExporterFourCC('A', 'N', 'M', ' ');
+    constexpr uint32 Material = ObjectExporterFourCC('M', 'A', 'T', ' ');
+    constexpr uint32 Map = ObjectExporterFourCC('M', 'A', 'P', ' ');
+    constexpr uint32 Texture = ObjectExporterFourCC('T', 'E', 'X', ' ');
+    constexpr uint32 MapCell = ObjectExporterFourCC('M', 'A', 'P', 'C');
+}
+
+namespace ObjectExporterChunk
+{
+    constexpr uint32 Strings = ObjectExporterFourCC('S', 'T', 'R', 'S');
+    constexpr uint32 Info = ObjectExporterFourCC('I', 'N', 'F', 'O');
+
+    // Meshes
+    constexpr uint32 LODs = ObjectExporterFourCC('L', 'O', 'D', 'S');
+    constexpr uint32 Vertices = ObjectExporterFourCC('V', 'E', 'R', 'T');
+    constexpr uint32 Indices = ObjectExporterFourCC('I', 'N', 'D', 'X');
+    constexpr uint32 SkinWeights = ObjectExporterFourCC('S', 'K', 'I', 'N');
+    constexpr uint32 Sections = ObjectExporterFourCC('S', 'E', 'C', 'T');
+    constexpr uint32 BoneMap = ObjectExporterFourCC('B', 'M', 'A', 'P');
+    constexpr uint32 MeshBones = ObjectExporterFourCC('M', 'B', 'O', 'N');
+    constexpr uint32 VertexFormat = ObjectExporterFourCC('V', 'F', 'M', 'T');
+
+    // Static mesh meshlets. MVTX holds uint32 LOD vertex indices, MTRI holds 3 uint8 meshlet local indices per triangle.
+    constexpr uint32 Meshlets = ObjectExporterFourCC('M', 'S', 'H', 'L');
+    constexpr uint32 MeshletVertices = ObjectExporterFourCC('M', 'V', 'T', 'X');
+    constexpr uint32 MeshletTriangles = ObjectExporterFourCC('M', 'T', 'R', 'I');
+
+    // Meshes and maps. uint32 string offsets, one per material slot.
+    constexpr uint32 MaterialNames = ObjectExporterFourCC('M', 'T', 'L', 'N');
+
+    // Skeletons and animations. KPOS/KSCL hold float[3] per key, KROT holds float[4] (x, y, z, w) per key.
+    constexpr uint32 Bones = ObjectExporterFourCC('B', 'O', 'N', 'E');
+    constexpr uint32 Tracks = ObjectExporterFourCC('T', 'R', 'A', 'K');
+    constexpr uint32 PositionKeys = ObjectExporterFourCC('K', 'P', 'O', 'S');
+    constexpr uint32 RotationKeys = ObjectExporterFourCC('K', 'R', 'O', 'T');
+    constexpr uint32 ScaleKeys = ObjectExporterFourCC('K', 'S', 'C', 'L');
+    constexpr uint32 BoneTracks = ObjectExporterFourCC('B', 'T', 'R', 'K');
+
+    // Skeletons. BORD holds uint32 bone indices, parents first. BMAT/BINV hold one matrix per bone.
+    constexpr uint32 BoneOrder = ObjectExporterFourCC('B', 'O', 'R', 'D');
+    constexpr uint32 BindMatrices = ObjectExporterFourCC('B', 'M', 'A', 'T');
+    constexpr uint32 InverseBindMatrices = ObjectExporterFourCC('B', 'I', 'N', 'V');
+
+    // Compressed animations. KFRM holds uint16 frame indices, QPOS/QROT/QSCL hold uint16[3] per key.
+    constexpr uint32 CompressedTracks = ObjectExporterFourCC('C', 'T', 'R', 'K');
+    constexpr uint32 KeyFrames = ObjectExporterFourCC('K', 'F', 'R', 'M');
+    constexpr uint32 QuantizedPositionKeys = ObjectExporterFourCC('Q', 'P', 'O', 'S');
+    constexpr uint32 QuantizedRotationKeys = ObjectExporterFourCC('Q', 'R', 'O', 'T');
+    constexpr uint32 QuantizedScaleKeys = ObjectExporterFourCC('Q', 'S', 'C', 'L');
+
+    // Frame major animations. FKEY holds one block of floats per frame, laid out as described by FLAY.
+    constexpr uint32 FrameLayout = ObjectExporterFourCC('F', 'L', 'A', 'Y');
+    constexpr uint32 FrameTracks = ObjectExporterFourCC('F', 'T', 'R', 'K');
+    constexpr uint32 FrameKeys = ObjectExporterFourCC('F', 'K', 'E', 'Y');
+
+    // Materials. TEXR holds uint32 string offsets, one per texture slot. CBUF is the constant block described by PARM.
+    constexpr uint32 Textures = ObjectExporterFourCC('T', 'E', 'X', 'R');
+    constexpr uint32 MaterialParameters = ObjectExporterFourCC('P', 'A', 'R', 'M');
+    constexpr uint32 ConstantBlock = ObjectExporterFourCC('C', 'B', 'U', 'F');
+
+    // Textures. TDAT holds the GPU blocks of the resident mip tail, TSTM those of the streamed mips, MIPS gives their byte ranges.
+    constexpr uint32 TextureMips = ObjectExporterFourCC('M', 'I', 'P', 'S');
+    constexpr uint32 TextureData = ObjectExporterFourCC('T', 'D', 'A', 'T');
+    constexpr uint32 StreamedTextureData = ObjectExporterFourCC('T', 'S', 'T', 'M');
+
+    // Maps. ITRA/ISCL hold float[3] per instance, IROT holds float[4] (x, y, z, w) per instance.
+    constexpr uint32 Cameras = ObjectExporterFourCC('C', 'A', 'M', 'R');
+    constexpr uint32 DirectionalLights = ObjectExporterFourCC('D', 'L', 'I', 'T');
+    constexpr uint32 PointLights = ObjectExporterFourCC('P', 'L', 'I', 'T');
+    constexpr uint32 InstanceBatches = ObjectExporterFourCC('I', 'B', 'A', 'T');
+    constexpr uint32 InstanceTranslations = ObjectExporterFourCC('I', 'T', 'R', 'A');
+    constexpr uint32 InstanceRotations = ObjectExporterFourCC('I', 'R', 'O', 'T');
+    constexpr uint32 InstanceScales = ObjectExporterFourCC('I', 'S', 'C', 'L');
+    constexpr uint32 SkeletalMeshActors = ObjectExporterFourCC('S', 'K', 'A', 'C');
+
+    // Map materials and the textures they sample, for texture streaming.
+    constexpr uint32 MapMaterials = ObjectExporterFourCC('M', 'M', 'A', 'T');
+    constexpr uint32 MaterialTextures = ObjectExporterFourCC('M', 'T', 'E', 'X');
+
+    // Map spatial index. IBND/SBND/PBND are world bounds parallel to ITRA, SKAC and PLIT.
+    constexpr uint32 InstanceBounds = ObjectExporterFourCC('I', 'B', 'N', 'D');
+    constexpr uint32 SkeletalMeshActorBounds = ObjectExporterFourCC('S', 'B', 'N', 'D');
+    constexpr uint32 PointLightBounds = ObjectExporterFourCC('P', 'B', 'N', 'D');
+    constexpr uint32 BVHNodes = ObjectExporterFourCC('B', 'V', 'H', 'N');
+    constexpr uint32 BVHPrimitives = ObjectExporterFourCC('B', 'V', 'H', 'P');
+
+    // Partitioned maps. The map holds the grid, the cell index and the cells, each cell is a MapCell file of its own
+    // with the PLIT ... BVHP chunks above for the records in the cell and the assets they need.
+    constexpr uint32 MapGrid = ObjectExporterFourCC('G', 'R', 'I', 'D');
+    constexpr uint32 MapCells = ObjectExporterFourCC('C', 'E', 'L', 'L');
+    constexpr uint32 MapCellData = ObjectExporterFourCC('C', 'D', 'A', 'T');
+    constexpr uint32 AssetDependencies = ObjectExporterFourCC('D', 'E', 'P', 'S');
+}
+
+enum class EObjectExporterFileVersion : uint16
+{
+    // Chunked container with a chunk directory.
+    Initial = 1,
+
+    // Static mesh placements grouped into instance batches with SoA transforms.
+    InstanceBatches,
+
+    // World bounds for every placed mesh and point light, plus a 4-wide BVH over them.
+    SpatialIndex,
+
+    // Every mesh LOD is exported, LODS carries the screen size each LOD is selected at.
+    AllLODs,
+
+    // Per LOD section draw ranges and bone maps, material names per slot in meshes and maps.
+    MeshSections,
+
+    // INDX holds 16 or 32 bit indices, mesh INFO records which.
+    IndexSize,
+
+    // VERT/SKIN layout described by VFMT, optionally quantized.
+    VertexFormat,
+
+    // Optional static mesh meshlets with bounds and normal cones.
+    Meshlets,
+
+    // Optional generated LOD chain, LODS records the geometric error of each LOD.
+    GeneratedLODs,
+
+    // Anim sequence INFO records the encoding, optional key reduced and quantized tracks.
+    AnimCompression,
+
+    // Optional frame major anim sequence layout with SIMD lanes.
+    AnimFrameMajor,
+
+    // Anim sequences carry a dense per skeleton bone track table with bind pose fallbacks.
+    AnimBoneTracks,
+
+    // Skeleton bind matrices, compact per section bone palettes and mesh bone inverse binds.
+    SkinningPalettes,
+
+    // Textures exported as cooked platform blocks with their full mip chain.
+    Textures,
+
+    // Textures split into a resident mip tail and page aligned streamed mips, maps list the textures of each material.
+    MipStreaming,
+
+    // Material parameter table over a std140 constant block and texture slots, replaces the bare scalars.
+    MaterialParameters,
+
+    // Optional partition of maps into a grid of cells embedded in the map, cells list the assets they depend on.
+    MapCells,
+
+    // -----<new versions can be added above this line>-------------------------------------------------
+    VersionPlusOne,
+    Latest = VersionPlusOne - 1
+};
+
+struct FObjectExporterFileHeader
+{
+    uint32 Magic;
+    uint16 Version;
+    uint16 HeaderSize;
+    uint32 FileType;
+    uint32 ByteOrderMark;
+    uint32 ChunkCount;
+    uint32 ChunkTableOffset;
+    uint64 FileSize;
+};
+static_assert(sizeof(FObjectExporterFileHeader) == 32, "FObjectExporterFileHeader layout changed");
+
+struct FObjectExporterChunkEntry
+{
+    uint32 ChunkId;
+    uint32 Flags;
+    uint32 ElementCount;
+    uint32 ElementStride;
+    uint64 Offset;
+    uint64 Size;
+};
+static_assert(sizeof(FObjectExporterChunkEntry) == 32, "FObjectExporterChunkEntry layout changed");
+
+// Chunk payload records. Plain floats only so that the layout does not depend on engine math type alignment.
+
+/**
+*   LODS: one entry per exported LOD, ranges into VERT/SKIN and INDX, ordered from the most detailed.
+*   LOD i is drawn while the projected bounds sphere covers at least ScreenSize (fraction of the screen
+*   height, as in the engine), the last LOD below that.
+*   GeometricError is the simplification error against LOD 0 in world units for generated LODs, 0 for authored ones.
+*/
+struct FObjectExporterMeshLOD
+{
+    uint32 FirstVertex;
+    uint32 NumVertices;
+    uint32 FirstIndex;
+    uint32 NumIndices;
+    float ScreenSize;
+    uint32 FirstSection;
+    uint32 NumSections;
+    float GeometricError;
+};
+
+/**
+*   SECT: one ranged draw sharing the vertex and index buffers of its LOD.
+*   FirstIndex is absolute in INDX, the vertex range is relative to the LOD's FirstVertex.
+*   MaterialIndex is the mesh material slot (MTLN). FirstBone/NumBones is the range into BMAP mapping
+*   the section's palette to mesh bones (MBON), empty for static meshes. The palette holds exactly the bones
+*   weighted by the section's vertices, in ascending order, and SKIN bone indices index into it.
+*/
+struct FObjectExporterMeshSection
+{
+    uint32 FirstIndex;
+    uint32 NumIndices;
+    uint32 MinVertexIndex;
+    uint32 MaxVertexIndex;
+    uint32 MaterialIndex;
+    uint32 FirstBone;
+    uint32 NumBones;
+};
+
+/** In memory vertex of the exporter. VERT holds these unless VFMT describes a quantized layout. */
+struct FObjectExporterMeshVertex
+{
+    float Position[3];
+    float Normal[3];
+    float UV[2];
+};
+static_assert(sizeof(FObjectExporterMeshVertex) == 32, "FObjectExporterMeshVertex layout changed");
+
+/**
+*   Skin weights, parallel to the vertices. While a mesh is processed the bone indices are mesh bones (resolved through
+*   the engine section bone map), they are palette indices of the vertex's section once the palettes are built.
+*/
+struct FObjectExporterSkinWeight
+{
+    uint16 BoneIndices[4];
+    float BoneWeights[4];
+};
+static_assert(sizeof(FObjectExporterSkinWeight) == 24, "FObjectExporterSkinWeight layout changed");
+
+/**
+*   MSHL: a cluster of at most 64 vertices and 124 triangles of one section, meshlets are ordered by section.
+*   Its triangles are MTRI[FirstTriangle, FirstTriangle + NumTriangles), their local indices point into
+*   MVTX[FirstVertex, FirstVertex + NumVertices).
+*   The cluster is backfacing and can be skipped when dot(normalize(ConeApex - CameraPosition), ConeAxis) >= ConeCutoff,
+*   ConeCutoff is 1 when the triangles face too many directions for the test.
+*/
+struct FObjectExporterMeshlet
+{
+    uint32 FirstVertex;
+    uint32 FirstTriangle;
+    uint32 NumVertices;
+    uint32 NumTriangles;
+    float Center[3];
+    float Radius;
+    float ConeApex[3];
+    float ConeCutoff;
+    float ConeAxis[3];
+    uint32 SectionIndex;
+};
+static_assert(sizeof(FObjectExporterMeshlet) == 64, "FObjectExporterMeshlet layout changed");
+
+enum class EObjectExporterVertexSemantic : uint32
+{
+    Position,
+    Normal,
+    TexCoord0,
+    BoneIndices,
+    BoneWeights,
+};
+
+enum class EObjectExporterVertexElementFormat : uint32
+{
+    Float2,
+    Float3,
+    Float4,
+    Half2,
+    Half4,
+    // 4 x uint16 normalized to [0, 1]
+    UNorm16x4,
+    // Octahedral unit vector, 2 x int16 normalized to [-1, 1]
+    OctahedralSNorm16x2,
+    UInt8x4,
+    UInt16x4,
+    // 4 x uint8 normalized to [0, 1]
+    UNorm8x4,
+};
+
+/**
+*   VFMT: one entry per vertex attribute. Stream 0 is VERT, stream 1 is SKIN, the element stride of the chunk is the
+*   vertex size of the stream. After normalization (UNorm/SNorm) a component decodes as Value * Scale + Bias,
+*   Scale and Bias are 1 and 0 for attributes that are not range-quantized.
+*/
+struct FObjectExporterVertexAttribute
+{
+    uint32 Semantic;
+    uint32 Format;
+    uint32 Stream;
+    uint32 Offset;
+    float Scale[3];
+    float Bias[3];
+};
+static_assert(sizeof(FObjectExporterVertexAttribute) == 40, "FObjectExporterVertexAttribute layout changed");
+
+/** INFO of a static mesh. IndexSize is 2 or 4 bytes, the exporter picks 2 whenever every index fits. */
+struct FObjectExporterStaticMeshInfo
+{
+    uint32 IndexSize;
+};
+
+/** INFO of a skeletal mesh. */
+struct FObjectExporterSkeletalMeshInfo
+{
+    uint32 SkeletonName;
+    uint32 IndexSize;
+};
+
+/** 4x4 matrix in FMatrix layout: row major, row vectors, translation in the last row. */
+struct FObjectExporterMatrix
+{
+    float M[4][4];
+};
+static_assert(sizeof(FObjectExporterMatrix) == 64, "FObjectExporterMatrix layout changed");
+
+/**
+*   MBON: bones of a skeletal mesh, in mesh order. SkeletonBoneIndex is the bone of the same name in the skeleton (BONE),
+*   INDEX_NONE if missing. InverseBindMatrix is the inverse of the component space reference pose of the mesh, so a
+*   palette entry is InverseBindMatrix * component space pose of the bone.
+*/
+struct FObjectExporterMeshBone
+{
+    uint32 Name;
+    int32 ParentIndex;
+    int32 SkeletonBoneIndex;
+    uint32 Padding;
+    FObjectExporterMatrix InverseBindMatrix;
+};
+static_assert(sizeof(FObjectExporterMeshBone) == 80, "FObjectExporterMeshBone layout changed");
+
+/** BONE: reference pose in parent space. */
+struct FObjectExporterBone
+{
+    uint32 Name;
+    int32 ParentIndex;
+    float Rotation[4];
+    float Translation[3];
+    float Scale[3];
+};
+static_assert(sizeof(FObjectExporterBone) == 48, "FObjectExporterBone layout changed");
+
+enum class EObjectExporterAnimEncoding : uint32
+{
+    // TRAK with full float keys in KPOS/KROT/KSCL
+    Raw,
+    // CTRK with key reduced, quantized keys in KFRM/QPOS/QROT/QSCL
+    Compressed,
+    // FLAY/FTRK with every animated channel of a frame contiguous in FKEY
+    FrameMajor,
+};
+
+/** INFO of an anim sequence. */
+struct FObjectExporterAnimSequenceInfo
+{
+    int32 NumFrames;
+    float SequenceLength;
+    EObjectExporterAnimEncoding Encoding;
+    uint32 SkeletonName;
+    uint32 NumTracks;
+    uint32 NumBones;
+};
+
+/**
+*   BTRK: one entry per skeleton bone, in skeleton order, whatever the encoding. TrackIndex is the track animating the
+*   bone, INDEX_NONE for bones that stay in the bind pose. Every entry holds the bind pose of the bone (parent space), so
+*   a pose is the bind pose copied as a whole with the sampled tracks written over it, without per bone tests.
+*   RetargetMode is the skeleton's EBoneTranslationRetargetingMode of the bone.
+*/
+struct FObjectExporterAnimBoneTrack
+{
+    int32 TrackIndex;
+    float Rotation[4];
+    float Translation[3];
+    float Scale[3];
+    uint32 RetargetMode;
+};
+static_assert(sizeof(FObjectExporterAnimBoneTrack) == 48, "FObjectExporterAnimBoneTrack layout changed");
+
+/** TRAK: ranges into KPOS/KROT/KSCL. */
+struct FObjectExporterAnimTrack
+{
+    int32 BoneIndex;
+    uint32 FirstPositionKey;
+    uint32 NumPositionKeys;
+    uint32 FirstRotationKey;
+    uint32 NumRotationKeys;
+    uint32 FirstScaleKey;
+    uint32 NumScaleKeys;
+};
+
+enum class EObjectExporterAnimChannelFormat : uint32
+{
+    // Zero translation, identity rotation or unit scale, no data
+    Identity,
+    // One full precision value in Params: x, y, z for translation and scale, x, y, z, w for rotation
+    Constant,
+    // NumKeys keys at the frames KFRM[FirstFrame...], values in QPOS/QROT/QSCL[FirstKey...]
+    Animated,
+};
+
+/**
+*   One channel of a compressed track. Animated channels are sampled by linear interpolation (nlerp for rotations)
+*   between the two keys around the frame, the first and last frame always have a key.
+*   Rotation keys are smallest three: the three smallest components in 15 bits over [-1/sqrt(2), 1/sqrt(2)], the index
+*   of the dropped largest (positive) component in the top bits of the first two. Translation and scale keys are 16 bit
+*   normalized over the range Params[0..2] (min) to Params[0..2] + Params[3..5] (extent).
+*/
+struct FObjectExporterAnimChannel
+{
+    EObjectExporterAnimChannelFormat Format;
+    uint32 NumKeys;
+    uint32 FirstKey;
+    uint32 FirstFrame;
+    float Params[6];
+};
+static_assert(sizeof(FObjectExporterAnimChannel) == 40, "FObjectExporterAnimChannel layout changed");
+
+/** CTRK: compressed counterpart of TRAK. */
+struct FObjectExporterCompressedAnimTrack
+{
+    int32 BoneIndex;
+    FObjectExporterAnimChannel Position;
+    FObjectExporterAnimChannel Rotation;
+    FObjectExporterAnimChannel Scale;
+    uint32 Padding;
+};
+static_assert(sizeof(FObjectExporterCompressedAnimTrack) == 128, "FObjectExporterCompressedAnimTrack layout changed");
+
+/**
+*   FLAY: lane counts of the FKEY frame blocks, each a multiple of 4. A block is FrameStride floats:
+*   rotation x, y, z, w lanes, then translation x, y, z lanes, then scale x, y, z lanes, each component a run of its
+*   lane count. Rotations have the sign of the previous frame so that nlerp needs no shortest path test, unused lanes
+*   hold identity values.
+*/
+struct FObjectExporterAnimFrameLayout
+{
+    uint32 NumRotationLanes;
+    uint32 NumTranslationLanes;
+    uint32 NumScaleLanes;
+    uint32 FrameStride;
+};
+
+/** FTRK: lane of each animated channel of a track, INDEX_NONE for constant channels whose value is stored here. */
+struct FObjectExporterAnimFrameTrack
+{
+    int32 BoneIndex;
+    int32 RotationLane;
+    int32 TranslationLane;
+    int32 ScaleLane;
+    float Rotation[4];
+    float Translation[3];
+    float Scale[3];
+    uint32 Padding[2];
+};
+static_assert(sizeof(FObjectExporterAnimFrameTrack) == 64, "FObjectExporterAnimFrameTrack layout changed");
+
+/**
+*   INFO of a material. SortKey orders draws without string compares: the blend mode in the top 4 bits, so opaque draws
+*   come first, then 28 bits of the name hash of the base material, so draws sharing shaders end up next to each other.
+*/
+struct FObjectExporterMaterialInfo
+{
+    int32 BlendMode;
+    uint32 SortKey;
+    uint32 BaseMaterialName;
+    uint32 ConstantBlockSize;
+};
+
+enum class EObjectExporterMaterialParameterType : uint32
+{
+    // float at Offset in CBUF
+    Scalar,
+    // float[4] (r, g, b, a) at Offset in CBUF, 16 byte aligned
+    Vector,
+    // TEXR[TextureSlot]
+    Texture,
+};
+
+/**
+*   PARM: one entry per parameter, sorted by NameHash (ObjectExporterFile::HashName of the parameter name) for binary
+*   search. CBUF follows std140 rules: vectors first, each in its own 16 byte slot, then scalars packed 4 bytes apart,
+*   the block padded to a multiple of 16 bytes, so it is uploaded to a uniform buffer as is.
+*   Offset is INDEX_NONE for textures, TextureSlot is INDEX_NONE for scalars and vectors.
+*/
+struct FObjectExporterMaterialParameter
+{
+    uint32 NameHash;
+    uint32 Name;
+    EObjectExporterMaterialParameterType Type;
+    int32 Offset;
+    int32 TextureSlot;
+};
+
+enum class EObjectExporterTextureFormat : uint32
+{
+    Unknown,
+    RGBA8,
+    BGRA8,
+    R8,
+    RGBA16F,
+    BC1,
+    BC3,
+    BC4,
+    BC5,
+    BC6H,
+    BC7,
+    ETC2_RGB,
+    ETC2_RGBA,
+    ASTC_4x4,
+    ASTC_6x6,
+    ASTC_8x8,
+    ASTC_10x10,
+    ASTC_12x12,
+};
+
+/**
+*   INFO of a texture. Mip data is in the block layout the GPU samples: rows of BlockSizeX x BlockSizeY blocks of
+*   BytesPerBlock bytes, no row padding, uncompressed formats have 1x1 blocks.
+*/
+struct FObjectExporterTextureInfo
+{
+    EObjectExporterTextureFormat Format;
+    uint32 Width;
+    uint32 Height;
+    uint32 NumMips;
+    uint32 BlockSizeX;
+    uint32 BlockSizeY;
+    uint32 BytesPerBlock;
+    uint32 Flags;
+
+    /** Mips [FirstResidentMip, NumMips) are the resident tail in TDAT, the larger ones are streamed from TSTM. */
+    uint32 FirstResidentMip;
+};
+
+/**
+*   MIPS: one entry per mip, largest first. DataOffset is into TDAT for the resident tail, aligned to
+*   OBJECT_EXPORTER_CHUNK_ALIGNMENT, and into TSTM for streamed mips, aligned to OBJECT_EXPORTER_TEXTURE_STREAMING_ALIGNMENT.
+*   TSTM itself starts at a file offset aligned to OBJECT_EXPORTER_TEXTURE_STREAMING_ALIGNMENT and is left out when empty.
+*/
+struct FObjectExporterTextureMip
+{
+    uint32 Width;
+    uint32 Height;
+    uint32 DataOffset;
+    uint32 DataSize;
+};
+
+/** CAMR */
+struct FObjectExporterCamera
+{
+    float Location[3];
+    float Target[3];
+    float FOV;
+    float AspectRatio;
+};
+
+/** DLIT */
+struct FObjectExporterDirectionalLight
+{
+    float Color[4];
+    float Direction[3];
+    float Intensity;
+};
+
+/** PLIT */
+struct FObjectExporterPointLight
+{
+    float Color[4];
+    float Location[3];
+    float Intensity;
+    float AttenuationRadius;
+    float LightFalloffExponent;
+};
+
+/** IBAT: a mesh with its material per slot (range into MTLN) and its range into ITRA/IROT/ISCL. */
+struct FObjectExporterInstanceBatch
+{
+    uint32 ResourceName;
+    uint32 FirstMaterial;
+    uint32 NumMaterials;
+    uint32 FirstInstance;
+    uint32 NumInstances;
+};
+
+/** SKAC: materials per slot are a range into MTLN. An empty AnimationName string keeps the reference pose. */
+struct FObjectExporterSkeletalMeshActor
+{
+    float Rotation[4];
+    float Location[3];
+    uint32 ResourceName;
+    uint32 AnimationName;
+    uint32 FirstMaterial;
+    uint32 NumMaterials;
+};
+
+/** MMAT: a material used by the map (by name, as in MTLN) and its range into MTEX. */
+struct FObjectExporterMapMaterial
+{
+    uint32 Name;
+    uint32 FirstTexture;
+    uint32 NumTextures;
+};
+
+/**
+*   MTEX: a texture sampled by a material. SamplingScale and UVChannel come from the material's texture streaming data:
+*   the material samples the texture with the mesh UVs of that channel scaled by SamplingScale, so the runtime derives the
+*   mip a primitive needs from its screen size and UV density and streams larger mips on demand. 1 and 0 when the material
+*   has no built streaming data for the texture.
+*/
+struct FObjectExporterMaterialTexture
+{
+    uint32 Name;
+    float SamplingScale;
+    int32 UVChannel;
+    uint32 Padding;
+};
+
+/** IBND/SBND/PBND: world space box and sphere, same convention as FBoxSphereBounds. */
+struct FObjectExporterBounds
+{
+    float Origin[3];
+    float SphereRadius;
+    float BoxExtent[3];
+    float Padding;
+};
+static_assert(sizeof(FObjectExporterBounds) == 32, "FObjectExporterBounds layout changed");
+
+enum class EObjectExporterPrimitiveType : uint32
+{
+    Instance,
+    SkeletalMeshActor,
+    PointLight,
+};
+
+/** BVHP: leaves of the BVH reference ranges of these. Index is into ITRA, SKAC or PLIT depending on Type. */
+struct FObjectExporterBVHPrimitive
+{
+    uint32 Type;
+    uint32 Index;
+};
+
+/**
+*   BVHN: 4-wide BVH node, node 0 is the root. Child bounds are stored as SoA lanes so that one node is
+*   tested against a frustum plane with a handful of 4-wide SIMD operations.
+*   Counts[i] == 0: Children[i] is a node index, or INDEX_NONE for an empty slot with inverted bounds.
+*   Counts[i] > 0: child i is a leaf covering BVHP[Children[i], Children[i] + Counts[i]).
+*/
+struct FObjectExporterBVHNode
+{
+    float MinX[4];
+    float MinY[4];
+    float MinZ[4];
+    float MaxX[4];
+    float MaxY[4];
+    float MaxZ[4];
+    int32 Children[4];
+    uint32 Counts[4];
+};
+static_assert(sizeof(FObjectExporterBVHNode) == 128, "FObjectExporterBVHNode layout changed");
+
+/**
+*   GRID: the grid a partitioned map is split into on the world XY plane. Cell (X, Y) is the square
+*   [X * CellSize, (X + 1) * CellSize) x [Y * CellSize, (Y + 1) * CellSize), cells with records are within
+*   [MinCellX, MinCellX + NumCellsX) x [MinCellY, MinCellY + NumCellsY).
+*/
+struct FObjectExporterMapGrid
+{
+    float CellSize;
+    int32 MinCellX;
+    int32 MinCellY;
+    uint32 NumCellsX;
+    uint32 NumCellsY;
+};
+
+/**
+*   CELL: a grid cell holding at least one record, sorted by CellY then CellX. A record belongs to the cell its bounds
+*   origin falls in, Bounds encloses the bounds of every record of the cell and so can reach into neighbour cells.
+*   The cell is the MapCell file at [DataOffset, DataOffset + DataSize) of CDAT, DataOffset is aligned to
+*   OBJECT_EXPORTER_MAP_CELL_ALIGNMENT. NumPrimitives counts its instances, skeletal mesh actors and point lights.
+*/
+struct FObjectExporterMapCell
+{
+    int32 CellX;
+    int32 CellY;
+    uint32 NumPrimitives;
+    uint32 Padding;
+    uint64 DataOffset;
+    uint64 DataSize;
+    FObjectExporterBounds Bounds;
+};
+static_assert(sizeof(FObjectExporterMapCell) == 64, "FObjectExporterMapCell layout changed");
+
+/**
+*   DEPS: an asset a map cell needs loaded before its records are drawn, by file type (ObjectExporterFile::StaticMesh,
+*   SkeletalMesh, Skeleton, AnimSequence, Material or Texture) and name. Sorted by file type, unique.
+*/
+struct FObjectExporterAssetDependency
+{
+    uint32 FileType;
+    uint32 Name;
+};
+
+namespace ObjectExporterFile
+{
+    /** 32 bit FNV-1a of the UTF-8 name, case sensitive. */
+    inline uint32 HashName(const char* Name)
+    {
+        uint32 Hash = 2166136261u;
+        for (const char* Char = Name; *Char != 0; Char++)
+        {
+            Hash = (Hash ^ (uint8)*Char) * 16777619u;
+        }
+
+        return Hash;
+    }
+}
+
+} // namespace ObjectExporterReader
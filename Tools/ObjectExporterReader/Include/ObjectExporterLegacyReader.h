@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ObjectExporterReader.h"
+
+#include <vector>
+
+/*
+*   Reader of the headerless files written before the chunked container (EObjectExporterFileVersion::Initial), such as
+*   the fixtures under Saved/Bin. Those are plain FArchive << sequences of the first LOD: little endian values,
+*   TArray as an int32 count followed by the elements, FString as an int32 length followed by the characters with
+*   their terminator (ANSI for a positive length, UTF-16 for a negative one).
+*
+*   Runs of fixed size records are still viewed in place, per entry data holding strings is collected into vectors.
+*   The file type is not stored and comes from the extension.
+*/
+
+namespace ObjectExporterReader
+{
+
+/** FString of a legacy file, pointing into the file. Length excludes the terminator. */
+struct FLegacyString
+{
+    const void* Data;
+    uint32 Length;
+    bool bWide;
+
+    FLegacyString()
+        : Data(nullptr)
+        , Length(0)
+        , bWide(false)
+    {
+
+    }
+};
+
+/** Static mesh vertices are FObjectExporterMeshVertex already. */
+struct FLegacyStaticMesh
+{
+    TView<FObjectExporterMeshVertex> Vertices;
+    TView<uint16> Indices;
+};
+
+/** Bone indices are skeleton bones. */
+struct FLegacySkinnedVertex
+{
+    float Position[3];
+    float Normal[3];
+    float UV[2];
+    uint16 BoneIndices[4];
+    float BoneWeights[4];
+};
+static_assert(sizeof(FLegacySkinnedVertex) == 56, "FLegacySkinnedVertex layout changed");
+
+struct FLegacySkeletalMesh
+{
+    TView<FLegacySkinnedVertex> Vertices;
+    TView<uint16> Indices;
+    FLegacyString SkeletonName;
+};
+
+struct FLegacyBonePose
+{
+    float Rotation[4];
+    float Translation[3];
+    float Scale[3];
+};
+static_assert(sizeof(FLegacyBonePose) == 40, "FLegacyBonePose layout changed");
+
+/** Bone names were FNames, which a file archive does not write. */
+struct FLegacySkeleton
+{
+    TView<int32> ParentIndices;
+    TView<FLegacyBonePose> RefPose;
+};
+
+struct FLegacyAnimTrack
+{
+    int32 BoneIndex;
+    TView<FFloat3> PositionKeys;
+    TView<FFloat4> RotationKeys;
+    TView<FFloat3> ScaleKeys;
+};
+
+struct FLegacyAnimSequence
+{
+    int32 NumFrames;
+    float SequenceLength;
+    std::vector<FLegacyAnimTrack> Tracks;
+};
+
+/** Texture names and scalar values without their parameter names. */
+struct FLegacyMaterial
+{
+    int32 BlendMode;
+    std::vector<FLegacyString> TextureNames;
+    std::vector<float> Scalars;
+};
+
+struct FLegacyMapActor
+{
+    float Rotation[4];
+    float Location[3];
+    FLegacyString ResourceName;
+
+    /** Skeletal mesh actors only. */
+    FLegacyString AnimationName;
+
+    FLegacyString MaterialName;
+};
+
+/** Cameras and lights are laid out as the CAMR, DLIT and PLIT records. */
+struct FLegacyMap
+{
+    TView<FObjectExporterCamera> Cameras;
+    TView<FObjectExporterDirectionalLight> DirectionalLights;
+    TView<FObjectExporterPointLight> PointLights;
+    std::vector<FLegacyMapActor> StaticMeshActors;
+    std::vector<FLegacyMapActor> SkeletalMeshActors;
+};
+
+/** Every function checks that the whole file is consumed, Data has to be 4 byte aligned. */
+EReadResult ReadLegacyStaticMesh(const uint8* Data, uint64 Size, FLegacyStaticMesh& OutStaticMesh);
+EReadResult ReadLegacySkeletalMesh(const uint8* Data, uint64 Size, FLegacySkeletalMesh& OutSkeletalMesh);
+EReadResult ReadLegacySkeleton(const uint8* Data, uint64 Size, FLegacySkeleton& OutSkeleton);
+EReadResult ReadLegacyAnimSequence(const uint8* Data, uint64 Size, FLegacyAnimSequence& OutAnimSequence);
+EReadResult ReadLegacyMaterial(const uint8* Data, uint64 Size, FLegacyMaterial& OutMaterial);
+EReadResult ReadLegacyMap(const uint8* Data, uint64 Size, FLegacyMap& OutMap);
+
+} // namespace ObjectExporterReader
@@ -0,0 +1,468 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ObjectExporterFormat.h"
+
+/*
+*   Engine independent reader of the ObjectExporter binary files.
+*
+*   Files are mapped read only and every view points straight into the mapping, nothing is copied or decoded.
+*   Open validates everything a view exposes: chunk bounds and alignment, element counts, ranges between chunks,
+*   string offsets and bone hierarchies, so a caller can index the views without further checks.
+*   Index buffers are the exception, scanning them costs as much as reading them, see FMeshView::ValidateIndices.
+*   The same goes for the meshlet cones, see FStaticMeshView::ValidateMeshletCones.
+*
+*   FMappedFile File;
+*   FContainer Container;
+*   FStaticMeshView StaticMesh;
+*   if (File.Open(Path) && Container.Open(File.GetData(), File.GetSize()) == EReadResult::Success
+*       && StaticMesh.Open(Container) == EReadResult::Success)
+*   {
+*       ...
+*   }
+*
+*   Views stay valid as long as the FMappedFile is open.
+*/
+
+namespace ObjectExporterReader
+{
+
+enum class EReadResult : uint32
+{
+    Success,
+    OpenFailed,
+    // The file is shorter than its header, chunk table or declared size
+    Truncated,
+    BadMagic,
+    // Written on a machine of the other byte order
+    ByteSwapped,
+    UnsupportedVersion,
+    WrongFileType,
+    BadHeader,
+    // A chunk is out of the file, misaligned or its size does not match its element count
+    BadChunk,
+    MissingChunk,
+    // A range or index points outside of the chunk it refers to
+    BadReference,
+    BadString,
+    BadHierarchy,
+    // Legacy files: the data does not follow the layout of the file type
+    BadLayout,
+    UnknownFileType,
+};
+
+const char* GetResultName(EReadResult Result);
+
+/** Read only view of Num consecutive T. */
+template <typename T>
+class TView
+{
+public:
+    TView()
+        : Data(nullptr)
+        , Num(0)
+    {
+
+    }
+
+    TView(const T* InData, uint32 InNum)
+        : Data(InData)
+        , Num(InNum)
+    {
+
+    }
+
+    const T* GetData() const
+    {
+        return Data;
+    }
+
+    uint32 GetNum() const
+    {
+        return Num;
+    }
+
+    bool IsEmpty() const
+    {
+        return Num == 0;
+    }
+
+    bool IsValidIndex(uint64 Index) const
+    {
+        return Index < Num;
+    }
+
+    /** True if [First, First + Count) is inside the view. */
+    bool IsValidRange(uint64 First, uint64 Count) const
+    {
+        return First <= Num && Count <= Num - First;
+    }
+
+    const T& operator[](uint32 Index) const
+    {
+        return Data[Index];
+    }
+
+    const T* begin() const
+    {
+        return Data;
+    }
+
+    const T* end() const
+    {
+        return Data + Num;
+    }
+
+private:
+    const T* Data;
+    uint32 Num;
+};
+
+/** Key and instance vectors of KPOS/KSCL/ITRA/ISCL and KROT/IROT. */
+struct FFloat3
+{
+    float V[3];
+};
+
+struct FFloat4
+{
+    float V[4];
+};
+
+/** QPOS/QROT/QSCL key. */
+struct FUInt16x3
+{
+    uint16 V[3];
+};
+
+/** MTRI triangle. */
+struct FUInt8x3
+{
+    uint8 V[3];
+};
+
+/** Read only, private mapping of a whole file. */
+class FMappedFile
+{
+public:
+    FMappedFile();
+    ~FMappedFile();
+
+    FMappedFile(const FMappedFile&) = delete;
+    FMappedFile& operator=(const FMappedFile&) = delete;
+
+    bool Open(const char* FilePathName);
+    void Close();
+
+    const uint8* GetData() const
+    {
+        return Data;
+    }
+
+    uint64 GetSize() const
+    {
+        return Size;
+    }
+
+private:
+    const uint8* Data;
+    uint64 Size;
+};
+
+/** Validated header and chunk table of a file in memory. */
+class FContainer
+{
+public:
+    FContainer();
+
+    /** Data has to stay valid and be aligned to OBJECT_EXPORTER_CHUNK_ALIGNMENT, as a mapping is. */
+    EReadResult Open(const void* InData, uint64 InSize);
+
+    uint32 GetFileType() const
+    {
+        return Header != nullptr ? Header->FileType : 0;
+    }
+
+    uint16 GetVersion() const
+    {
+        return Header != nullptr ? Header->Version : 0;
+    }
+
+    const TView<FObjectExporterChunkEntry>& GetChunks() const
+    {
+        return Chunks;
+    }
+
+    /** nullptr if the file has no such chunk. */
+    const FObjectExporterChunkEntry* FindChunk(uint32 ChunkId) const;
+
+    /** Payload of the chunk, empty if the file has no such chunk. */
+    TView<uint8> GetChunkBytes(uint32 ChunkId) const;
+
+    /**
+    *   The payload of the chunk as T, empty if the file has no such chunk.
+    *   Returns false if the payload is not a whole number of T.
+    */
+    template <typename T>
+    bool GetChunk(uint32 ChunkId, TView<T>& OutView) const
+    {
+        static_assert(alignof(T) <= OBJECT_EXPORTER_CHUNK_ALIGNMENT, "Chunk payloads are only aligned to OBJECT_EXPORTER_CHUNK_ALIGNMENT");
+
+        const TView<uint8> Bytes = GetChunkBytes(ChunkId);
+        if (Bytes.GetNum() % sizeof(T) != 0)
+        {
+            return false;
+        }
+
+        OutView = TView<T>(reinterpret_cast<const T*>(Bytes.GetData()), Bytes.GetNum() / (uint32)sizeof(T));
+
+        return true;
+    }
+
+    /** The single element of a chunk such as INFO, nullptr if the chunk is missing or does not hold exactly one T. */
+    template <typename T>
+    const T* GetSingleElementChunk(uint32 ChunkId) const
+    {
+        TView<T> View;
+        return GetChunk(ChunkId, View) && View.GetNum() == 1 ? View.GetData() : nullptr;
+    }
+
+    bool IsValidString(uint32 Offset) const
+    {
+        return Offset < Strings.GetNum();
+    }
+
+    /** True for valid offsets and OBJECT_EXPORTER_INVALID_STRING, which marks unnamed entries. */
+    bool IsValidOptionalString(uint32 Offset) const
+    {
+        return Offset == OBJECT_EXPORTER_INVALID_STRING || IsValidString(Offset);
+    }
+
+    /** Null terminated UTF-8, "" for invalid offsets. */
+    const char* GetString(uint32 Offset) const
+    {
+        return IsValidString(Offset) ? Strings.GetData() + Offset : "";
+    }
+
+private:
+    const uint8* Data;
+    uint64 Size;
+    const FObjectExporterFileHeader* Header;
+    TView<FObjectExporterChunkEntry> Chunks;
+    TView<char> Strings;
+};
+
+/** LODs, sections and buffers shared by static and skeletal meshes. */
+class FMeshView
+{
+public:
+    TView<FObjectExporterMeshLOD> LODs;
+    TView<FObjectExporterMeshSection> Sections;
+    TView<uint32> MaterialNames;
+
+    /** VFMT: the attributes of VERT and SKIN. */
+    TView<FObjectExporterVertexAttribute> VertexFormat;
+
+    /** VERT: NumVertices vertices of VertexStride bytes. */
+    TView<uint8> Vertices;
+    uint32 VertexStride;
+    uint32 NumVertices;
+
+    /** INDX: NumIndices indices of IndexSize (2 or 4) bytes, relative to the FirstVertex of their LOD. */
+    TView<uint8> Indices;
+    uint32 IndexSize;
+    uint32 NumIndices;
+
+    FMeshView();
+
+    uint32 GetIndex(uint32 Index) const
+    {
+        return IndexSize == sizeof(uint16) ? reinterpret_cast<const uint16*>(Indices.GetData())[Index] : reinterpret_cast<const uint32*>(Indices.GetData())[Index];
+    }
+
+    /** Checks that every index of every LOD points into the vertices of its LOD. Reads the whole index buffer. */
+    bool ValidateIndices() const;
+
+protected:
+    EReadResult OpenMesh(const FContainer& Container, uint32 InIndexSize);
+};
+
+class FStaticMeshView : public FMeshView
+{
+public:
+    const FObjectExporterStaticMeshInfo* Info;
+
+    /** Optional meshlets: MVTX holds LOD vertex indices, MTRI meshlet local indices. */
+    TView<FObjectExporterMeshlet> Meshlets;
+    TView<uint32> MeshletVertices;
+    TView<FUInt8x3> MeshletTriangles;
+
+    FStaticMeshView();
+
+    EReadResult Open(const FContainer& Container);
+
+    /**
+    *   Checks that the cone apex of every meshlet with a cone lies behind the plane of each of its triangles, so that
+    *   the backface test never culls a meshlet whose front a camera sees. Reads the positions of every meshlet triangle.
+    */
+    bool ValidateMeshletCones() const;
+};
+
+class FSkeletalMeshView : public FMeshView
+{
+public:
+    const FObjectExporterSkeletalMeshInfo* Info;
+
+    /** SKIN: NumVertices skin weights of SkinWeightStride bytes. */
+    TView<uint8> SkinWeights;
+    uint32 SkinWeightStride;
+
+    /** BMAP: the bone palettes of the sections, as mesh bone indices. */
+    TView<uint16> BoneMap;
+    TView<FObjectExporterMeshBone> MeshBones;
+
+    FSkeletalMeshView();
+
+    EReadResult Open(const FContainer& Container);
+};
+
+class FSkeletonView
+{
+public:
+    TView<FObjectExporterBone> Bones;
+
+    /** Bone indices, parents first. */
+    TView<uint32> BoneOrder;
+
+    /** One per bone. */
+    TView<FObjectExporterMatrix> BindMatrices;
+    TView<FObjectExporterMatrix> InverseBindMatrices;
+
+    EReadResult Open(const FContainer& Container);
+};
+
+class FAnimSequenceView
+{
+public:
+    const FObjectExporterAnimSequenceInfo* Info;
+
+    /** One per skeleton bone, whatever the encoding. */
+    TView<FObjectExporterAnimBoneTrack> BoneTracks;
+
+    // EObjectExporterAnimEncoding::Raw
+    TView<FObjectExporterAnimTrack> Tracks;
+    TView<FFloat3> PositionKeys;
+    TView<FFloat4> RotationKeys;
+    TView<FFloat3> ScaleKeys;
+
+    // EObjectExporterAnimEncoding::Compressed
+    TView<FObjectExporterCompressedAnimTrack> CompressedTracks;
+    TView<uint16> KeyFrames;
+    TView<FUInt16x3> QuantizedPositionKeys;
+    TView<FUInt16x3> QuantizedRotationKeys;
+    TView<FUInt16x3> QuantizedScaleKeys;
+
+    // EObjectExporterAnimEncoding::FrameMajor, FrameKeys holds NumFrames blocks of FrameLayout->FrameStride floats
+    const FObjectExporterAnimFrameLayout* FrameLayout;
+    TView<FObjectExporterAnimFrameTrack> FrameTracks;
+    TView<float> FrameKeys;
+
+    FAnimSequenceView();
+
+    EReadResult Open(const FContainer& Container);
+};
+
+class FMaterialView
+{
+public:
+    const FObjectExporterMaterialInfo* Info;
+
+    /** String offsets, one per texture slot. */
+    TView<uint32> Textures;
+    TView<FObjectExporterMaterialParameter> Parameters;
+    TView<uint8> ConstantBlock;
+
+    FMaterialView();
+
+    EReadResult Open(const FContainer& Container);
+
+    /** Binary search of PARM, nullptr if the material has no such parameter. */
+    const FObjectExporterMaterialParameter* FindParameter(const char* Name) const;
+};
+
+class FTextureView
+{
+public:
+    const FObjectExporterTextureInfo* Info;
+    TView<FObjectExporterTextureMip> Mips;
+
+    /** TDAT, the mips from Info->FirstResidentMip on. */
+    TView<uint8> ResidentData;
+
+    /** TSTM, the mips before Info->FirstResidentMip, empty if every mip is resident. */
+    TView<uint8> StreamedData;
+
+    FTextureView();
+
+    EReadResult Open(const FContainer& Container);
+
+    /** Blocks of a mip, in TDAT or TSTM. */
+    const uint8* GetMipData(uint32 MipIndex) const;
+};
+
+/**
+*   A map, or one cell of a partitioned map. Partitioned maps only hold their cameras, directional lights, materials
+*   and the cell index, the other records are in the cells:
+*
+*   FContainer CellContainer;
+*   FMapView Cell;
+*   if (CellContainer.Open(Map.GetCellData(CellIndex).GetData(), Map.GetCellData(CellIndex).GetNum()) == EReadResult::Success
+*       && Cell.Open(CellContainer) == EReadResult::Success)
+*/
+class FMapView
+{
+public:
+    TView<FObjectExporterCamera> Cameras;
+    TView<FObjectExporterDirectionalLight> DirectionalLights;
+    TView<FObjectExporterPointLight> PointLights;
+
+    TView<FObjectExporterInstanceBatch> InstanceBatches;
+    TView<FFloat3> InstanceTranslations;
+    TView<FFloat4> InstanceRotations;
+    TView<FFloat3> InstanceScales;
+    TView<FObjectExporterSkeletalMeshActor> SkeletalMeshActors;
+    TView<uint32> MaterialNames;
+
+    TView<FObjectExporterMapMaterial> MapMaterials;
+    TView<FObjectExporterMaterialTexture> MaterialTextures;
+
+    /** Parallel to the instances, SkeletalMeshActors and PointLights. */
+    TView<FObjectExporterBounds> InstanceBounds;
+    TView<FObjectExporterBounds> SkeletalMeshActorBounds;
+    TView<FObjectExporterBounds> PointLightBounds;
+
+    TView<FObjectExporterBVHNode> BVHNodes;
+    TView<FObjectExporterBVHPrimitive> BVHPrimitives;
+
+    /** Partitioned maps, nullptr and empty otherwise. */
+    const FObjectExporterMapGrid* Grid;
+    TView<FObjectExporterMapCell> Cells;
+    TView<uint8> CellData;
+
+    /** Map cells, the assets the cell needs. */
+    TView<FObjectExporterAssetDependency> Dependencies;
+
+    FMapView();
+
+    /** Opens a map or a map cell. */
+    EReadResult Open(const FContainer& Container);
+
+    /** The MapCell file of a cell, in place. */
+    TView<uint8> GetCellData(uint32 CellIndex) const
+    {
+        return TView<uint8>(CellData.GetData() + Cells[CellIndex].DataOffset, (uint32)Cells[CellIndex].DataSize);
+    }
+};
+
+} // namespace ObjectExporterReader
@@ -0,0 +1,354 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterLegacyReader.h"
+
+#include <cstring>
+
+namespace ObjectExporterReader
+{
+
+/** Bounds checked cursor over a legacy file. */
+class FLegacyStream
+{
+public:
+    FLegacyStream(const uint8* InData, uint64 InSize)
+        : Data(InData)
+        , Size(InSize)
+        , Offset(0)
+        , bError(InData == nullptr || (reinterpret_cast<uintptr_t>(InData) & 3) != 0)
+    {
+
+    }
+
+    bool HasError() const
+    {
+        return bError;
+    }
+
+    /** True once everything was read without error. */
+    bool IsComplete() const
+    {
+        return !bError && Offset == Size;
+    }
+
+    uint64 GetRemaining() const
+    {
+        return Size - Offset;
+    }
+
+    template <typename T>
+    T Read()
+    {
+        T Value = T();
+        if (!bError && sizeof(T) <= GetRemaining())
+        {
+            std::memcpy(&Value, Data + Offset, sizeof(T));
+            Offset += sizeof(T);
+        }
+        else
+        {
+            bError = true;
+        }
+
+        return Value;
+    }
+
+    /** int32 count of a TArray or a table. */
+    uint32 ReadCount()
+    {
+        const int32 Count = Read<int32>();
+        if (Count < 0)
+        {
+            bError = true;
+
+            return 0;
+        }
+
+        return (uint32)Count;
+    }
+
+    /** Count records in place, they have to be aligned in the file. */
+    template <typename T>
+    TView<T> ReadView(uint32 Count)
+    {
+        if (bError || Count > GetRemaining() / sizeof(T) || (Offset % alignof(T)) != 0)
+        {
+            bError = true;
+
+            return TView<T>();
+        }
+
+        const TView<T> View(reinterpret_cast<const T*>(Data + Offset), Count);
+        Offset += (uint64)Count * sizeof(T);
+
+        return View;
+    }
+
+    template <typename T>
+    TView<T> ReadArray()
+    {
+        const uint32 Count = ReadCount();
+
+        return ReadView<T>(Count);
+    }
+
+    FLegacyString ReadString()
+    {
+        FLegacyString String;
+
+        const int32 SaveNum = Read<int32>();
+        if (bError || SaveNum == 0)
+        {
+            return String;
+        }
+
+        const bool bWide = SaveNum < 0;
+        const uint64 NumChars = bWide ? (uint64)-(int64)SaveNum : (uint64)SaveNum;
+        const uint64 CharSize = bWide ? sizeof(uint16) : sizeof(char);
+        if (NumChars > GetRemaining() / CharSize || !IsTerminated(Data + Offset, NumChars, CharSize))
+        {
+            bError = true;
+
+            return String;
+        }
+
+        String.Data = Data + Offset;
+        String.Length = (uint32)(NumChars - 1);
+        String.bWide = bWide;
+        Offset += NumChars * CharSize;
+
+        return String;
+    }
+
+    /**
+    *   Whether the next bytes read as an ANSI FString. Legacy materials write their texture names and scalars one after
+    *   the other without counts, this tells them apart: only a denormal scalar reads as a length that fits in the file.
+    */
+    bool IsAnsiStringNext() const
+    {
+        if (bError || GetRemaining() < sizeof(int32))
+        {
+            return false;
+        }
+
+        int32 SaveNum = 0;
+        std::memcpy(&SaveNum, Data + Offset, sizeof(SaveNum));
+        if (SaveNum <= 0 || (uint64)SaveNum > GetRemaining() - sizeof(int32))
+        {
+            return false;
+        }
+
+        const uint8* Chars = Data + Offset + sizeof(int32);
+        for (int32 Index = 0; Index < SaveNum - 1; Index++)
+        {
+            if (Chars[Index] < 0x20)
+            {
+                return false;
+            }
+        }
+
+        return Chars[SaveNum - 1] == 0;
+    }
+
+private:
+    static bool IsTerminated(const uint8* Chars, uint64 NumChars, uint64 CharSize)
+    {
+        for (uint64 Byte = 0; Byte < CharSize; Byte++)
+        {
+            if (Chars[(NumChars - 1) * CharSize + Byte] != 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    const uint8* Data;
+    uint64 Size;
+    uint64 Offset;
+    bool bError;
+};
+
+static EReadResult GetResult(const FLegacyStream& Stream)
+{
+    if (Stream.HasError())
+    {
+        return EReadResult::Truncated;
+    }
+
+    return Stream.IsComplete() ? EReadResult::Success : EReadResult::BadLayout;
+}
+
+static bool AreValidIndices(const TView<uint16>& Indices, uint32 NumVertices)
+{
+    if (Indices.GetNum() % 3 != 0)
+    {
+        return false;
+    }
+
+    for (uint16 Index : Indices)
+    {
+        if (Index >= NumVertices)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+EReadResult ReadLegacyStaticMesh(const uint8* Data, uint64 Size, FLegacyStaticMesh& OutStaticMesh)
+{
+    FLegacyStream Stream(Data, Size);
+    OutStaticMesh.Vertices = Stream.ReadArray<FObjectExporterMeshVertex>();
+    OutStaticMesh.Indices = Stream.ReadArray<uint16>();
+
+    const EReadResult Result = GetResult(Stream);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    return AreValidIndices(OutStaticMesh.Indices, OutStaticMesh.Vertices.GetNum()) ? EReadResult::Success : EReadResult::BadReference;
+}
+
+EReadResult ReadLegacySkeletalMesh(const uint8* Data, uint64 Size, FLegacySkeletalMesh& OutSkeletalMesh)
+{
+    FLegacyStream Stream(Data, Size);
+    OutSkeletalMesh.Vertices = Stream.ReadArray<FLegacySkinnedVertex>();
+    OutSkeletalMesh.Indices = Stream.ReadArray<uint16>();
+    OutSkeletalMesh.SkeletonName = Stream.ReadString();
+
+    const EReadResult Result = GetResult(Stream);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    return AreValidIndices(OutSkeletalMesh.Indices, OutSkeletalMesh.Vertices.GetNum()) ? EReadResult::Success : EReadResult::BadReference;
+}
+
+EReadResult ReadLegacySkeleton(const uint8* Data, uint64 Size, FLegacySkeleton& OutSkeleton)
+{
+    FLegacyStream Stream(Data, Size);
+    OutSkeleton.ParentIndices = Stream.ReadArray<int32>();
+    OutSkeleton.RefPose = Stream.ReadArray<FLegacyBonePose>();
+
+    const EReadResult Result = GetResult(Stream);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    if (OutSkeleton.RefPose.GetNum() != OutSkeleton.ParentIndices.GetNum())
+    {
+        return EReadResult::BadLayout;
+    }
+
+    for (uint32 BoneIndex = 0; BoneIndex < OutSkeleton.ParentIndices.GetNum(); BoneIndex++)
+    {
+        const int32 ParentIndex = OutSkeleton.ParentIndices[BoneIndex];
+        if (BoneIndex == 0 ? ParentIndex != INDEX_NONE : (ParentIndex < 0 || (uint32)ParentIndex >= BoneIndex))
+        {
+            return EReadResult::BadHierarchy;
+        }
+    }
+
+    return EReadResult::Success;
+}
+
+EReadResult ReadLegacyAnimSequence(const uint8* Data, uint64 Size, FLegacyAnimSequence& OutAnimSequence)
+{
+    FLegacyStream Stream(Data, Size);
+    OutAnimSequence.NumFrames = (int32)Stream.ReadCount();
+    OutAnimSequence.SequenceLength = Stream.Read<float>();
+    OutAnimSequence.Tracks.clear();
+
+    // No track count, tracks run to the end of the file
+    while (!Stream.HasError() && Stream.GetRemaining() > 0)
+    {
+        FLegacyAnimTrack Track;
+        Track.BoneIndex = Stream.Read<int32>();
+        Track.PositionKeys = Stream.ReadArray<FFloat3>();
+        Track.RotationKeys = Stream.ReadArray<FFloat4>();
+        Track.ScaleKeys = Stream.ReadArray<FFloat3>();
+
+        const uint32 NumFrames = (uint32)OutAnimSequence.NumFrames;
+        if (Track.BoneIndex < 0 || Track.PositionKeys.GetNum() > NumFrames || Track.RotationKeys.GetNum() > NumFrames || Track.ScaleKeys.GetNum() > NumFrames)
+        {
+            return EReadResult::BadLayout;
+        }
+
+        OutAnimSequence.Tracks.push_back(Track);
+    }
+
+    return GetResult(Stream);
+}
+
+EReadResult ReadLegacyMaterial(const uint8* Data, uint64 Size, FLegacyMaterial& OutMaterial)
+{
+    FLegacyStream Stream(Data, Size);
+    OutMaterial.BlendMode = Stream.Read<int32>();
+    OutMaterial.TextureNames.clear();
+    OutMaterial.Scalars.clear();
+
+    while (Stream.IsAnsiStringNext())
+    {
+        OutMaterial.TextureNames.push_back(Stream.ReadString());
+    }
+
+    if (Stream.GetRemaining() % sizeof(float) != 0)
+    {
+        return EReadResult::BadLayout;
+    }
+
+    while (!Stream.HasError() && Stream.GetRemaining() > 0)
+    {
+        OutMaterial.Scalars.push_back(Stream.Read<float>());
+    }
+
+    return GetResult(Stream);
+}
+
+static void ReadLegacyMapActors(FLegacyStream& Stream, bool bSkeletalMesh, std::vector<FLegacyMapActor>& OutActors)
+{
+    const uint32 NumActors = Stream.ReadCount();
+    OutActors.clear();
+
+    for (uint32 ActorIndex = 0; ActorIndex < NumActors && !Stream.HasError(); ActorIndex++)
+    {
+        FLegacyMapActor Actor;
+        for (float& Component : Actor.Rotation)
+        {
+            Component = Stream.Read<float>();
+        }
+        for (float& Component : Actor.Location)
+        {
+            Component = Stream.Read<float>();
+        }
+
+        Actor.ResourceName = Stream.ReadString();
+        if (bSkeletalMesh)
+        {
+            Actor.AnimationName = Stream.ReadString();
+        }
+        Actor.MaterialName = Stream.ReadString();
+
+        OutActors.push_back(Actor);
+    }
+}
+
+EReadResult ReadLegacyMap(const uint8* Data, uint64 Size, FLegacyMap& OutMap)
+{
+    FLegacyStream Stream(Data, Size);
+    OutMap.Cameras = Stream.ReadArray<FObjectExporterCamera>();
+    OutMap.DirectionalLights = Stream.ReadArray<FObjectExporterDirectionalLight>();
+    OutMap.PointLights = Stream.ReadArray<FObjectExporterPointLight>();
+    ReadLegacyMapActors(Stream, false, OutMap.StaticMeshActors);
+    ReadLegacyMapActors(Stream, true, OutMap.SkeletalMeshActors);
+
+    return GetResult(Stream);
+}
+
+} // namespace ObjectExporterReader
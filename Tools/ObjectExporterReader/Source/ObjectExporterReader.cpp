@@ -0,0 +1,1197 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterReader.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ObjectExporterReader
+{
+
+const char* GetResultName(EReadResult Result)
+{
+    switch (Result)
+    {
+    case EReadResult::Success: return "Success";
+    case EReadResult::OpenFailed: return "OpenFailed";
+    case EReadResult::Truncated: return "Truncated";
+    case EReadResult::BadMagic: return "BadMagic";
+    case EReadResult::ByteSwapped: return "ByteSwapped";
+    case EReadResult::UnsupportedVersion: return "UnsupportedVersion";
+    case EReadResult::WrongFileType: return "WrongFileType";
+    case EReadResult::BadHeader: return "BadHeader";
+    case EReadResult::BadChunk: return "BadChunk";
+    case EReadResult::MissingChunk: return "MissingChunk";
+    case EReadResult::BadReference: return "BadReference";
+    case EReadResult::BadString: return "BadString";
+    case EReadResult::BadHierarchy: return "BadHierarchy";
+    case EReadResult::BadLayout: return "BadLayout";
+    case EReadResult::UnknownFileType: return "UnknownFileType";
+    }
+
+    return "Unknown";
+}
+
+FMappedFile::FMappedFile()
+    : Data(nullptr)
+    , Size(0)
+{
+
+}
+
+FMappedFile::~FMappedFile()
+{
+    Close();
+}
+
+bool FMappedFile::Open(const char* FilePathName)
+{
+    Close();
+
+    const int FileHandle = open(FilePathName, O_RDONLY);
+    if (FileHandle < 0)
+    {
+        return false;
+    }
+
+    struct stat FileStat;
+    if (fstat(FileHandle, &FileStat) != 0 || FileStat.st_size <= 0)
+    {
+        close(FileHandle);
+
+        return false;
+    }
+
+    void* Mapping = mmap(nullptr, (size_t)FileStat.st_size, PROT_READ, MAP_PRIVATE, FileHandle, 0);
+
+    // The mapping keeps its own reference to the file
+    close(FileHandle);
+
+    if (Mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    Data = static_cast<const uint8*>(Mapping);
+    Size = (uint64)FileStat.st_size;
+
+    return true;
+}
+
+void FMappedFile::Close()
+{
+    if (Data != nullptr)
+    {
+        munmap(const_cast<uint8*>(Data), (size_t)Size);
+        Data = nullptr;
+        Size = 0;
+    }
+}
+
+FContainer::FContainer()
+    : Data(nullptr)
+    , Size(0)
+    , Header(nullptr)
+{
+
+}
+
+EReadResult FContainer::Open(const void* InData, uint64 InSize)
+{
+    Data = nullptr;
+    Size = 0;
+    Header = nullptr;
+    Chunks = TView<FObjectExporterChunkEntry>();
+    Strings = TView<char>();
+
+    if (InData == nullptr || InSize < sizeof(FObjectExporterFileHeader))
+    {
+        return EReadResult::Truncated;
+    }
+
+    const FObjectExporterFileHeader* FileHeader = static_cast<const FObjectExporterFileHeader*>(InData);
+    if (FileHeader->Magic != ObjectExporterFile::Magic)
+    {
+        return EReadResult::BadMagic;
+    }
+
+    if (FileHeader->ByteOrderMark != ObjectExporterFile::ByteOrderMark)
+    {
+        return FileHeader->ByteOrderMark == 0x04030201 ? EReadResult::ByteSwapped : EReadResult::BadHeader;
+    }
+
+    if (FileHeader->Version < (uint16)EObjectExporterFileVersion::Initial || FileHeader->Version > (uint16)EObjectExporterFileVersion::Latest)
+    {
+        return EReadResult::UnsupportedVersion;
+    }
+
+    if (FileHeader->HeaderSize < sizeof(FObjectExporterFileHeader) || FileHeader->ChunkTableOffset < FileHeader->HeaderSize
+        || FileHeader->ChunkTableOffset % alignof(FObjectExporterChunkEntry) != 0)
+    {
+        return EReadResult::BadHeader;
+    }
+
+    if (FileHeader->FileSize > InSize)
+    {
+        return EReadResult::Truncated;
+    }
+
+    const uint64 FileSize = FileHeader->FileSize;
+    if (FileHeader->ChunkTableOffset > FileSize || FileHeader->ChunkCount > (FileSize - FileHeader->ChunkTableOffset) / sizeof(FObjectExporterChunkEntry))
+    {
+        return EReadResult::Truncated;
+    }
+
+    const uint8* Bytes = static_cast<const uint8*>(InData);
+    const TView<FObjectExporterChunkEntry> ChunkTable(reinterpret_cast<const FObjectExporterChunkEntry*>(Bytes + FileHeader->ChunkTableOffset), FileHeader->ChunkCount);
+
+    for (const FObjectExporterChunkEntry& Chunk : ChunkTable)
+    {
+        if (Chunk.Offset % OBJECT_EXPORTER_CHUNK_ALIGNMENT != 0 || Chunk.Offset > FileSize || Chunk.Size > FileSize - Chunk.Offset)
+        {
+            return EReadResult::BadChunk;
+        }
+
+        // Views index with 32 bits
+        if (Chunk.Size > 0xFFFFFFFFull)
+        {
+            return EReadResult::BadChunk;
+        }
+
+        if (Chunk.ElementStride > 0 ? Chunk.Size != (uint64)Chunk.ElementCount * Chunk.ElementStride : Chunk.ElementCount != 0)
+        {
+            return EReadResult::BadChunk;
+        }
+    }
+
+    Data = Bytes;
+    Size = FileSize;
+    Header = FileHeader;
+    Chunks = ChunkTable;
+
+    // Every offset into STRS must hit a null terminated string, so the chunk has to end with one
+    const TView<uint8> StringBytes = GetChunkBytes(ObjectExporterChunk::Strings);
+    if (!StringBytes.IsEmpty() && StringBytes[StringBytes.GetNum() - 1] != 0)
+    {
+        Data = nullptr;
+        Size = 0;
+        Header = nullptr;
+        Chunks = TView<FObjectExporterChunkEntry>();
+
+        return EReadResult::BadString;
+    }
+    Strings = TView<char>(reinterpret_cast<const char*>(StringBytes.GetData()), StringBytes.GetNum());
+
+    return EReadResult::Success;
+}
+
+const FObjectExporterChunkEntry* FContainer::FindChunk(uint32 ChunkId) const
+{
+    for (const FObjectExporterChunkEntry& Chunk : Chunks)
+    {
+        if (Chunk.ChunkId == ChunkId)
+        {
+            return &Chunk;
+        }
+    }
+
+    return nullptr;
+}
+
+TView<uint8> FContainer::GetChunkBytes(uint32 ChunkId) const
+{
+    const FObjectExporterChunkEntry* Chunk = FindChunk(ChunkId);
+    if (Chunk == nullptr)
+    {
+        return TView<uint8>();
+    }
+
+    return TView<uint8>(Data + Chunk->Offset, (uint32)Chunk->Size);
+}
+
+/** Typed views are written against the latest layout of every record. */
+static EReadResult CheckFileType(const FContainer& Container, uint32 FileType)
+{
+    if (Container.GetFileType() != FileType)
+    {
+        return EReadResult::WrongFileType;
+    }
+
+    if (Container.GetVersion() != (uint16)EObjectExporterFileVersion::Latest)
+    {
+        return EReadResult::UnsupportedVersion;
+    }
+
+    return EReadResult::Success;
+}
+
+static bool AreValidOptionalStrings(const FContainer& Container, const TView<uint32>& Offsets)
+{
+    for (uint32 Offset : Offsets)
+    {
+        if (!Container.IsValidOptionalString(Offset))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static uint32 GetVertexElementSize(uint32 Format)
+{
+    switch ((EObjectExporterVertexElementFormat)Format)
+    {
+    case EObjectExporterVertexElementFormat::Float2: return 8;
+    case EObjectExporterVertexElementFormat::Float3: return 12;
+    case EObjectExporterVertexElementFormat::Float4: return 16;
+    case EObjectExporterVertexElementFormat::Half2: return 4;
+    case EObjectExporterVertexElementFormat::Half4: return 8;
+    case EObjectExporterVertexElementFormat::UNorm16x4: return 8;
+    case EObjectExporterVertexElementFormat::OctahedralSNorm16x2: return 4;
+    case EObjectExporterVertexElementFormat::UInt8x4: return 4;
+    case EObjectExporterVertexElementFormat::UInt16x4: return 8;
+    case EObjectExporterVertexElementFormat::UNorm8x4: return 4;
+    }
+
+    return 0;
+}
+
+/** Every attribute has a known format and lies inside the vertex of its stream. */
+static bool AreValidVertexAttributes(const TView<FObjectExporterVertexAttribute>& Attributes, uint32 VertexStride, uint32 SkinWeightStride)
+{
+    for (const FObjectExporterVertexAttribute& Attribute : Attributes)
+    {
+        const uint32 ElementSize = GetVertexElementSize(Attribute.Format);
+        const uint32 Stride = Attribute.Stream == 0 ? VertexStride : (Attribute.Stream == 1 ? SkinWeightStride : 0);
+        if (ElementSize == 0 || (uint64)Attribute.Offset + ElementSize > Stride)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+FMeshView::FMeshView()
+    : VertexStride(0)
+    , NumVertices(0)
+    , IndexSize(0)
+    , NumIndices(0)
+{
+
+}
+
+EReadResult FMeshView::OpenMesh(const FContainer& Container, uint32 InIndexSize)
+{
+    const FObjectExporterChunkEntry* VertexChunk = Container.FindChunk(ObjectExporterChunk::Vertices);
+    const FObjectExporterChunkEntry* IndexChunk = Container.FindChunk(ObjectExporterChunk::Indices);
+    if (VertexChunk == nullptr || IndexChunk == nullptr)
+    {
+        return EReadResult::MissingChunk;
+    }
+
+    if (!Container.GetChunk(ObjectExporterChunk::LODs, LODs) || !Container.GetChunk(ObjectExporterChunk::Sections, Sections)
+        || !Container.GetChunk(ObjectExporterChunk::MaterialNames, MaterialNames) || !Container.GetChunk(ObjectExporterChunk::VertexFormat, VertexFormat)
+        || VertexChunk->ElementStride == 0 || (InIndexSize != sizeof(uint16) && InIndexSize != sizeof(uint32)) || IndexChunk->ElementStride != InIndexSize)
+    {
+        return EReadResult::BadChunk;
+    }
+
+    Vertices = Container.GetChunkBytes(ObjectExporterChunk::Vertices);
+    VertexStride = VertexChunk->ElementStride;
+    NumVertices = VertexChunk->ElementCount;
+
+    Indices = Container.GetChunkBytes(ObjectExporterChunk::Indices);
+    IndexSize = InIndexSize;
+    NumIndices = IndexChunk->ElementCount;
+
+    if (!AreValidOptionalStrings(Container, MaterialNames))
+    {
+        return EReadResult::BadString;
+    }
+
+    for (const FObjectExporterMeshLOD& LOD : LODs)
+    {
+        if ((uint64)LOD.FirstVertex + LOD.NumVertices > NumVertices || (uint64)LOD.FirstIndex + LOD.NumIndices > NumIndices
+            || !Sections.IsValidRange(LOD.FirstSection, LOD.NumSections))
+        {
+            return EReadResult::BadReference;
+        }
+
+        for (uint32 SectionIndex = LOD.FirstSection; SectionIndex < LOD.FirstSection + LOD.NumSections; SectionIndex++)
+        {
+            const FObjectExporterMeshSection& Section = Sections[SectionIndex];
+            if (Section.FirstIndex < LOD.FirstIndex || (uint64)Section.FirstIndex + Section.NumIndices > (uint64)LOD.FirstIndex + LOD.NumIndices
+                || (Section.NumIndices > 0 && (Section.MinVertexIndex > Section.MaxVertexIndex || Section.MaxVertexIndex >= LOD.NumVertices))
+                || (!MaterialNames.IsEmpty() && !MaterialNames.IsValidIndex(Section.MaterialIndex)))
+            {
+                return EReadResult::BadReference;
+            }
+        }
+    }
+
+    return EReadResult::Success;
+}
+
+bool FMeshView::ValidateIndices() const
+{
+    for (const FObjectExporterMeshLOD& LOD : LODs)
+    {
+        uint32 MaxIndex = 0;
+        if (IndexSize == sizeof(uint16))
+        {
+            const uint16* LODIndices = reinterpret_cast<const uint16*>(Indices.GetData()) + LOD.FirstIndex;
+            for (uint32 Index = 0; Index < LOD.NumIndices; Index++)
+            {
+                MaxIndex = LODIndices[Index] > MaxIndex ? LODIndices[Index] : MaxIndex;
+            }
+        }
+        else
+        {
+            const uint32* LODIndices = reinterpret_cast<const uint32*>(Indices.GetData()) + LOD.FirstIndex;
+            for (uint32 Index = 0; Index < LOD.NumIndices; Index++)
+            {
+                MaxIndex = LODIndices[Index] > MaxIndex ? LODIndices[Index] : MaxIndex;
+            }
+        }
+
+        if (LOD.NumIndices > 0 && MaxIndex >= LOD.NumVertices)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+FStaticMeshView::FStaticMeshView()
+    : Info(nullptr)
+{
+
+}
+
+EReadResult FStaticMeshView::Open(const FContainer& Container)
+{
+    EReadResult Result = CheckFileType(Container, ObjectExporterFile::StaticMesh);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    Info = Container.GetSingleElementChunk<FObjectExporterStaticMeshInfo>(ObjectExporterChunk::Info);
+    if (Info == nullptr)
+    {
+        return EReadResult::MissingChunk;
+    }
+
+    Result = OpenMesh(Container, Info->IndexSize);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    if (!AreValidVertexAttributes(VertexFormat, VertexStride, 0))
+    {
+        return EReadResult::BadChunk;
+    }
+
+    if (!Container.GetChunk(ObjectExporterChunk::Meshlets, Meshlets) || !Container.GetChunk(ObjectExporterChunk::MeshletVertices, MeshletVertices)
+        || !Container.GetChunk(ObjectExporterChunk::MeshletTriangles, MeshletTriangles))
+    {
+        return EReadResult::BadChunk;
+    }
+
+    for (const FObjectExporterMeshlet& Meshlet : Meshlets)
+    {
+        if (!MeshletVertices.IsValidRange(Meshlet.FirstVertex, Meshlet.NumVertices) || !MeshletTriangles.IsValidRange(Meshlet.FirstTriangle, Meshlet.NumTriangles)
+            || !Sections.IsValidIndex(Meshlet.SectionIndex))
+        {
+            return EReadResult::BadReference;
+        }
+
+        for (uint32 Triangle = Meshlet.FirstTriangle; Triangle < Meshlet.FirstTriangle + Meshlet.NumTriangles; Triangle++)
+        {
+            const FUInt8x3& LocalIndices = MeshletTriangles[Triangle];
+            if (LocalIndices.V[0] >= Meshlet.NumVertices || LocalIndices.V[1] >= Meshlet.NumVertices || LocalIndices.V[2] >= Meshlet.NumVertices)
+            {
+                return EReadResult::BadReference;
+            }
+        }
+    }
+
+    for (uint32 MeshletVertex : MeshletVertices)
+    {
+        if (MeshletVertex >= NumVertices)
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    return EReadResult::Success;
+}
+
+static float DecodeHalf(uint16 Half)
+{
+    const int32 Exponent = (Half >> 10) & 0x1F;
+    const uint32 Mantissa = Half & 0x3FF;
+
+    float Value;
+    if (Exponent == 0)
+    {
+        Value = std::ldexp((float)Mantissa, -24);
+    }
+    else if (Exponent == 31)
+    {
+        Value = Mantissa == 0 ? INFINITY : NAN;
+    }
+    else
+    {
+        Value = std::ldexp((float)(Mantissa | 0x400), Exponent - 25);
+    }
+
+    return (Half & 0x8000) != 0 ? -Value : Value;
+}
+
+/** Position of a vertex in the formats the exporter writes positions in, false for any other. */
+static bool DecodeVertexPosition(const uint8* Vertex, const FObjectExporterVertexAttribute& Attribute, float OutPosition[3])
+{
+    for (int32 Component = 0; Component < 3; Component++)
+    {
+        float Value;
+        switch ((EObjectExporterVertexElementFormat)Attribute.Format)
+        {
+        case EObjectExporterVertexElementFormat::Float3:
+        case EObjectExporterVertexElementFormat::Float4:
+            std::memcpy(&Value, Vertex + Attribute.Offset + Component * sizeof(float), sizeof(float));
+            break;
+        case EObjectExporterVertexElementFormat::Half4:
+        {
+            uint16 Half;
+            std::memcpy(&Half, Vertex + Attribute.Offset + Component * sizeof(uint16), sizeof(uint16));
+            Value = DecodeHalf(Half);
+            break;
+        }
+        case EObjectExporterVertexElementFormat::UNorm16x4:
+        {
+            uint16 Quantized;
+            std::memcpy(&Quantized, Vertex + Attribute.Offset + Component * sizeof(uint16), sizeof(uint16));
+            Value = Quantized / 65535.0f;
+            break;
+        }
+        default:
+            return false;
+        }
+
+        OutPosition[Component] = Value * Attribute.Scale[Component] + Attribute.Bias[Component];
+    }
+
+    return true;
+}
+
+bool FStaticMeshView::ValidateMeshletCones() const
+{
+    // Without VFMT, VERT holds FObjectExporterMeshVertex
+    FObjectExporterVertexAttribute PositionAttribute = { (uint32)EObjectExporterVertexSemantic::Position, (uint32)EObjectExporterVertexElementFormat::Float3, 0, 0, { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f } };
+    for (const FObjectExporterVertexAttribute& Attribute : VertexFormat)
+    {
+        if (Attribute.Semantic == (uint32)EObjectExporterVertexSemantic::Position && Attribute.Stream == 0)
+        {
+            PositionAttribute = Attribute;
+        }
+    }
+
+    for (const FObjectExporterMeshlet& Meshlet : Meshlets)
+    {
+        // A cutoff of 1 or more never culls
+        if (!(Meshlet.ConeCutoff < 1.0f))
+        {
+            continue;
+        }
+
+        const FObjectExporterMeshLOD* MeshletLOD = nullptr;
+        for (const FObjectExporterMeshLOD& LOD : LODs)
+        {
+            if (Meshlet.SectionIndex >= LOD.FirstSection && Meshlet.SectionIndex - LOD.FirstSection < LOD.NumSections)
+            {
+                MeshletLOD = &LOD;
+            }
+        }
+
+        if (MeshletLOD == nullptr)
+        {
+            return false;
+        }
+
+        // Quantized positions move the planes a little
+        const float Tolerance = 1e-3f * Meshlet.Radius + 1e-4f;
+
+        for (uint32 Triangle = Meshlet.FirstTriangle; Triangle < Meshlet.FirstTriangle + Meshlet.NumTriangles; Triangle++)
+        {
+            float Corners[3][3];
+            for (int32 Corner = 0; Corner < 3; Corner++)
+            {
+                const uint64 VertexIndex = (uint64)MeshletLOD->FirstVertex + MeshletVertices[Meshlet.FirstVertex + MeshletTriangles[Triangle].V[Corner]];
+                if (VertexIndex >= NumVertices || !DecodeVertexPosition(Vertices.GetData() + VertexIndex * VertexStride, PositionAttribute, Corners[Corner]))
+                {
+                    return false;
+                }
+            }
+
+            const float Edge1[3] = { Corners[1][0] - Corners[0][0], Corners[1][1] - Corners[0][1], Corners[1][2] - Corners[0][2] };
+            const float Edge2[3] = { Corners[2][0] - Corners[0][0], Corners[2][1] - Corners[0][1], Corners[2][2] - Corners[0][2] };
+            float Normal[3] = { Edge1[1] * Edge2[2] - Edge1[2] * Edge2[1], Edge1[2] * Edge2[0] - Edge1[0] * Edge2[2], Edge1[0] * Edge2[1] - Edge1[1] * Edge2[0] };
+            const float Length = std::sqrt(Normal[0] * Normal[0] + Normal[1] * Normal[1] + Normal[2] * Normal[2]);
+            if (!(Length > 0.0f))
+            {
+                continue;
+            }
+
+            // The winding is the source mesh's, every front face of a meshlet with a cone faces along its axis
+            const float AxisDot = Normal[0] * Meshlet.ConeAxis[0] + Normal[1] * Meshlet.ConeAxis[1] + Normal[2] * Meshlet.ConeAxis[2];
+            const float Sign = AxisDot < 0.0f ? -1.0f : 1.0f;
+
+            const float ApexDistance = Sign / Length * ((Meshlet.ConeApex[0] - Corners[0][0]) * Normal[0] + (Meshlet.ConeApex[1] - Corners[0][1]) * Normal[1]
+                + (Meshlet.ConeApex[2] - Corners[0][2]) * Normal[2]);
+            if (ApexDistance > Tolerance)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/** Parents come before their children, which also rules out cycles. */
+template <typename BoneType>
+static bool IsValidHierarchy(const TView<BoneType>& Bones)
+{
+    for (uint32 BoneIndex = 0; BoneIndex < Bones.GetNum(); BoneIndex++)
+    {
+        const int32 ParentIndex = Bones[BoneIndex].ParentIndex;
+        if (BoneIndex == 0 ? ParentIndex != INDEX_NONE : (ParentIndex < 0 || (uint32)ParentIndex >= BoneIndex))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+FSkeletalMeshView::FSkeletalMeshView()
+    : Info(nullptr)
+    , SkinWeightStride(0)
+{
+
+}
+
+EReadResult FSkeletalMeshView::Open(const FContainer& Container)
+{
+    EReadResult Result = CheckFileType(Container, ObjectExporterFile::SkeletalMesh);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    Info = Container.GetSingleElementChunk<FObjectExporterSkeletalMeshInfo>(ObjectExporterChunk::Info);
+    if (Info == nullptr)
+    {
+        return EReadResult::MissingChunk;
+    }
+
+    if (!Container.IsValidOptionalString(Info->SkeletonName))
+    {
+        return EReadResult::BadString;
+    }
+
+    Result = OpenMesh(Container, Info->IndexSize);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    const FObjectExporterChunkEntry* SkinWeightChunk = Container.FindChunk(ObjectExporterChunk::SkinWeights);
+    if (SkinWeightChunk == nullptr)
+    {
+        return EReadResult::MissingChunk;
+    }
+
+    SkinWeights = Container.GetChunkBytes(ObjectExporterChunk::SkinWeights);
+    SkinWeightStride = SkinWeightChunk->ElementStride;
+    if (SkinWeightChunk->ElementCount != NumVertices || !AreValidVertexAttributes(VertexFormat, VertexStride, SkinWeightStride))
+    {
+        return EReadResult::BadChunk;
+    }
+
+    if (!Container.GetChunk(ObjectExporterChunk::BoneMap, BoneMap) || !Container.GetChunk(ObjectExporterChunk::MeshBones, MeshBones))
+    {
+        return EReadResult::BadChunk;
+    }
+
+    for (const FObjectExporterMeshSection& Section : Sections)
+    {
+        if (!BoneMap.IsValidRange(Section.FirstBone, Section.NumBones))
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    for (uint16 MeshBoneIndex : BoneMap)
+    {
+        if (!MeshBones.IsValidIndex(MeshBoneIndex))
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    for (const FObjectExporterMeshBone& MeshBone : MeshBones)
+    {
+        if (!Container.IsValidOptionalString(MeshBone.Name))
+        {
+            return EReadResult::BadString;
+        }
+    }
+
+    return IsValidHierarchy(MeshBones) ? EReadResult::Success : EReadResult::BadHierarchy;
+}
+
+EReadResult FSkeletonView::Open(const FContainer& Container)
+{
+    const EReadResult Result = CheckFileType(Container, ObjectExporterFile::Skeleton);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    if (Container.FindChunk(ObjectExporterChunk::Bones) == nullptr)
+    {
+        return EReadResult::MissingChunk;
+    }
+
+    if (!Container.GetChunk(ObjectExporterChunk::Bones, Bones) || !Container.GetChunk(ObjectExporterChunk::BoneOrder, BoneOrder)
+        || !Container.GetChunk(ObjectExporterChunk::BindMatrices, BindMatrices) || !Container.GetChunk(ObjectExporterChunk::InverseBindMatrices, InverseBindMatrices))
+    {
+        return EReadResult::BadChunk;
+    }
+
+    if (BoneOrder.GetNum() != Bones.GetNum() || BindMatrices.GetNum() != Bones.GetNum() || InverseBindMatrices.GetNum() != Bones.GetNum())
+    {
+        return EReadResult::BadChunk;
+    }
+
+    for (const FObjectExporterBone& Bone : Bones)
+    {
+        if (!Container.IsValidOptionalString(Bone.Name))
+        {
+            return EReadResult::BadString;
+        }
+    }
+
+    if (!IsValidHierarchy(Bones))
+    {
+        return EReadResult::BadHierarchy;
+    }
+
+    for (uint32 BoneIndex : BoneOrder)
+    {
+        if (!Bones.IsValidIndex(BoneIndex))
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    return EReadResult::Success;
+}
+
+FAnimSequenceView::FAnimSequenceView()
+    : Info(nullptr)
+    , FrameLayout(nullptr)
+{
+
+}
+
+static bool IsValidAnimChannel(const FObjectExporterAnimChannel& Channel, const TView<uint16>& KeyFrames, const TView<FUInt16x3>& Keys)
+{
+    switch (Channel.Format)
+    {
+    case EObjectExporterAnimChannelFormat::Identity:
+    case EObjectExporterAnimChannelFormat::Constant:
+        return true;
+    case EObjectExporterAnimChannelFormat::Animated:
+        return Channel.NumKeys > 0 && Keys.IsValidRange(Channel.FirstKey, Channel.NumKeys) && KeyFrames.IsValidRange(Channel.FirstFrame, Channel.NumKeys);
+    }
+
+    return false;
+}
+
+static bool IsValidAnimLane(int32 Lane, uint32 NumLanes)
+{
+    return Lane == INDEX_NONE || (Lane >= 0 && (uint32)Lane < NumLanes);
+}
+
+EReadResult FAnimSequenceView::Open(const FContainer& Container)
+{
+    const EReadResult Result = CheckFileType(Container, ObjectExporterFile::AnimSequence);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    Info = Container.GetSingleElementChunk<FObjectExporterAnimSequenceInfo>(ObjectExporterChunk::Info);
+    if (Info == nullptr)
+    {
+        return EReadResult::MissingChunk;
+    }
+
+    if (Info->NumFrames < 0 || !Container.IsValidOptionalString(Info->SkeletonName))
+    {
+        return EReadResult::BadHeader;
+    }
+
+    if (!Container.GetChunk(ObjectExporterChunk::BoneTracks, BoneTracks) || BoneTracks.GetNum() != Info->NumBones)
+    {
+        return EReadResult::BadChunk;
+    }
+
+    for (const FObjectExporterAnimBoneTrack& BoneTrack : BoneTracks)
+    {
+        if (BoneTrack.TrackIndex != INDEX_NONE && (BoneTrack.TrackIndex < 0 || (uint32)BoneTrack.TrackIndex >= Info->NumTracks))
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    switch (Info->Encoding)
+    {
+    case EObjectExporterAnimEncoding::Raw:
+        if (!Container.GetChunk(ObjectExporterChunk::Tracks, Tracks) || !Container.GetChunk(ObjectExporterChunk::PositionKeys, PositionKeys)
+            || !Container.GetChunk(ObjectExporterChunk::RotationKeys, RotationKeys) || !Container.GetChunk(ObjectExporterChunk::ScaleKeys, ScaleKeys)
+            || Tracks.GetNum() != Info->NumTracks)
+        {
+            return EReadResult::BadChunk;
+        }
+
+        for (const FObjectExporterAnimTrack& Track : Tracks)
+        {
+            if (!PositionKeys.IsValidRange(Track.FirstPositionKey, Track.NumPositionKeys) || !RotationKeys.IsValidRange(Track.FirstRotationKey, Track.NumRotationKeys)
+                || !ScaleKeys.IsValidRange(Track.FirstScaleKey, Track.NumScaleKeys) || !BoneTracks.IsValidIndex((uint32)Track.BoneIndex))
+            {
+                return EReadResult::BadReference;
+            }
+        }
+        break;
+
+    case EObjectExporterAnimEncoding::Compressed:
+        if (!Container.GetChunk(ObjectExporterChunk::CompressedTracks, CompressedTracks) || !Container.GetChunk(ObjectExporterChunk::KeyFrames, KeyFrames)
+            || !Container.GetChunk(ObjectExporterChunk::QuantizedPositionKeys, QuantizedPositionKeys)
+            || !Container.GetChunk(ObjectExporterChunk::QuantizedRotationKeys, QuantizedRotationKeys)
+            || !Container.GetChunk(ObjectExporterChunk::QuantizedScaleKeys, QuantizedScaleKeys) || CompressedTracks.GetNum() != Info->NumTracks)
+        {
+            return EReadResult::BadChunk;
+        }
+
+        for (const FObjectExporterCompressedAnimTrack& Track : CompressedTracks)
+        {
+            if (!IsValidAnimChannel(Track.Position, KeyFrames, QuantizedPositionKeys) || !IsValidAnimChannel(Track.Rotation, KeyFrames, QuantizedRotationKeys)
+                || !IsValidAnimChannel(Track.Scale, KeyFrames, QuantizedScaleKeys) || !BoneTracks.IsValidIndex((uint32)Track.BoneIndex))
+            {
+                return EReadResult::BadReference;
+            }
+        }
+        break;
+
+    case EObjectExporterAnimEncoding::FrameMajor:
+        FrameLayout = Container.GetSingleElementChunk<FObjectExporterAnimFrameLayout>(ObjectExporterChunk::FrameLayout);
+        if (FrameLayout == nullptr)
+        {
+            return EReadResult::MissingChunk;
+        }
+
+        if (!Container.GetChunk(ObjectExporterChunk::FrameTracks, FrameTracks) || !Container.GetChunk(ObjectExporterChunk::FrameKeys, FrameKeys)
+            || FrameTracks.GetNum() != Info->NumTracks
+            || FrameLayout->FrameStride != 4 * FrameLayout->NumRotationLanes + 3 * FrameLayout->NumTranslationLanes + 3 * FrameLayout->NumScaleLanes
+            || FrameKeys.GetNum() != (uint64)FrameLayout->FrameStride * (uint32)Info->NumFrames)
+        {
+            return EReadResult::BadChunk;
+        }
+
+        for (const FObjectExporterAnimFrameTrack& Track : FrameTracks)
+        {
+            if (!IsValidAnimLane(Track.RotationLane, FrameLayout->NumRotationLanes) || !IsValidAnimLane(Track.TranslationLane, FrameLayout->NumTranslationLanes)
+                || !IsValidAnimLane(Track.ScaleLane, FrameLayout->NumScaleLanes) || !BoneTracks.IsValidIndex((uint32)Track.BoneIndex))
+            {
+                return EReadResult::BadReference;
+            }
+        }
+        break;
+
+    default:
+        return EReadResult::BadHeader;
+    }
+
+    return EReadResult::Success;
+}
+
+FMaterialView::FMaterialView()
+    : Info(nullptr)
+{
+
+}
+
+EReadResult FMaterialView::Open(const FContainer& Container)
+{
+    const EReadResult Result = CheckFileType(Container, ObjectExporterFile::Material);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    Info = Container.GetSingleElementChunk<FObjectExporterMaterialInfo>(ObjectExporterChunk::Info);
+    if (Info == nullptr)
+    {
+        return EReadResult::MissingChunk;
+    }
+
+    if (!Container.GetChunk(ObjectExporterChunk::Textures, Textures) || !Container.GetChunk(ObjectExporterChunk::MaterialParameters, Parameters))
+    {
+        return EReadResult::BadChunk;
+    }
+
+    ConstantBlock = Container.GetChunkBytes(ObjectExporterChunk::ConstantBlock);
+    if (ConstantBlock.GetNum() != Info->ConstantBlockSize || ConstantBlock.GetNum() % 16 != 0)
+    {
+        return EReadResult::BadChunk;
+    }
+
+    if (!Container.IsValidOptionalString(Info->BaseMaterialName) || !AreValidOptionalStrings(Container, Textures))
+    {
+        return EReadResult::BadString;
+    }
+
+    for (uint32 ParameterIndex = 0; ParameterIndex < Parameters.GetNum(); ParameterIndex++)
+    {
+        const FObjectExporterMaterialParameter& Parameter = Parameters[ParameterIndex];
+        if (!Container.IsValidString(Parameter.Name))
+        {
+            return EReadResult::BadString;
+        }
+
+        // FindParameter relies on the order
+        if (ParameterIndex > 0 && Parameters[ParameterIndex - 1].NameHash > Parameter.NameHash)
+        {
+            return EReadResult::BadChunk;
+        }
+
+        bool bValid = false;
+        switch (Parameter.Type)
+        {
+        case EObjectExporterMaterialParameterType::Scalar:
+            bValid = Parameter.Offset >= 0 && Parameter.Offset % 4 == 0 && ConstantBlock.IsValidRange((uint32)Parameter.Offset, sizeof(float));
+            break;
+        case EObjectExporterMaterialParameterType::Vector:
+            bValid = Parameter.Offset >= 0 && Parameter.Offset % 16 == 0 && ConstantBlock.IsValidRange((uint32)Parameter.Offset, 4 * sizeof(float));
+            break;
+        case EObjectExporterMaterialParameterType::Texture:
+            bValid = Parameter.TextureSlot >= 0 && Textures.IsValidIndex((uint32)Parameter.TextureSlot);
+            break;
+        }
+
+        if (!bValid)
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    return EReadResult::Success;
+}
+
+const FObjectExporterMaterialParameter* FMaterialView::FindParameter(const char* Name) const
+{
+    const uint32 NameHash = ObjectExporterFile::HashName(Name);
+
+    uint32 First = 0;
+    uint32 Count = Parameters.GetNum();
+    while (Count > 0)
+    {
+        const uint32 Half = Count / 2;
+        if (Parameters[First + Half].NameHash < NameHash)
+        {
+            First += Half + 1;
+            Count -= Half + 1;
+        }
+        else
+        {
+            Count = Half;
+        }
+    }
+
+    // The exporter warns about colliding names, the first one wins
+    if (First < Parameters.GetNum() && Parameters[First].NameHash == NameHash)
+    {
+        return &Parameters[First];
+    }
+
+    return nullptr;
+}
+
+FTextureView::FTextureView()
+    : Info(nullptr)
+{
+
+}
+
+EReadResult FTextureView::Open(const FContainer& Container)
+{
+    const EReadResult Result = CheckFileType(Container, ObjectExporterFile::Texture);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    Info = Container.GetSingleElementChunk<FObjectExporterTextureInfo>(ObjectExporterChunk::Info);
+    if (Info == nullptr)
+    {
+        return EReadResult::MissingChunk;
+    }
+
+    if (!Container.GetChunk(ObjectExporterChunk::TextureMips, Mips) || Mips.GetNum() != Info->NumMips || Info->FirstResidentMip > Info->NumMips)
+    {
+        return EReadResult::BadChunk;
+    }
+
+    ResidentData = Container.GetChunkBytes(ObjectExporterChunk::TextureData);
+    StreamedData = Container.GetChunkBytes(ObjectExporterChunk::StreamedTextureData);
+
+    const FObjectExporterChunkEntry* StreamedChunk = Container.FindChunk(ObjectExporterChunk::StreamedTextureData);
+    if (StreamedChunk != nullptr && StreamedChunk->Offset % OBJECT_EXPORTER_TEXTURE_STREAMING_ALIGNMENT != 0)
+    {
+        return EReadResult::BadChunk;
+    }
+
+    for (uint32 MipIndex = 0; MipIndex < Mips.GetNum(); MipIndex++)
+    {
+        const FObjectExporterTextureMip& Mip = Mips[MipIndex];
+        const TView<uint8>& MipData = MipIndex < Info->FirstResidentMip ? StreamedData : ResidentData;
+        if (!MipData.IsValidRange(Mip.DataOffset, Mip.DataSize))
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    return EReadResult::Success;
+}
+
+const uint8* FTextureView::GetMipData(uint32 MipIndex) const
+{
+    const TView<uint8>& MipData = MipIndex < Info->FirstResidentMip ? StreamedData : ResidentData;
+
+    return MipData.GetData() + Mips[MipIndex].DataOffset;
+}
+
+FMapView::FMapView()
+    : Grid(nullptr)
+{
+
+}
+
+/** Cells have to be inside the grid, sorted by row then column, unique and in CDAT. */
+static EReadResult ValidateMapCells(const FContainer& Container, const FObjectExporterMapGrid* Grid, const TView<FObjectExporterMapCell>& Cells, const TView<uint8>& CellData)
+{
+    if (Grid == nullptr)
+    {
+        return Cells.IsEmpty() && CellData.IsEmpty() ? EReadResult::Success : EReadResult::MissingChunk;
+    }
+
+    const FObjectExporterChunkEntry* CellDataChunk = Container.FindChunk(ObjectExporterChunk::MapCellData);
+    if (!(Grid->CellSize > 0.0f) || (CellDataChunk != nullptr && CellDataChunk->Offset % OBJECT_EXPORTER_MAP_CELL_ALIGNMENT != 0))
+    {
+        return EReadResult::BadChunk;
+    }
+
+    for (uint32 CellIndex = 0; CellIndex < Cells.GetNum(); CellIndex++)
+    {
+        const FObjectExporterMapCell& Cell = Cells[CellIndex];
+        const int64 Column = (int64)Cell.CellX - Grid->MinCellX;
+        const int64 Row = (int64)Cell.CellY - Grid->MinCellY;
+        if (Column < 0 || Column >= Grid->NumCellsX || Row < 0 || Row >= Grid->NumCellsY)
+        {
+            return EReadResult::BadReference;
+        }
+
+        if (CellIndex > 0)
+        {
+            const FObjectExporterMapCell& Previous = Cells[CellIndex - 1];
+            if (Cell.CellY < Previous.CellY || (Cell.CellY == Previous.CellY && Cell.CellX <= Previous.CellX))
+            {
+                return EReadResult::BadReference;
+            }
+        }
+
+        if (Cell.DataOffset % OBJECT_EXPORTER_MAP_CELL_ALIGNMENT != 0 || !CellData.IsValidRange(Cell.DataOffset, Cell.DataSize))
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    return EReadResult::Success;
+}
+
+EReadResult FMapView::Open(const FContainer& Container)
+{
+    const bool bCell = Container.GetFileType() == ObjectExporterFile::MapCell;
+    EReadResult Result = CheckFileType(Container, bCell ? ObjectExporterFile::MapCell : ObjectExporterFile::Map);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    if (!Container.GetChunk(ObjectExporterChunk::Cameras, Cameras) || !Container.GetChunk(ObjectExporterChunk::DirectionalLights, DirectionalLights)
+        || !Container.GetChunk(ObjectExporterChunk::PointLights, PointLights) || !Container.GetChunk(ObjectExporterChunk::InstanceBatches, InstanceBatches)
+        || !Container.GetChunk(ObjectExporterChunk::InstanceTranslations, InstanceTranslations)
+        || !Container.GetChunk(ObjectExporterChunk::InstanceRotations, InstanceRotations)
+        || !Container.GetChunk(ObjectExporterChunk::InstanceScales, InstanceScales)
+        || !Container.GetChunk(ObjectExporterChunk::SkeletalMeshActors, SkeletalMeshActors)
+        || !Container.GetChunk(ObjectExporterChunk::MaterialNames, MaterialNames) || !Container.GetChunk(ObjectExporterChunk::MapMaterials, MapMaterials)
+        || !Container.GetChunk(ObjectExporterChunk::MaterialTextures, MaterialTextures)
+        || !Container.GetChunk(ObjectExporterChunk::InstanceBounds, InstanceBounds)
+        || !Container.GetChunk(ObjectExporterChunk::SkeletalMeshActorBounds, SkeletalMeshActorBounds)
+        || !Container.GetChunk(ObjectExporterChunk::PointLightBounds, PointLightBounds) || !Container.GetChunk(ObjectExporterChunk::BVHNodes, BVHNodes)
+        || !Container.GetChunk(ObjectExporterChunk::BVHPrimitives, BVHPrimitives)
+        || !Container.GetChunk(ObjectExporterChunk::MapCells, Cells) || !Container.GetChunk(ObjectExporterChunk::AssetDependencies, Dependencies))
+    {
+        return EReadResult::BadChunk;
+    }
+
+    // A cell does not nest cells, a map has no dependencies of its own
+    Grid = Container.GetSingleElementChunk<FObjectExporterMapGrid>(ObjectExporterChunk::MapGrid);
+    CellData = Container.GetChunkBytes(ObjectExporterChunk::MapCellData);
+    if ((bCell && Container.FindChunk(ObjectExporterChunk::MapGrid) != nullptr) || (!bCell && !Dependencies.IsEmpty())
+        || (Grid == nullptr && Container.FindChunk(ObjectExporterChunk::MapGrid) != nullptr))
+    {
+        return EReadResult::BadChunk;
+    }
+
+    Result = ValidateMapCells(Container, Grid, Cells, CellData);
+    if (Result != EReadResult::Success)
+    {
+        return Result;
+    }
+
+    for (const FObjectExporterAssetDependency& Dependency : Dependencies)
+    {
+        if (!Container.IsValidString(Dependency.Name))
+        {
+            return EReadResult::BadString;
+        }
+    }
+
+    const uint32 NumInstances = InstanceTranslations.GetNum();
+    if (InstanceRotations.GetNum() != NumInstances || InstanceScales.GetNum() != NumInstances
+        || (!InstanceBounds.IsEmpty() && InstanceBounds.GetNum() != NumInstances)
+        || (!SkeletalMeshActorBounds.IsEmpty() && SkeletalMeshActorBounds.GetNum() != SkeletalMeshActors.GetNum())
+        || (!PointLightBounds.IsEmpty() && PointLightBounds.GetNum() != PointLights.GetNum()))
+    {
+        return EReadResult::BadChunk;
+    }
+
+    if (!AreValidOptionalStrings(Container, MaterialNames))
+    {
+        return EReadResult::BadString;
+    }
+
+    for (const FObjectExporterInstanceBatch& Batch : InstanceBatches)
+    {
+        if (!Container.IsValidString(Batch.ResourceName))
+        {
+            return EReadResult::BadString;
+        }
+
+        if (!MaterialNames.IsValidRange(Batch.FirstMaterial, Batch.NumMaterials) || !InstanceTranslations.IsValidRange(Batch.FirstInstance, Batch.NumInstances))
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    for (const FObjectExporterSkeletalMeshActor& Actor : SkeletalMeshActors)
+    {
+        if (!Container.IsValidString(Actor.ResourceName) || !Container.IsValidOptionalString(Actor.AnimationName))
+        {
+            return EReadResult::BadString;
+        }
+
+        if (!MaterialNames.IsValidRange(Actor.FirstMaterial, Actor.NumMaterials))
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    for (const FObjectExporterMapMaterial& Material : MapMaterials)
+    {
+        if (!Container.IsValidString(Material.Name))
+        {
+            return EReadResult::BadString;
+        }
+
+        if (!MaterialTextures.IsValidRange(Material.FirstTexture, Material.NumTextures))
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    for (const FObjectExporterMaterialTexture& Texture : MaterialTextures)
+    {
+        if (!Container.IsValidString(Texture.Name))
+        {
+            return EReadResult::BadString;
+        }
+    }
+
+    for (const FObjectExporterBVHPrimitive& Primitive : BVHPrimitives)
+    {
+        bool bValid = false;
+        switch ((EObjectExporterPrimitiveType)Primitive.Type)
+        {
+        case EObjectExporterPrimitiveType::Instance:
+            bValid = Primitive.Index < NumInstances;
+            break;
+        case EObjectExporterPrimitiveType::SkeletalMeshActor:
+            bValid = SkeletalMeshActors.IsValidIndex(Primitive.Index);
+            break;
+        case EObjectExporterPrimitiveType::PointLight:
+            bValid = PointLights.IsValidIndex(Primitive.Index);
+            break;
+        }
+
+        if (!bValid)
+        {
+            return EReadResult::BadReference;
+        }
+    }
+
+    // Child nodes always come after their parent, so a traversal from the root terminates
+    for (uint32 NodeIndex = 0; NodeIndex < BVHNodes.GetNum(); NodeIndex++)
+    {
+        const FObjectExporterBVHNode& Node = BVHNodes[NodeIndex];
+        for (int32 Child = 0; Child < 4; Child++)
+        {
+            const int32 ChildIndex = Node.Children[Child];
+            const bool bValid = Node.Counts[Child] > 0
+                ? ChildIndex >= 0 && BVHPrimitives.IsValidRange((uint32)ChildIndex, Node.Counts[Child])
+                : ChildIndex == INDEX_NONE || (ChildIndex > (int32)NodeIndex && BVHNodes.IsValidIndex((uint32)ChildIndex));
+            if (!bValid)
+            {
+                return EReadResult::BadReference;
+            }
+        }
+    }
+
+    return EReadResult::Success;
+}
+
+} // namespace ObjectExporterReader
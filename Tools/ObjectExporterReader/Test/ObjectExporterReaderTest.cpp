@@ -0,0 +1,1279 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ObjectExporterReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/*
+*   Builds a small container of every file type in memory, checks that it opens, then damages it the way a truncated or
+*   corrupted file would be and checks that Open reports the expected EReadResult instead of handing out bad views.
+*
+*   ObjectExporterReaderTest
+*
+*   Returns the number of failed checks.
+*/
+
+using namespace ObjectExporterReader;
+
+namespace
+{
+
+int32 NumChecks = 0;
+int32 NumFailures = 0;
+
+void Check(bool bCondition, const char* Expression, const char* File, int32 Line)
+{
+    NumChecks++;
+    if (!bCondition)
+    {
+        NumFailures++;
+        std::printf("%s:%d: check failed: %s\n", File, Line, Expression);
+    }
+}
+
+void CheckResult(EReadResult Result, EReadResult Expected, const char* Expression, const char* File, int32 Line)
+{
+    NumChecks++;
+    if (Result != Expected)
+    {
+        NumFailures++;
+        std::printf("%s:%d: %s returned %s, expected %s\n", File, Line, Expression, GetResultName(Result), GetResultName(Expected));
+    }
+}
+
+#define CHECK(Condition) Check((Condition), #Condition, __FILE__, __LINE__)
+#define CHECK_RESULT(Expression, Expected) CheckResult((Expression), (Expected), #Expression, __FILE__, __LINE__)
+
+/** Chunk id no view looks for, renaming a chunk to it removes the chunk without moving anything. */
+constexpr uint32 UnknownChunk = ObjectExporterFourCC('X', 'X', 'X', 'X');
+
+struct alignas(OBJECT_EXPORTER_CHUNK_ALIGNMENT) FAlignedBlock
+{
+    uint8 Bytes[OBJECT_EXPORTER_CHUNK_ALIGNMENT];
+};
+
+/** A file in memory, aligned as a mapping is. Copies are patched to build the damaged variants. */
+class FTestFile
+{
+public:
+    explicit FTestFile(uint64 InSize)
+        : Blocks((InSize + sizeof(FAlignedBlock) - 1) / sizeof(FAlignedBlock), FAlignedBlock())
+        , Size(InSize)
+    {
+
+    }
+
+    uint8* GetData()
+    {
+        return Blocks.empty() ? nullptr : Blocks[0].Bytes;
+    }
+
+    const uint8* GetData() const
+    {
+        return Blocks.empty() ? nullptr : Blocks[0].Bytes;
+    }
+
+    uint64 GetSize() const
+    {
+        return Size;
+    }
+
+    FObjectExporterFileHeader& GetHeader()
+    {
+        return *reinterpret_cast<FObjectExporterFileHeader*>(GetData());
+    }
+
+    FObjectExporterChunkEntry& GetChunkEntry(uint32 ChunkId)
+    {
+        FObjectExporterChunkEntry* Chunks = reinterpret_cast<FObjectExporterChunkEntry*>(GetData() + GetHeader().ChunkTableOffset);
+        for (uint32 ChunkIndex = 0; ChunkIndex < GetHeader().ChunkCount; ChunkIndex++)
+        {
+            if (Chunks[ChunkIndex].ChunkId == ChunkId)
+            {
+                return Chunks[ChunkIndex];
+            }
+        }
+
+        std::printf("Fixture has no chunk %.4s\n", reinterpret_cast<const char*>(&ChunkId));
+        std::abort();
+    }
+
+    template <typename T>
+    T* GetChunk(uint32 ChunkId)
+    {
+        return reinterpret_cast<T*>(GetData() + GetChunkEntry(ChunkId).Offset);
+    }
+
+    void RemoveChunk(uint32 ChunkId)
+    {
+        GetChunkEntry(ChunkId).ChunkId = UnknownChunk;
+    }
+
+private:
+    std::vector<FAlignedBlock> Blocks;
+    uint64 Size;
+};
+
+/** Lays out a container the way the exporter does: header, chunk table, then the chunk payloads. */
+class FTestFileBuilder
+{
+public:
+    explicit FTestFileBuilder(uint32 InFileType)
+        : FileType(InFileType)
+    {
+
+    }
+
+    uint32 AddString(const char* String)
+    {
+        const uint32 Offset = (uint32)Strings.size();
+        Strings.insert(Strings.end(), String, String + std::strlen(String) + 1);
+
+        return Offset;
+    }
+
+    template <typename T>
+    void AddChunk(uint32 ChunkId, const std::vector<T>& Elements, uint32 Alignment = OBJECT_EXPORTER_CHUNK_ALIGNMENT)
+    {
+        AddChunkBytes(ChunkId, Elements.data(), (uint32)Elements.size(), (uint32)sizeof(T), Alignment);
+    }
+
+    template <typename T>
+    void AddSingleElementChunk(uint32 ChunkId, const T& Element)
+    {
+        AddChunkBytes(ChunkId, &Element, 1, (uint32)sizeof(T), OBJECT_EXPORTER_CHUNK_ALIGNMENT);
+    }
+
+    void AddChunkBytes(uint32 ChunkId, const void* Data, uint32 ElementCount, uint32 ElementStride, uint32 Alignment)
+    {
+        FChunk Chunk;
+        Chunk.ChunkId = ChunkId;
+        Chunk.ElementCount = ElementCount;
+        Chunk.ElementStride = ElementStride;
+        Chunk.Alignment = Alignment;
+        Chunk.Payload.assign(static_cast<const uint8*>(Data), static_cast<const uint8*>(Data) + (uint64)ElementCount * ElementStride);
+        Chunks.push_back(Chunk);
+    }
+
+    FTestFile Build() const
+    {
+        std::vector<FChunk> FileChunks = Chunks;
+        if (!Strings.empty())
+        {
+            FChunk StringChunk;
+            StringChunk.ChunkId = ObjectExporterChunk::Strings;
+            StringChunk.ElementCount = (uint32)Strings.size();
+            StringChunk.ElementStride = 1;
+            StringChunk.Alignment = OBJECT_EXPORTER_CHUNK_ALIGNMENT;
+            StringChunk.Payload.assign(Strings.begin(), Strings.end());
+            FileChunks.insert(FileChunks.begin(), StringChunk);
+        }
+
+        const uint64 ChunkTableOffset = sizeof(FObjectExporterFileHeader);
+
+        std::vector<FObjectExporterChunkEntry> Entries;
+        uint64 FileSize = ChunkTableOffset + FileChunks.size() * sizeof(FObjectExporterChunkEntry);
+        for (const FChunk& Chunk : FileChunks)
+        {
+            FObjectExporterChunkEntry Entry = {};
+            Entry.ChunkId = Chunk.ChunkId;
+            Entry.ElementCount = Chunk.ElementCount;
+            Entry.ElementStride = Chunk.ElementStride;
+            Entry.Offset = (FileSize + Chunk.Alignment - 1) / Chunk.Alignment * Chunk.Alignment;
+            Entry.Size = Chunk.Payload.size();
+            Entries.push_back(Entry);
+
+            FileSize = Entry.Offset + Entry.Size;
+        }
+
+        FTestFile File(FileSize);
+
+        FObjectExporterFileHeader& Header = File.GetHeader();
+        Header.Magic = ObjectExporterFile::Magic;
+        Header.Version = (uint16)EObjectExporterFileVersion::Latest;
+        Header.HeaderSize = sizeof(FObjectExporterFileHeader);
+        Header.FileType = FileType;
+        Header.ByteOrderMark = ObjectExporterFile::ByteOrderMark;
+        Header.ChunkCount = (uint32)Entries.size();
+        Header.ChunkTableOffset = (uint32)ChunkTableOffset;
+        Header.FileSize = FileSize;
+
+        for (uint32 ChunkIndex = 0; ChunkIndex < Entries.size(); ChunkIndex++)
+        {
+            std::memcpy(File.GetData() + ChunkTableOffset + ChunkIndex * sizeof(FObjectExporterChunkEntry), &Entries[ChunkIndex], sizeof(FObjectExporterChunkEntry));
+            if (!FileChunks[ChunkIndex].Payload.empty())
+            {
+                std::memcpy(File.GetData() + Entries[ChunkIndex].Offset, FileChunks[ChunkIndex].Payload.data(), FileChunks[ChunkIndex].Payload.size());
+            }
+        }
+
+        return File;
+    }
+
+private:
+    struct FChunk
+    {
+        uint32 ChunkId;
+        uint32 ElementCount;
+        uint32 ElementStride;
+        uint32 Alignment;
+        std::vector<uint8> Payload;
+    };
+
+    uint32 FileType;
+    std::vector<char> Strings;
+    std::vector<FChunk> Chunks;
+};
+
+template <typename ViewType>
+EReadResult OpenFile(const FTestFile& File, FContainer& Container, ViewType& View)
+{
+    const EReadResult Result = Container.Open(File.GetData(), File.GetSize());
+
+    return Result == EReadResult::Success ? View.Open(Container) : Result;
+}
+
+template <typename ViewType>
+EReadResult OpenFile(const FTestFile& File)
+{
+    FContainer Container;
+    ViewType View;
+
+    return OpenFile(File, Container, View);
+}
+
+FObjectExporterVertexAttribute MakeVertexAttribute(EObjectExporterVertexSemantic Semantic, EObjectExporterVertexElementFormat Format, uint32 Stream, uint32 Offset)
+{
+    FObjectExporterVertexAttribute Attribute = {};
+    Attribute.Semantic = (uint32)Semantic;
+    Attribute.Format = (uint32)Format;
+    Attribute.Stream = Stream;
+    Attribute.Offset = Offset;
+    for (int32 Component = 0; Component < 3; Component++)
+    {
+        Attribute.Scale[Component] = 1.0f;
+    }
+
+    return Attribute;
+}
+
+/** One triangle, one LOD, one section, shared by both mesh types. */
+void AddMeshChunks(FTestFileBuilder& Builder, uint32 FirstBone, uint32 NumBones)
+{
+    std::vector<FObjectExporterMeshVertex> Vertices(3, FObjectExporterMeshVertex());
+    Vertices[1].Position[0] = 1.0f;
+    Vertices[2].Position[1] = 1.0f;
+    Builder.AddChunk(ObjectExporterChunk::Vertices, Vertices);
+    Builder.AddChunk(ObjectExporterChunk::Indices, std::vector<uint16>{ 0, 1, 2 });
+
+    FObjectExporterMeshLOD LOD = {};
+    LOD.NumVertices = 3;
+    LOD.NumIndices = 3;
+    LOD.ScreenSize = 1.0f;
+    LOD.NumSections = 1;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::LODs, LOD);
+
+    FObjectExporterMeshSection Section = {};
+    Section.NumIndices = 3;
+    Section.MaxVertexIndex = 2;
+    Section.FirstBone = FirstBone;
+    Section.NumBones = NumBones;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Sections, Section);
+
+    Builder.AddChunk(ObjectExporterChunk::MaterialNames, std::vector<uint32>{ Builder.AddString("M_Test") });
+}
+
+std::vector<FObjectExporterVertexAttribute> MakeVertexFormat()
+{
+    return {
+        MakeVertexAttribute(EObjectExporterVertexSemantic::Position, EObjectExporterVertexElementFormat::Float3, 0, 0),
+        MakeVertexAttribute(EObjectExporterVertexSemantic::Normal, EObjectExporterVertexElementFormat::Float3, 0, 12),
+        MakeVertexAttribute(EObjectExporterVertexSemantic::TexCoord0, EObjectExporterVertexElementFormat::Float2, 0, 24),
+    };
+}
+
+FTestFile BuildStaticMesh()
+{
+    FTestFileBuilder Builder(ObjectExporterFile::StaticMesh);
+
+    FObjectExporterStaticMeshInfo Info = {};
+    Info.IndexSize = sizeof(uint16);
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Info, Info);
+
+    AddMeshChunks(Builder, 0, 0);
+    Builder.AddChunk(ObjectExporterChunk::VertexFormat, MakeVertexFormat());
+
+    FObjectExporterMeshlet Meshlet = {};
+    Meshlet.NumVertices = 3;
+    Meshlet.NumTriangles = 1;
+    Meshlet.ConeCutoff = 1.0f;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Meshlets, Meshlet);
+    Builder.AddChunk(ObjectExporterChunk::MeshletVertices, std::vector<uint32>{ 0, 1, 2 });
+    Builder.AddChunk(ObjectExporterChunk::MeshletTriangles, std::vector<FUInt8x3>{ FUInt8x3{ { 0, 1, 2 } } });
+
+    return Builder.Build();
+}
+
+/**
+*   A V shaped valley z = |x| in one meshlet. The cone of a concave cluster has to start at the bottom of the valley,
+*   behind both faces, ApexZ moves it.
+*/
+FTestFile BuildValleyStaticMesh(float ApexZ)
+{
+    FTestFileBuilder Builder(ObjectExporterFile::StaticMesh);
+
+    FObjectExporterStaticMeshInfo Info = {};
+    Info.IndexSize = sizeof(uint16);
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Info, Info);
+
+    const float Positions[4][3] = { { -1.0f, 0.0f, 1.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 1.0f } };
+    std::vector<FObjectExporterMeshVertex> Vertices(4, FObjectExporterMeshVertex());
+    for (uint32 VertexIndex = 0; VertexIndex < 4; VertexIndex++)
+    {
+        std::memcpy(Vertices[VertexIndex].Position, Positions[VertexIndex], sizeof(Positions[VertexIndex]));
+        Vertices[VertexIndex].Normal[2] = 1.0f;
+    }
+    Builder.AddChunk(ObjectExporterChunk::Vertices, Vertices);
+    Builder.AddChunk(ObjectExporterChunk::Indices, std::vector<uint16>{ 0, 1, 2, 3, 2, 1 });
+    Builder.AddChunk(ObjectExporterChunk::VertexFormat, MakeVertexFormat());
+
+    FObjectExporterMeshLOD LOD = {};
+    LOD.NumVertices = 4;
+    LOD.NumIndices = 6;
+    LOD.ScreenSize = 1.0f;
+    LOD.NumSections = 1;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::LODs, LOD);
+
+    FObjectExporterMeshSection Section = {};
+    Section.NumIndices = 6;
+    Section.MaxVertexIndex = 3;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Sections, Section);
+
+    // Both faces are 45 degrees off the axis
+    FObjectExporterMeshlet Meshlet = {};
+    Meshlet.NumVertices = 4;
+    Meshlet.NumTriangles = 2;
+    Meshlet.Center[2] = 0.5f;
+    Meshlet.Radius = std::sqrt(1.25f);
+    Meshlet.ConeApex[2] = ApexZ;
+    Meshlet.ConeAxis[2] = 1.0f;
+    Meshlet.ConeCutoff = std::sqrt(0.5f);
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Meshlets, Meshlet);
+    Builder.AddChunk(ObjectExporterChunk::MeshletVertices, std::vector<uint32>{ 0, 1, 2, 3 });
+    Builder.AddChunk(ObjectExporterChunk::MeshletTriangles, std::vector<FUInt8x3>{ FUInt8x3{ { 0, 1, 2 } }, FUInt8x3{ { 3, 2, 1 } } });
+
+    return Builder.Build();
+}
+
+FObjectExporterMatrix MakeIdentityMatrix()
+{
+    FObjectExporterMatrix Matrix = {};
+    for (int32 Row = 0; Row < 4; Row++)
+    {
+        Matrix.M[Row][Row] = 1.0f;
+    }
+
+    return Matrix;
+}
+
+FTestFile BuildSkeletalMesh()
+{
+    FTestFileBuilder Builder(ObjectExporterFile::SkeletalMesh);
+
+    FObjectExporterSkeletalMeshInfo Info = {};
+    Info.SkeletonName = Builder.AddString("SK_Test");
+    Info.IndexSize = sizeof(uint16);
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Info, Info);
+
+    AddMeshChunks(Builder, 0, 2);
+
+    std::vector<FObjectExporterVertexAttribute> VertexFormat = MakeVertexFormat();
+    VertexFormat.push_back(MakeVertexAttribute(EObjectExporterVertexSemantic::BoneIndices, EObjectExporterVertexElementFormat::UInt16x4, 1, 0));
+    VertexFormat.push_back(MakeVertexAttribute(EObjectExporterVertexSemantic::BoneWeights, EObjectExporterVertexElementFormat::Float4, 1, 8));
+    Builder.AddChunk(ObjectExporterChunk::VertexFormat, VertexFormat);
+
+    std::vector<FObjectExporterSkinWeight> SkinWeights(3, FObjectExporterSkinWeight());
+    for (FObjectExporterSkinWeight& SkinWeight : SkinWeights)
+    {
+        SkinWeight.BoneWeights[0] = 1.0f;
+    }
+    SkinWeights[2].BoneIndices[0] = 1;
+    Builder.AddChunk(ObjectExporterChunk::SkinWeights, SkinWeights);
+    Builder.AddChunk(ObjectExporterChunk::BoneMap, std::vector<uint16>{ 0, 1 });
+
+    std::vector<FObjectExporterMeshBone> MeshBones(2, FObjectExporterMeshBone());
+    MeshBones[0].Name = Builder.AddString("Root");
+    MeshBones[0].ParentIndex = INDEX_NONE;
+    MeshBones[0].SkeletonBoneIndex = 0;
+    MeshBones[0].InverseBindMatrix = MakeIdentityMatrix();
+    MeshBones[1].Name = Builder.AddString("Child");
+    MeshBones[1].ParentIndex = 0;
+    MeshBones[1].SkeletonBoneIndex = 1;
+    MeshBones[1].InverseBindMatrix = MakeIdentityMatrix();
+    Builder.AddChunk(ObjectExporterChunk::MeshBones, MeshBones);
+
+    return Builder.Build();
+}
+
+FTestFile BuildSkeleton()
+{
+    FTestFileBuilder Builder(ObjectExporterFile::Skeleton);
+
+    std::vector<FObjectExporterBone> Bones(2, FObjectExporterBone());
+    Bones[0].Name = Builder.AddString("Root");
+    Bones[0].ParentIndex = INDEX_NONE;
+    Bones[1].Name = Builder.AddString("Child");
+    Bones[1].ParentIndex = 0;
+    for (FObjectExporterBone& Bone : Bones)
+    {
+        Bone.Rotation[3] = 1.0f;
+        Bone.Scale[0] = Bone.Scale[1] = Bone.Scale[2] = 1.0f;
+    }
+    Builder.AddChunk(ObjectExporterChunk::Bones, Bones);
+    Builder.AddChunk(ObjectExporterChunk::BoneOrder, std::vector<uint32>{ 0, 1 });
+    Builder.AddChunk(ObjectExporterChunk::BindMatrices, std::vector<FObjectExporterMatrix>(2, MakeIdentityMatrix()));
+    Builder.AddChunk(ObjectExporterChunk::InverseBindMatrices, std::vector<FObjectExporterMatrix>(2, MakeIdentityMatrix()));
+
+    return Builder.Build();
+}
+
+/** Two frames of the root bone animated, the child bone in the bind pose. */
+FTestFile BuildAnimSequence()
+{
+    FTestFileBuilder Builder(ObjectExporterFile::AnimSequence);
+
+    FObjectExporterAnimSequenceInfo Info = {};
+    Info.NumFrames = 2;
+    Info.SequenceLength = 1.0f / 30.0f;
+    Info.Encoding = EObjectExporterAnimEncoding::Raw;
+    Info.SkeletonName = Builder.AddString("SK_Test");
+    Info.NumTracks = 1;
+    Info.NumBones = 2;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Info, Info);
+
+    std::vector<FObjectExporterAnimBoneTrack> BoneTracks(2, FObjectExporterAnimBoneTrack());
+    BoneTracks[0].TrackIndex = 0;
+    BoneTracks[1].TrackIndex = INDEX_NONE;
+    Builder.AddChunk(ObjectExporterChunk::BoneTracks, BoneTracks);
+
+    FObjectExporterAnimTrack Track = {};
+    Track.NumPositionKeys = 2;
+    Track.NumRotationKeys = 2;
+    Track.NumScaleKeys = 1;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Tracks, Track);
+    Builder.AddChunk(ObjectExporterChunk::PositionKeys, std::vector<FFloat3>{ FFloat3{ { 0.0f, 0.0f, 0.0f } }, FFloat3{ { 0.0f, 0.0f, 1.0f } } });
+    Builder.AddChunk(ObjectExporterChunk::RotationKeys, std::vector<FFloat4>(2, FFloat4{ { 0.0f, 0.0f, 0.0f, 1.0f } }));
+    Builder.AddChunk(ObjectExporterChunk::ScaleKeys, std::vector<FFloat3>{ FFloat3{ { 1.0f, 1.0f, 1.0f } } });
+
+    return Builder.Build();
+}
+
+FObjectExporterMaterialParameter MakeMaterialParameter(FTestFileBuilder& Builder, const char* Name, EObjectExporterMaterialParameterType Type, int32 Offset, int32 TextureSlot)
+{
+    FObjectExporterMaterialParameter Parameter = {};
+    Parameter.NameHash = ObjectExporterFile::HashName(Name);
+    Parameter.Name = Builder.AddString(Name);
+    Parameter.Type = Type;
+    Parameter.Offset = Offset;
+    Parameter.TextureSlot = TextureSlot;
+
+    return Parameter;
+}
+
+/** A vector, a scalar and a texture parameter over a 32 byte constant block. */
+FTestFile BuildMaterial()
+{
+    FTestFileBuilder Builder(ObjectExporterFile::Material);
+
+    FObjectExporterMaterialInfo Info = {};
+    Info.BaseMaterialName = Builder.AddString("M_Base");
+    Info.ConstantBlockSize = 32;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Info, Info);
+
+    Builder.AddChunk(ObjectExporterChunk::Textures, std::vector<uint32>{ Builder.AddString("T_Test") });
+
+    std::vector<FObjectExporterMaterialParameter> Parameters = {
+        MakeMaterialParameter(Builder, "BaseColor", EObjectExporterMaterialParameterType::Vector, 0, INDEX_NONE),
+        MakeMaterialParameter(Builder, "Roughness", EObjectExporterMaterialParameterType::Scalar, 16, INDEX_NONE),
+        MakeMaterialParameter(Builder, "Diffuse", EObjectExporterMaterialParameterType::Texture, INDEX_NONE, 0),
+    };
+    std::sort(Parameters.begin(), Parameters.end(), [](const FObjectExporterMaterialParameter& A, const FObjectExporterMaterialParameter& B)
+    {
+        return A.NameHash < B.NameHash;
+    });
+    Builder.AddChunk(ObjectExporterChunk::MaterialParameters, Parameters);
+
+    const float ConstantBlock[8] = { 1.0f, 0.5f, 0.25f, 1.0f, 0.75f, 0.0f, 0.0f, 0.0f };
+    Builder.AddChunkBytes(ObjectExporterChunk::ConstantBlock, ConstantBlock, sizeof(ConstantBlock), 1, OBJECT_EXPORTER_CHUNK_ALIGNMENT);
+
+    return Builder.Build();
+}
+
+FObjectExporterTextureMip MakeTextureMip(uint32 Width, uint32 Height, uint32 DataOffset)
+{
+    FObjectExporterTextureMip Mip = {};
+    Mip.Width = Width;
+    Mip.Height = Height;
+    Mip.DataOffset = DataOffset;
+    Mip.DataSize = Width * Height * 4;
+
+    return Mip;
+}
+
+/** 4x4 RGBA8 with the largest mip streamed and the two smaller ones resident. */
+FTestFile BuildTexture()
+{
+    FTestFileBuilder Builder(ObjectExporterFile::Texture);
+
+    FObjectExporterTextureInfo Info = {};
+    Info.Format = EObjectExporterTextureFormat::RGBA8;
+    Info.Width = 4;
+    Info.Height = 4;
+    Info.NumMips = 3;
+    Info.BlockSizeX = 1;
+    Info.BlockSizeY = 1;
+    Info.BytesPerBlock = 4;
+    Info.FirstResidentMip = 1;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Info, Info);
+
+    Builder.AddChunk(ObjectExporterChunk::TextureMips, std::vector<FObjectExporterTextureMip>{ MakeTextureMip(4, 4, 0), MakeTextureMip(2, 2, 0), MakeTextureMip(1, 1, 16) });
+    Builder.AddChunk(ObjectExporterChunk::TextureData, std::vector<uint8>(32, 0x80));
+    Builder.AddChunk(ObjectExporterChunk::StreamedTextureData, std::vector<uint8>(64, 0xFF), OBJECT_EXPORTER_TEXTURE_STREAMING_ALIGNMENT);
+
+    return Builder.Build();
+}
+
+FObjectExporterBounds MakeBounds(float X, float Y)
+{
+    FObjectExporterBounds Bounds = {};
+    Bounds.Origin[0] = X;
+    Bounds.Origin[1] = Y;
+    Bounds.SphereRadius = 1.0f;
+    Bounds.BoxExtent[0] = Bounds.BoxExtent[1] = Bounds.BoxExtent[2] = 0.5f;
+
+    return Bounds;
+}
+
+FObjectExporterBVHPrimitive MakeBVHPrimitive(EObjectExporterPrimitiveType Type, uint32 Index)
+{
+    FObjectExporterBVHPrimitive Primitive = {};
+    Primitive.Type = (uint32)Type;
+    Primitive.Index = Index;
+
+    return Primitive;
+}
+
+/** A root node with one leaf over the first NumPrimitives primitives, the other slots empty. */
+FObjectExporterBVHNode MakeBVHLeafRoot(uint32 NumPrimitives)
+{
+    FObjectExporterBVHNode Node = {};
+    for (int32 Child = 0; Child < 4; Child++)
+    {
+        Node.Children[Child] = INDEX_NONE;
+    }
+    Node.Children[0] = 0;
+    Node.Counts[0] = NumPrimitives;
+
+    return Node;
+}
+
+/** NumInstances instances of one static mesh, with their bounds and material. */
+void AddInstanceChunks(FTestFileBuilder& Builder, uint32 NumInstances)
+{
+    FObjectExporterInstanceBatch Batch = {};
+    Batch.ResourceName = Builder.AddString("SM_Test");
+    Batch.NumMaterials = 1;
+    Batch.NumInstances = NumInstances;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::InstanceBatches, Batch);
+
+    std::vector<FObjectExporterBounds> Bounds;
+    for (uint32 Instance = 0; Instance < NumInstances; Instance++)
+    {
+        Bounds.push_back(MakeBounds(150.0f + Instance, 50.0f));
+    }
+    Builder.AddChunk(ObjectExporterChunk::InstanceTranslations, std::vector<FFloat3>(NumInstances, FFloat3{ { 150.0f, 50.0f, 0.0f } }));
+    Builder.AddChunk(ObjectExporterChunk::InstanceRotations, std::vector<FFloat4>(NumInstances, FFloat4{ { 0.0f, 0.0f, 0.0f, 1.0f } }));
+    Builder.AddChunk(ObjectExporterChunk::InstanceScales, std::vector<FFloat3>(NumInstances, FFloat3{ { 1.0f, 1.0f, 1.0f } }));
+    Builder.AddChunk(ObjectExporterChunk::InstanceBounds, Bounds);
+}
+
+/** Cameras, lights and materials a map always keeps, partitioned or not. */
+void AddMapChunks(FTestFileBuilder& Builder)
+{
+    FObjectExporterCamera Camera = {};
+    Camera.Target[0] = 1.0f;
+    Camera.FOV = 90.0f;
+    Camera.AspectRatio = 16.0f / 9.0f;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::Cameras, Camera);
+
+    FObjectExporterDirectionalLight DirectionalLight = {};
+    DirectionalLight.Direction[2] = -1.0f;
+    DirectionalLight.Intensity = 1.0f;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::DirectionalLights, DirectionalLight);
+
+    FObjectExporterMapMaterial Material = {};
+    Material.Name = Builder.AddString("M_Test");
+    Material.NumTextures = 1;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::MapMaterials, Material);
+
+    FObjectExporterMaterialTexture Texture = {};
+    Texture.Name = Builder.AddString("T_Test");
+    Texture.SamplingScale = 1.0f;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::MaterialTextures, Texture);
+}
+
+/** Two instances, a skeletal mesh actor and a point light under one BVH leaf. */
+FTestFile BuildMap()
+{
+    FTestFileBuilder Builder(ObjectExporterFile::Map);
+
+    AddMapChunks(Builder);
+    AddInstanceChunks(Builder, 2);
+
+    FObjectExporterPointLight PointLight = {};
+    PointLight.Intensity = 1.0f;
+    PointLight.AttenuationRadius = 1.0f;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::PointLights, PointLight);
+    Builder.AddSingleElementChunk(ObjectExporterChunk::PointLightBounds, MakeBounds(0.0f, 0.0f));
+
+    FObjectExporterSkeletalMeshActor Actor = {};
+    Actor.Rotation[3] = 1.0f;
+    Actor.ResourceName = Builder.AddString("SKM_Test");
+    Actor.AnimationName = OBJECT_EXPORTER_INVALID_STRING;
+    Actor.FirstMaterial = 1;
+    Actor.NumMaterials = 1;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::SkeletalMeshActors, Actor);
+    Builder.AddSingleElementChunk(ObjectExporterChunk::SkeletalMeshActorBounds, MakeBounds(0.0f, 0.0f));
+
+    Builder.AddChunk(ObjectExporterChunk::MaterialNames, std::vector<uint32>{ Builder.AddString("M_Test"), Builder.AddString("M_Skin") });
+
+    Builder.AddSingleElementChunk(ObjectExporterChunk::BVHNodes, MakeBVHLeafRoot(4));
+    Builder.AddChunk(ObjectExporterChunk::BVHPrimitives, std::vector<FObjectExporterBVHPrimitive>{
+        MakeBVHPrimitive(EObjectExporterPrimitiveType::Instance, 0),
+        MakeBVHPrimitive(EObjectExporterPrimitiveType::Instance, 1),
+        MakeBVHPrimitive(EObjectExporterPrimitiveType::SkeletalMeshActor, 0),
+        MakeBVHPrimitive(EObjectExporterPrimitiveType::PointLight, 0),
+    });
+
+    return Builder.Build();
+}
+
+/** The records of grid cell (1, 0) of the partitioned map: one instance and the assets it needs. */
+FTestFile BuildMapCell()
+{
+    FTestFileBuilder Builder(ObjectExporterFile::MapCell);
+
+    AddInstanceChunks(Builder, 1);
+    Builder.AddChunk(ObjectExporterChunk::MaterialNames, std::vector<uint32>{ Builder.AddString("M_Test") });
+    Builder.AddSingleElementChunk(ObjectExporterChunk::BVHNodes, MakeBVHLeafRoot(1));
+    Builder.AddSingleElementChunk(ObjectExporterChunk::BVHPrimitives, MakeBVHPrimitive(EObjectExporterPrimitiveType::Instance, 0));
+
+    FObjectExporterAssetDependency StaticMesh = {};
+    StaticMesh.FileType = ObjectExporterFile::StaticMesh;
+    StaticMesh.Name = Builder.AddString("SM_Test");
+    FObjectExporterAssetDependency Material = {};
+    Material.FileType = ObjectExporterFile::Material;
+    Material.Name = Builder.AddString("M_Test");
+    Builder.AddChunk(ObjectExporterChunk::AssetDependencies, std::vector<FObjectExporterAssetDependency>{ StaticMesh, Material });
+
+    return Builder.Build();
+}
+
+/** A 2x1 grid of 100 unit cells with BuildMapCell in cell (1, 0). */
+FTestFile BuildPartitionedMap()
+{
+    FTestFileBuilder Builder(ObjectExporterFile::Map);
+
+    AddMapChunks(Builder);
+
+    FObjectExporterMapGrid Grid = {};
+    Grid.CellSize = 100.0f;
+    Grid.NumCellsX = 2;
+    Grid.NumCellsY = 1;
+    Builder.AddSingleElementChunk(ObjectExporterChunk::MapGrid, Grid);
+
+    const FTestFile CellFile = BuildMapCell();
+
+    FObjectExporterMapCell Cell = {};
+    Cell.CellX = 1;
+    Cell.NumPrimitives = 1;
+    Cell.DataSize = CellFile.GetSize();
+    Cell.Bounds = MakeBounds(150.0f, 50.0f);
+    Builder.AddSingleElementChunk(ObjectExporterChunk::MapCells, Cell);
+    Builder.AddChunkBytes(ObjectExporterChunk::MapCellData, CellFile.GetData(), (uint32)CellFile.GetSize(), 1, OBJECT_EXPORTER_MAP_CELL_ALIGNMENT);
+
+    return Builder.Build();
+}
+
+void TestContainer()
+{
+    const FTestFile File = BuildStaticMesh();
+
+    FContainer Container;
+    CHECK_RESULT(Container.Open(File.GetData(), File.GetSize()), EReadResult::Success);
+    CHECK(Container.GetFileType() == ObjectExporterFile::StaticMesh);
+    CHECK(Container.GetVersion() == (uint16)EObjectExporterFileVersion::Latest);
+    CHECK(std::strcmp(Container.GetString(0), "M_Test") == 0);
+    CHECK(std::strcmp(Container.GetString(1000), "") == 0);
+
+    // Cut short inside the header, inside the chunk table and inside the last chunk
+    CHECK_RESULT(Container.Open(File.GetData(), sizeof(FObjectExporterFileHeader) - 1), EReadResult::Truncated);
+    CHECK_RESULT(Container.Open(File.GetData(), sizeof(FObjectExporterFileHeader) + sizeof(FObjectExporterChunkEntry)), EReadResult::Truncated);
+    CHECK_RESULT(Container.Open(File.GetData(), File.GetSize() - 1), EReadResult::Truncated);
+    CHECK_RESULT(Container.Open(nullptr, File.GetSize()), EReadResult::Truncated);
+
+    FTestFile Corrupt = File;
+    Corrupt.GetHeader().ChunkCount = 1000;
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::Truncated);
+
+    Corrupt = File;
+    Corrupt.GetHeader().Magic = ObjectExporterFourCC('O', 'E', 'X', 'Q');
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::BadMagic);
+
+    Corrupt = File;
+    Corrupt.GetHeader().ByteOrderMark = 0x04030201;
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::ByteSwapped);
+
+    Corrupt = File;
+    Corrupt.GetHeader().ByteOrderMark = 0;
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::BadHeader);
+
+    Corrupt = File;
+    Corrupt.GetHeader().HeaderSize = sizeof(FObjectExporterFileHeader) / 2;
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::BadHeader);
+
+    Corrupt = File;
+    Corrupt.GetHeader().ChunkTableOffset += 4;
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::BadHeader);
+
+    Corrupt = File;
+    Corrupt.GetHeader().Version = 0;
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::UnsupportedVersion);
+
+    Corrupt = File;
+    Corrupt.GetHeader().Version = (uint16)EObjectExporterFileVersion::VersionPlusOne;
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::UnsupportedVersion);
+
+    Corrupt = File;
+    Corrupt.GetChunkEntry(ObjectExporterChunk::Vertices).Offset += 4;
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunkEntry(ObjectExporterChunk::Vertices).Offset = File.GetSize() + OBJECT_EXPORTER_CHUNK_ALIGNMENT;
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunkEntry(ObjectExporterChunk::Indices).Size = File.GetSize();
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunkEntry(ObjectExporterChunk::Vertices).ElementCount = 2;
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::BadChunk);
+
+    Corrupt = File;
+    const FObjectExporterChunkEntry& StringChunk = Corrupt.GetChunkEntry(ObjectExporterChunk::Strings);
+    Corrupt.GetData()[StringChunk.Offset + StringChunk.Size - 1] = 'x';
+    CHECK_RESULT(Container.Open(Corrupt.GetData(), Corrupt.GetSize()), EReadResult::BadString);
+    CHECK(Container.GetChunks().IsEmpty());
+
+    // Typed views only read the latest version of their own file type
+    FStaticMeshView StaticMesh;
+    Corrupt = File;
+    Corrupt.GetHeader().Version = (uint16)EObjectExporterFileVersion::Latest - 1;
+    CHECK_RESULT(OpenFile(Corrupt, Container, StaticMesh), EReadResult::UnsupportedVersion);
+    CHECK_RESULT(OpenFile<FSkeletalMeshView>(File), EReadResult::WrongFileType);
+    CHECK_RESULT(OpenFile<FSkeletonView>(File), EReadResult::WrongFileType);
+    CHECK_RESULT(OpenFile<FAnimSequenceView>(File), EReadResult::WrongFileType);
+    CHECK_RESULT(OpenFile<FMaterialView>(File), EReadResult::WrongFileType);
+    CHECK_RESULT(OpenFile<FTextureView>(File), EReadResult::WrongFileType);
+    CHECK_RESULT(OpenFile<FMapView>(File), EReadResult::WrongFileType);
+}
+
+void TestStaticMesh()
+{
+    const FTestFile File = BuildStaticMesh();
+
+    FContainer Container;
+    FStaticMeshView StaticMesh;
+    CHECK_RESULT(OpenFile(File, Container, StaticMesh), EReadResult::Success);
+    CHECK(StaticMesh.NumVertices == 3 && StaticMesh.VertexStride == sizeof(FObjectExporterMeshVertex));
+    CHECK(StaticMesh.NumIndices == 3 && StaticMesh.IndexSize == sizeof(uint16) && StaticMesh.GetIndex(2) == 2);
+    CHECK(StaticMesh.LODs.GetNum() == 1 && StaticMesh.Sections.GetNum() == 1 && StaticMesh.Meshlets.GetNum() == 1);
+    CHECK(std::strcmp(Container.GetString(StaticMesh.MaterialNames[0]), "M_Test") == 0);
+    CHECK(StaticMesh.ValidateIndices());
+
+    FTestFile Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::Info);
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::MissingChunk);
+
+    Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::Vertices);
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::MissingChunk);
+
+    Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::Indices);
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::MissingChunk);
+
+    // INDX holds 16 bit indices
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterStaticMeshInfo>(ObjectExporterChunk::Info)->IndexSize = sizeof(uint32);
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterVertexAttribute>(ObjectExporterChunk::VertexFormat)[2].Offset = sizeof(FObjectExporterMeshVertex) - 4;
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMeshLOD>(ObjectExporterChunk::LODs)->NumIndices = 6;
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMeshLOD>(ObjectExporterChunk::LODs)->FirstVertex = 1;
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMeshLOD>(ObjectExporterChunk::LODs)->NumSections = 2;
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMeshSection>(ObjectExporterChunk::Sections)->MaxVertexIndex = 3;
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMeshSection>(ObjectExporterChunk::Sections)->MaterialIndex = 1;
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    *Corrupt.GetChunk<uint32>(ObjectExporterChunk::MaterialNames) = 1000;
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::BadString);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FUInt8x3>(ObjectExporterChunk::MeshletTriangles)->V[2] = 3;
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<uint32>(ObjectExporterChunk::MeshletVertices)[1] = 3;
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMeshlet>(ObjectExporterChunk::Meshlets)->SectionIndex = 1;
+    CHECK_RESULT(OpenFile<FStaticMeshView>(Corrupt), EReadResult::BadReference);
+
+    // The meshlet has no cone to check
+    CHECK(StaticMesh.ValidateMeshletCones());
+
+    // Open leaves the index values to ValidateIndices
+    Corrupt = File;
+    Corrupt.GetChunk<uint16>(ObjectExporterChunk::Indices)[2] = 3;
+    CHECK_RESULT(OpenFile(Corrupt, Container, StaticMesh), EReadResult::Success);
+    CHECK(!StaticMesh.ValidateIndices());
+}
+
+void TestMeshletCones()
+{
+    FContainer Container;
+    FStaticMeshView StaticMesh;
+
+    // Apex at the bottom of the valley, on both triangle planes
+    FTestFile File = BuildValleyStaticMesh(0.0f);
+    CHECK_RESULT(OpenFile(File, Container, StaticMesh), EReadResult::Success);
+    CHECK(StaticMesh.ValidateMeshletCones());
+
+    // Further back is safe, only culls less
+    File = BuildValleyStaticMesh(-1.0f);
+    CHECK_RESULT(OpenFile(File, Container, StaticMesh), EReadResult::Success);
+    CHECK(StaticMesh.ValidateMeshletCones());
+
+    // Apex at the box center, in front of both faces: a camera at (0, 0, 0.2) sees them and would cull the meshlet
+    File = BuildValleyStaticMesh(0.5f);
+    CHECK_RESULT(OpenFile(File, Container, StaticMesh), EReadResult::Success);
+    CHECK(!StaticMesh.ValidateMeshletCones());
+
+    // The winding of the source mesh does not matter
+    FTestFile Flipped = BuildValleyStaticMesh(0.0f);
+    std::swap(Flipped.GetChunk<FUInt8x3>(ObjectExporterChunk::MeshletTriangles)[0].V[1], Flipped.GetChunk<FUInt8x3>(ObjectExporterChunk::MeshletTriangles)[0].V[2]);
+    CHECK_RESULT(OpenFile(Flipped, Container, StaticMesh), EReadResult::Success);
+    CHECK(StaticMesh.ValidateMeshletCones());
+}
+
+void TestSkeletalMesh()
+{
+    const FTestFile File = BuildSkeletalMesh();
+
+    FContainer Container;
+    FSkeletalMeshView SkeletalMesh;
+    CHECK_RESULT(OpenFile(File, Container, SkeletalMesh), EReadResult::Success);
+    CHECK(std::strcmp(Container.GetString(SkeletalMesh.Info->SkeletonName), "SK_Test") == 0);
+    CHECK(SkeletalMesh.SkinWeightStride == sizeof(FObjectExporterSkinWeight) && SkeletalMesh.SkinWeights.GetNum() == 3 * sizeof(FObjectExporterSkinWeight));
+    CHECK(SkeletalMesh.BoneMap.GetNum() == 2 && SkeletalMesh.MeshBones.GetNum() == 2);
+    CHECK(SkeletalMesh.ValidateIndices());
+
+    FTestFile Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::Info);
+    CHECK_RESULT(OpenFile<FSkeletalMeshView>(Corrupt), EReadResult::MissingChunk);
+
+    Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::SkinWeights);
+    CHECK_RESULT(OpenFile<FSkeletalMeshView>(Corrupt), EReadResult::MissingChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterSkeletalMeshInfo>(ObjectExporterChunk::Info)->SkeletonName = 1000;
+    CHECK_RESULT(OpenFile<FSkeletalMeshView>(Corrupt), EReadResult::BadString);
+
+    // SKIN has one weight per vertex
+    Corrupt = File;
+    FObjectExporterChunkEntry& SkinWeightChunk = Corrupt.GetChunkEntry(ObjectExporterChunk::SkinWeights);
+    SkinWeightChunk.ElementCount = 2;
+    SkinWeightChunk.Size = 2 * sizeof(FObjectExporterSkinWeight);
+    CHECK_RESULT(OpenFile<FSkeletalMeshView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterVertexAttribute>(ObjectExporterChunk::VertexFormat)[4].Offset = 12;
+    CHECK_RESULT(OpenFile<FSkeletalMeshView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMeshSection>(ObjectExporterChunk::Sections)->NumBones = 3;
+    CHECK_RESULT(OpenFile<FSkeletalMeshView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<uint16>(ObjectExporterChunk::BoneMap)[1] = 2;
+    CHECK_RESULT(OpenFile<FSkeletalMeshView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMeshBone>(ObjectExporterChunk::MeshBones)[1].Name = 1000;
+    CHECK_RESULT(OpenFile<FSkeletalMeshView>(Corrupt), EReadResult::BadString);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMeshBone>(ObjectExporterChunk::MeshBones)[1].ParentIndex = 1;
+    CHECK_RESULT(OpenFile<FSkeletalMeshView>(Corrupt), EReadResult::BadHierarchy);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMeshBone>(ObjectExporterChunk::MeshBones)[0].ParentIndex = 1;
+    CHECK_RESULT(OpenFile<FSkeletalMeshView>(Corrupt), EReadResult::BadHierarchy);
+}
+
+void TestSkeleton()
+{
+    const FTestFile File = BuildSkeleton();
+
+    FContainer Container;
+    FSkeletonView Skeleton;
+    CHECK_RESULT(OpenFile(File, Container, Skeleton), EReadResult::Success);
+    CHECK(Skeleton.Bones.GetNum() == 2 && Skeleton.BoneOrder.GetNum() == 2);
+    CHECK(std::strcmp(Container.GetString(Skeleton.Bones[1].Name), "Child") == 0);
+
+    FTestFile Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::Bones);
+    CHECK_RESULT(OpenFile<FSkeletonView>(Corrupt), EReadResult::MissingChunk);
+
+    // BORD, BMAT and BINV have one entry per bone
+    Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::BindMatrices);
+    CHECK_RESULT(OpenFile<FSkeletonView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    FObjectExporterChunkEntry& BoneOrderChunk = Corrupt.GetChunkEntry(ObjectExporterChunk::BoneOrder);
+    BoneOrderChunk.ElementCount = 1;
+    BoneOrderChunk.Size = sizeof(uint32);
+    CHECK_RESULT(OpenFile<FSkeletonView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterBone>(ObjectExporterChunk::Bones)[0].Name = 1000;
+    CHECK_RESULT(OpenFile<FSkeletonView>(Corrupt), EReadResult::BadString);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterBone>(ObjectExporterChunk::Bones)[1].ParentIndex = 2;
+    CHECK_RESULT(OpenFile<FSkeletonView>(Corrupt), EReadResult::BadHierarchy);
+
+    Corrupt = File;
+    Corrupt.GetChunk<uint32>(ObjectExporterChunk::BoneOrder)[1] = 2;
+    CHECK_RESULT(OpenFile<FSkeletonView>(Corrupt), EReadResult::BadReference);
+}
+
+void TestAnimSequence()
+{
+    const FTestFile File = BuildAnimSequence();
+
+    FContainer Container;
+    FAnimSequenceView AnimSequence;
+    CHECK_RESULT(OpenFile(File, Container, AnimSequence), EReadResult::Success);
+    CHECK(AnimSequence.Info->Encoding == EObjectExporterAnimEncoding::Raw && AnimSequence.Info->NumFrames == 2);
+    CHECK(AnimSequence.BoneTracks.GetNum() == 2 && AnimSequence.Tracks.GetNum() == 1);
+    CHECK(AnimSequence.PositionKeys.GetNum() == 2 && AnimSequence.RotationKeys.GetNum() == 2 && AnimSequence.ScaleKeys.GetNum() == 1);
+
+    FTestFile Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::Info);
+    CHECK_RESULT(OpenFile<FAnimSequenceView>(Corrupt), EReadResult::MissingChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterAnimSequenceInfo>(ObjectExporterChunk::Info)->NumFrames = -1;
+    CHECK_RESULT(OpenFile<FAnimSequenceView>(Corrupt), EReadResult::BadHeader);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterAnimSequenceInfo>(ObjectExporterChunk::Info)->Encoding = (EObjectExporterAnimEncoding)7;
+    CHECK_RESULT(OpenFile<FAnimSequenceView>(Corrupt), EReadResult::BadHeader);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterAnimSequenceInfo>(ObjectExporterChunk::Info)->NumBones = 3;
+    CHECK_RESULT(OpenFile<FAnimSequenceView>(Corrupt), EReadResult::BadChunk);
+
+    // The encoding names the chunks the keys are in
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterAnimSequenceInfo>(ObjectExporterChunk::Info)->Encoding = EObjectExporterAnimEncoding::Compressed;
+    CHECK_RESULT(OpenFile<FAnimSequenceView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterAnimSequenceInfo>(ObjectExporterChunk::Info)->Encoding = EObjectExporterAnimEncoding::FrameMajor;
+    CHECK_RESULT(OpenFile<FAnimSequenceView>(Corrupt), EReadResult::MissingChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterAnimBoneTrack>(ObjectExporterChunk::BoneTracks)[1].TrackIndex = 1;
+    CHECK_RESULT(OpenFile<FAnimSequenceView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterAnimTrack>(ObjectExporterChunk::Tracks)->NumRotationKeys = 3;
+    CHECK_RESULT(OpenFile<FAnimSequenceView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterAnimTrack>(ObjectExporterChunk::Tracks)->FirstScaleKey = 1;
+    CHECK_RESULT(OpenFile<FAnimSequenceView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterAnimTrack>(ObjectExporterChunk::Tracks)->BoneIndex = 2;
+    CHECK_RESULT(OpenFile<FAnimSequenceView>(Corrupt), EReadResult::BadReference);
+}
+
+void TestMaterial()
+{
+    const FTestFile File = BuildMaterial();
+
+    FContainer Container;
+    FMaterialView Material;
+    CHECK_RESULT(OpenFile(File, Container, Material), EReadResult::Success);
+    CHECK(std::strcmp(Container.GetString(Material.Info->BaseMaterialName), "M_Base") == 0);
+    CHECK(Material.Parameters.GetNum() == 3 && Material.ConstantBlock.GetNum() == 32);
+
+    const FObjectExporterMaterialParameter* Roughness = Material.FindParameter("Roughness");
+    CHECK(Roughness != nullptr && Roughness->Type == EObjectExporterMaterialParameterType::Scalar && Roughness->Offset == 16);
+    const FObjectExporterMaterialParameter* Diffuse = Material.FindParameter("Diffuse");
+    CHECK(Diffuse != nullptr && std::strcmp(Container.GetString(Material.Textures[(uint32)Diffuse->TextureSlot]), "T_Test") == 0);
+    CHECK(Material.FindParameter("Metallic") == nullptr);
+
+    FTestFile Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::Info);
+    CHECK_RESULT(OpenFile<FMaterialView>(Corrupt), EReadResult::MissingChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMaterialInfo>(ObjectExporterChunk::Info)->ConstantBlockSize = 16;
+    CHECK_RESULT(OpenFile<FMaterialView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMaterialInfo>(ObjectExporterChunk::Info)->BaseMaterialName = 1000;
+    CHECK_RESULT(OpenFile<FMaterialView>(Corrupt), EReadResult::BadString);
+
+    Corrupt = File;
+    *Corrupt.GetChunk<uint32>(ObjectExporterChunk::Textures) = 1000;
+    CHECK_RESULT(OpenFile<FMaterialView>(Corrupt), EReadResult::BadString);
+
+    // FindParameter needs PARM sorted by hash
+    Corrupt = File;
+    std::swap(Corrupt.GetChunk<FObjectExporterMaterialParameter>(ObjectExporterChunk::MaterialParameters)[0],
+        Corrupt.GetChunk<FObjectExporterMaterialParameter>(ObjectExporterChunk::MaterialParameters)[2]);
+    CHECK_RESULT(OpenFile<FMaterialView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    FObjectExporterMaterialParameter* Parameters = Corrupt.GetChunk<FObjectExporterMaterialParameter>(ObjectExporterChunk::MaterialParameters);
+    for (uint32 ParameterIndex = 0; ParameterIndex < 3; ParameterIndex++)
+    {
+        if (Parameters[ParameterIndex].Type == EObjectExporterMaterialParameterType::Vector)
+        {
+            Parameters[ParameterIndex].Offset = 4;
+        }
+    }
+    CHECK_RESULT(OpenFile<FMaterialView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Parameters = Corrupt.GetChunk<FObjectExporterMaterialParameter>(ObjectExporterChunk::MaterialParameters);
+    for (uint32 ParameterIndex = 0; ParameterIndex < 3; ParameterIndex++)
+    {
+        if (Parameters[ParameterIndex].Type == EObjectExporterMaterialParameterType::Texture)
+        {
+            Parameters[ParameterIndex].TextureSlot = 1;
+        }
+    }
+    CHECK_RESULT(OpenFile<FMaterialView>(Corrupt), EReadResult::BadReference);
+}
+
+void TestTexture()
+{
+    const FTestFile File = BuildTexture();
+
+    FContainer Container;
+    FTextureView Texture;
+    CHECK_RESULT(OpenFile(File, Container, Texture), EReadResult::Success);
+    CHECK(Texture.Mips.GetNum() == 3 && Texture.ResidentData.GetNum() == 32 && Texture.StreamedData.GetNum() == 64);
+    CHECK(Texture.GetMipData(0) == Texture.StreamedData.GetData() && Texture.GetMipData(2) == Texture.ResidentData.GetData() + 16);
+    CHECK(Container.FindChunk(ObjectExporterChunk::StreamedTextureData)->Offset % OBJECT_EXPORTER_TEXTURE_STREAMING_ALIGNMENT == 0);
+
+    FTestFile Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::Info);
+    CHECK_RESULT(OpenFile<FTextureView>(Corrupt), EReadResult::MissingChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterTextureInfo>(ObjectExporterChunk::Info)->NumMips = 4;
+    CHECK_RESULT(OpenFile<FTextureView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunkEntry(ObjectExporterChunk::StreamedTextureData).Offset -= OBJECT_EXPORTER_CHUNK_ALIGNMENT;
+    CHECK_RESULT(OpenFile<FTextureView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterTextureMip>(ObjectExporterChunk::TextureMips)[2].DataSize = 32;
+    CHECK_RESULT(OpenFile<FTextureView>(Corrupt), EReadResult::BadReference);
+
+    // Without TSTM the streamed mips have nothing to point into
+    Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::StreamedTextureData);
+    CHECK_RESULT(OpenFile<FTextureView>(Corrupt), EReadResult::BadReference);
+}
+
+void TestMap()
+{
+    const FTestFile File = BuildMap();
+
+    FContainer Container;
+    FMapView Map;
+    CHECK_RESULT(OpenFile(File, Container, Map), EReadResult::Success);
+    CHECK(Map.InstanceBatches.GetNum() == 1 && Map.InstanceTranslations.GetNum() == 2 && Map.SkeletalMeshActors.GetNum() == 1);
+    CHECK(Map.BVHNodes.GetNum() == 1 && Map.BVHPrimitives.GetNum() == 4);
+    CHECK(Map.Grid == nullptr && Map.Cells.IsEmpty());
+
+    FTestFile Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::InstanceRotations);
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::SkeletalMeshActors);
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterInstanceBatch>(ObjectExporterChunk::InstanceBatches)->NumInstances = 3;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterInstanceBatch>(ObjectExporterChunk::InstanceBatches)->ResourceName = 1000;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadString);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterSkeletalMeshActor>(ObjectExporterChunk::SkeletalMeshActors)->FirstMaterial = 2;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterSkeletalMeshActor>(ObjectExporterChunk::SkeletalMeshActors)->AnimationName = 1000;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadString);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMapMaterial>(ObjectExporterChunk::MapMaterials)->NumTextures = 2;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterBVHPrimitive>(ObjectExporterChunk::BVHPrimitives)[3].Index = 1;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterBVHNode>(ObjectExporterChunk::BVHNodes)->Counts[0] = 5;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadReference);
+
+    // A node can only point at nodes after it
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterBVHNode>(ObjectExporterChunk::BVHNodes)->Children[1] = 0;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadReference);
+}
+
+void TestPartitionedMap()
+{
+    const FTestFile File = BuildPartitionedMap();
+
+    FContainer Container;
+    FMapView Map;
+    CHECK_RESULT(OpenFile(File, Container, Map), EReadResult::Success);
+    CHECK(Map.Grid != nullptr && Map.Cells.GetNum() == 1 && Map.InstanceTranslations.IsEmpty());
+    CHECK(Container.FindChunk(ObjectExporterChunk::MapCellData)->Offset % OBJECT_EXPORTER_MAP_CELL_ALIGNMENT == 0);
+
+    const TView<uint8> CellData = Map.GetCellData(0);
+    FContainer CellContainer;
+    FMapView Cell;
+    CHECK_RESULT(CellContainer.Open(CellData.GetData(), CellData.GetNum()), EReadResult::Success);
+    CHECK(CellContainer.GetFileType() == ObjectExporterFile::MapCell);
+    CHECK_RESULT(Cell.Open(CellContainer), EReadResult::Success);
+    CHECK(Cell.InstanceTranslations.GetNum() == 1 && Cell.Dependencies.GetNum() == 2);
+    CHECK(Cell.Dependencies[0].FileType == ObjectExporterFile::StaticMesh && std::strcmp(CellContainer.GetString(Cell.Dependencies[0].Name), "SM_Test") == 0);
+
+    // A cell cut short by the map's CELL entry
+    CHECK_RESULT(CellContainer.Open(CellData.GetData(), CellData.GetNum() - OBJECT_EXPORTER_CHUNK_ALIGNMENT), EReadResult::Truncated);
+
+    FTestFile Corrupt = File;
+    Corrupt.RemoveChunk(ObjectExporterChunk::MapGrid);
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::MissingChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMapGrid>(ObjectExporterChunk::MapGrid)->CellSize = 0.0f;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunkEntry(ObjectExporterChunk::MapCellData).Offset -= OBJECT_EXPORTER_CHUNK_ALIGNMENT;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMapCell>(ObjectExporterChunk::MapCells)->CellX = 2;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMapCell>(ObjectExporterChunk::MapCells)->DataOffset = OBJECT_EXPORTER_CHUNK_ALIGNMENT;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadReference);
+
+    Corrupt = File;
+    Corrupt.GetChunk<FObjectExporterMapCell>(ObjectExporterChunk::MapCells)->DataSize += 1;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadReference);
+
+    // Only cells list dependencies, only maps have a grid
+    FTestFile CellFile = BuildMapCell();
+    CHECK_RESULT(OpenFile<FMapView>(CellFile), EReadResult::Success);
+
+    Corrupt = CellFile;
+    Corrupt.GetHeader().FileType = ObjectExporterFile::Map;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = File;
+    Corrupt.GetHeader().FileType = ObjectExporterFile::MapCell;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadChunk);
+
+    Corrupt = CellFile;
+    Corrupt.GetChunk<FObjectExporterAssetDependency>(ObjectExporterChunk::AssetDependencies)[1].Name = 1000;
+    CHECK_RESULT(OpenFile<FMapView>(Corrupt), EReadResult::BadString);
+}
+
+} // namespace
+
+int main()
+{
+    TestContainer();
+    TestStaticMesh();
+    TestMeshletCones();
+    TestSkeletalMesh();
+    TestSkeleton();
+    TestAnimSequence();
+    TestMaterial();
+    TestTexture();
+    TestMap();
+    TestPartitionedMap();
+
+    std::printf("%d of %d checks failed.\n", NumFailures, NumChecks);
+
+    return NumFailures;
+}